@@ -0,0 +1,225 @@
+// Batch push / bulk pop benchmark.
+//
+// Compares a heap_push loop against heap_push_range and its two internal
+// paths (sift-up per element, full rebuild) for several heap / batch sizes
+// on random and ascending batches, a heap_pop loop against heap_pop_n, and
+// sliding top-N maintenance with heap_pop + heap_push against
+// heap_replace_top, and melding two heaps by concatenate + heapify against
+// heap_merge.
+// Timings include copying the base heap.
+//
+// Build with -DHEAP_UTILS_BUILD_BENCHMARKS=ON and run in Release mode.
+
+#include <heap_utils/heap_utils.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+#include <random>
+#include <vector>
+
+namespace
+{
+  volatile std::uint64_t sink = 0;
+
+  template <class F>
+  double best_ms(F &&run)
+  {
+    double best = 1e300;
+    for (int rep = 0; rep < 5; ++rep)
+    {
+      const auto t0 = std::chrono::steady_clock::now();
+      run();
+      const auto t1 = std::chrono::steady_clock::now();
+      const double ms = std::chrono::duration<double, std::milli>(t1 - t0).count();
+      best = (ms < best) ? ms : best;
+    }
+    return best;
+  }
+
+  void bench_push(std::size_t heap_size, std::size_t batch, bool ascending)
+  {
+    std::mt19937_64 rng(1);
+    std::vector<std::uint64_t> base(heap_size);
+    for (auto &x : base)
+    {
+      x = rng();
+    }
+    heap_utils::heapify(base.begin(), base.end());
+    std::vector<std::uint64_t> items(batch);
+    for (auto &x : items)
+    {
+      x = rng();
+    }
+    if (ascending)
+    {
+      std::sort(items.begin(), items.end());
+    }
+
+    std::vector<std::uint64_t> h;
+    const double loop = best_ms([&]
+                                {
+      h = base;
+      for (std::uint64_t x : items)
+        heap_utils::heap_push(h, x);
+      sink = sink + h.front(); });
+    const double sift = best_ms([&]
+                                {
+      h = base;
+      h.insert(h.end(), items.begin(), items.end());
+      for (auto it = h.begin() + static_cast<std::ptrdiff_t>(heap_size); it != h.end();)
+        std::push_heap(h.begin(), ++it);
+      sink = sink + h.front(); });
+    const double rebuild = best_ms([&]
+                                   {
+      h = base;
+      h.insert(h.end(), items.begin(), items.end());
+      std::make_heap(h.begin(), h.end());
+      sink = sink + h.front(); });
+    const double range = best_ms([&]
+                                 {
+      h = base;
+      heap_utils::heap_push_range(h, items.begin(), items.end());
+      sink = sink + h.front(); });
+
+    std::printf("push %-6s heap=%-9zu batch=%-9zu loop=%9.3fms sift=%9.3fms rebuild=%9.3fms range=%9.3fms (%s)\n",
+                ascending ? "asc" : "random", heap_size, batch, loop, sift, rebuild, range,
+                heap_utils::heap_push_range_should_rebuild(heap_size, batch) ? "rebuild" : "sift");
+  }
+
+  void bench_pop(std::size_t heap_size, std::size_t n)
+  {
+    std::mt19937_64 rng(2);
+    std::vector<std::uint64_t> base(heap_size);
+    for (auto &x : base)
+    {
+      x = rng();
+    }
+    heap_utils::heapify(base.begin(), base.end());
+
+    std::vector<std::uint64_t> h;
+    std::vector<std::uint64_t> out;
+    out.reserve(n);
+    const double loop = best_ms([&]
+                                {
+      h = base;
+      out.clear();
+      for (std::size_t i = 0; i < n; ++i)
+        out.push_back(heap_utils::heap_pop(h));
+      sink = sink + out.back(); });
+    const double bulk = best_ms([&]
+                                {
+      h = base;
+      out.clear();
+      heap_utils::heap_pop_n(h, n, std::back_inserter(out));
+      sink = sink + out.back(); });
+    std::printf("pop   heap=%-9zu n=%-9zu loop=%9.3fms pop_n=%9.3fms\n", heap_size, n, loop, bulk);
+  }
+
+  void bench_replace(std::size_t heap_size, std::size_t stream, bool ascending)
+  {
+    std::mt19937_64 rng(3);
+    std::vector<std::uint64_t> base(heap_size);
+    for (auto &x : base)
+    {
+      x = rng();
+    }
+    std::vector<std::uint64_t> items(stream);
+    for (auto &x : items)
+    {
+      x = rng();
+    }
+    if (ascending)
+    {
+      std::sort(items.begin(), items.end());
+    }
+    // Min-heap of the N largest: evict the smallest when a larger value arrives.
+    heap_utils::heapify(base.begin(), base.end(), std::greater<>{});
+
+    std::vector<std::uint64_t> h;
+    const double pop_push = best_ms([&]
+                                    {
+      h = base;
+      for (std::uint64_t x : items)
+        if (x > h.front())
+        {
+          heap_utils::heap_pop(h, std::greater<>{});
+          heap_utils::heap_push(h, x, std::greater<>{});
+        }
+      sink = sink + h.front(); });
+    const double replace = best_ms([&]
+                                   {
+      h = base;
+      for (std::uint64_t x : items)
+        if (x > h.front())
+          heap_utils::heap_replace_top(h, x, std::greater<>{});
+      sink = sink + h.front(); });
+    std::printf("top-N %-6s heap=%-9zu stream=%-9zu pop+push=%9.3fms replace_top=%9.3fms\n",
+                ascending ? "asc" : "random", heap_size, stream, pop_push, replace);
+  }
+
+  void bench_merge(std::size_t a_size, std::size_t b_size)
+  {
+    std::mt19937_64 rng(4);
+    std::vector<std::uint64_t> base_a(a_size);
+    std::vector<std::uint64_t> base_b(b_size);
+    for (auto &x : base_a)
+    {
+      x = rng();
+    }
+    for (auto &x : base_b)
+    {
+      x = rng();
+    }
+    heap_utils::heapify(base_a.begin(), base_a.end());
+    heap_utils::heapify(base_b.begin(), base_b.end());
+
+    std::vector<std::uint64_t> a;
+    std::vector<std::uint64_t> b;
+    const double concat = best_ms([&]
+                                  {
+      a = base_a;
+      b = base_b;
+      a.insert(a.end(), b.begin(), b.end());
+      heap_utils::heapify(a.begin(), a.end());
+      sink = sink + a.front(); });
+    const double merge = best_ms([&]
+                                 {
+      a = base_a;
+      b = base_b;
+      heap_utils::heap_merge(a, std::move(b));
+      sink = sink + a.front(); });
+    std::printf("merge a=%-9zu b=%-9zu concat+heapify=%9.3fms heap_merge=%9.3fms\n", a_size, b_size, concat,
+                merge);
+  }
+} // namespace
+
+int main()
+{
+  for (std::size_t heap_size : {std::size_t{0}, std::size_t{10000}, std::size_t{100000}, std::size_t{1000000}})
+  {
+    for (std::size_t batch : {std::size_t{64}, std::size_t{1000}, std::size_t{100000}, std::size_t{1000000}})
+    {
+      bench_push(heap_size, batch, false);
+      bench_push(heap_size, batch, true);
+    }
+  }
+  for (std::size_t n : {std::size_t{64}, std::size_t{1000}, std::size_t{100000}})
+  {
+    bench_pop(1000000, n);
+  }
+  for (std::size_t heap_size : {std::size_t{100}, std::size_t{10000}, std::size_t{1000000}})
+  {
+    // Ascending streams retain (almost) every item: the worst case for top-N.
+    bench_replace(heap_size, 1000000, false);
+    bench_replace(heap_size, 1000000, true);
+  }
+  for (std::size_t b_size : {std::size_t{1000}, std::size_t{100000}, std::size_t{1000000}})
+  {
+    bench_merge(1000000, b_size);
+    bench_merge(b_size, 1000000);
+  }
+  return 0;
+}
@@ -0,0 +1,153 @@
+// LFU cache benchmark: hash map + lazy vector heap vs priority_cache.
+//
+// A cache of `capacity` entries serves n requests over a skewed key space
+// (key = r^3 scaled to 10 * capacity, so low keys are hot). A hit bumps
+// the key's access count; a miss inserts it, evicting the least frequently
+// used entry when full. Both versions use the same score, the count in the
+// high 32 bits and the inverted key below it, so ties evict the colder
+// (larger) key and the hit rates match.
+//
+//   map + lazy heap  unordered_map<key, { value, score }> plus a std::vector
+//                    heap of { score, key } fed with heap_push on every hit;
+//                    eviction pops until it finds an entry whose score is
+//                    current (the ad-hoc version)
+//   priority_cache   priority_cache::touch / insert_or_assign
+//
+// Usage: heap_utils_bench_cache [capacity] [n]   (default 100000, 20M)
+//
+// Build with -DHEAP_UTILS_BUILD_BENCHMARKS=ON and run in Release mode.
+
+#include <heap_utils/heap_utils.hpp>
+#include <heap_utils/priority_cache.hpp>
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace
+{
+  constexpr std::uint64_t count_one = std::uint64_t{1} << 32;
+
+  std::uint64_t initial_score(std::uint64_t key) { return count_one | (0xFFFFFFFFu - key); }
+
+  std::vector<std::uint64_t> make_requests(std::size_t capacity, std::size_t n)
+  {
+    std::mt19937_64 rng(30);
+    std::uniform_real_distribution<double> u(0.0, 1.0);
+    const double keys = 10.0 * static_cast<double>(capacity);
+    std::vector<std::uint64_t> out(n);
+    for (std::uint64_t &k : out)
+    {
+      const double r = u(rng);
+      k = static_cast<std::uint64_t>(r * r * r * keys);
+    }
+    return out;
+  }
+
+  struct lazy_lfu
+  {
+    struct slot
+    {
+      std::uint64_t value;
+      std::uint64_t score;
+    };
+    using item = std::pair<std::uint64_t, std::uint64_t>; // { score, key }
+
+    struct by_score
+    {
+      bool operator()(const item &a, const item &b) const { return a.first > b.first; }
+    };
+
+    std::size_t capacity;
+    std::unordered_map<std::uint64_t, slot> map;
+    std::vector<item> heap;
+    std::size_t peak = 0;
+
+    explicit lazy_lfu(std::size_t c) : capacity(c) { map.reserve(c); }
+
+    bool access(std::uint64_t key)
+    {
+      const auto it = map.find(key);
+      if (it != map.end())
+      {
+        it->second.score += count_one;
+        heap_utils::heap_push(heap, item{it->second.score, key}, by_score{});
+        peak = (heap.size() > peak) ? heap.size() : peak;
+        return true;
+      }
+      if (map.size() == capacity)
+      {
+        for (;;)
+        {
+          const item top = heap_utils::heap_pop(heap, by_score{});
+          const auto victim = map.find(top.second);
+          if (victim != map.end() && victim->second.score == top.first)
+          {
+            map.erase(victim);
+            break;
+          }
+        }
+      }
+      map.emplace(key, slot{key, initial_score(key)});
+      heap_utils::heap_push(heap, item{initial_score(key), key}, by_score{});
+      peak = (heap.size() > peak) ? heap.size() : peak;
+      return false;
+    }
+  };
+
+  struct indexed_lfu
+  {
+    heap_utils::priority_cache<std::uint64_t, std::uint64_t> cache;
+
+    explicit indexed_lfu(std::size_t c) : cache(c) {}
+
+    bool access(std::uint64_t key)
+    {
+      if (cache.touch(key, count_one))
+      {
+        return true;
+      }
+      cache.insert_or_assign(key, key, initial_score(key));
+      return false;
+    }
+  };
+
+  template <class Cache>
+  void run(const char *name, Cache &cache, const std::vector<std::uint64_t> &requests)
+  {
+    std::size_t hits = 0;
+    const auto t0 = std::chrono::steady_clock::now();
+    for (std::uint64_t key : requests)
+    {
+      hits += cache.access(key) ? 1 : 0;
+    }
+    const double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+    std::printf("  %-15s %9.1f ms  (%6.1f ns/request, hit rate %.3f)\n", name, ms,
+                ms * 1e6 / static_cast<double>(requests.size()),
+                static_cast<double>(hits) / static_cast<double>(requests.size()));
+  }
+} // namespace
+
+int main(int argc, char **argv)
+{
+  const std::size_t capacity = (argc > 1) ? std::strtoull(argv[1], nullptr, 10) : 100000;
+  const std::size_t n = (argc > 2) ? std::strtoull(argv[2], nullptr, 10) : 20000000;
+  const std::vector<std::uint64_t> requests = make_requests(capacity, n);
+
+  std::printf("capacity = %zu, %zu requests\n", capacity, n);
+  {
+    lazy_lfu cache(capacity);
+    run("map + lazy heap", cache, requests);
+    std::printf("  %-15s %9zu heap entries at peak\n", "", cache.peak);
+  }
+  {
+    indexed_lfu cache(capacity);
+    run("priority_cache", cache, requests);
+  }
+  return 0;
+}
@@ -0,0 +1,203 @@
+// Heap engine benchmark on a shortest-path workload.
+//
+// Runs Dijkstra on a random sparse graph with each engine. Engines without
+// addressable elements (binary_heap, d_ary_heap, radix_heap) use the usual
+// re-push + stale-entry skip; indexed_heap and pairing_heap use decrease-key.
+// pairing_heap is also run with the bundled pool and arena allocators.
+//
+// Build with -DHEAP_UTILS_BUILD_BENCHMARKS=ON and run in Release mode.
+
+#include <heap_utils/allocators.hpp>
+#include <heap_utils/d_ary_heap.hpp>
+#include <heap_utils/heap_utils.hpp>
+#include <heap_utils/indexed_heap.hpp>
+#include <heap_utils/pairing_heap.hpp>
+#include <heap_utils/radix_heap.hpp>
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+#include <limits>
+#include <random>
+#include <utility>
+#include <vector>
+
+namespace
+{
+  struct edge
+  {
+    std::uint32_t to;
+    std::uint32_t weight;
+  };
+
+  using graph = std::vector<std::vector<edge>>;
+  using item = std::pair<std::uint64_t, std::uint32_t>;
+
+  constexpr std::uint64_t inf = std::numeric_limits<std::uint64_t>::max();
+
+  graph make_graph(std::uint32_t nodes, std::uint32_t degree)
+  {
+    std::mt19937 rng(7);
+    std::uniform_int_distribution<std::uint32_t> pick(0, nodes - 1);
+    std::uniform_int_distribution<std::uint32_t> w(1, 1000);
+    graph g(nodes);
+    for (std::uint32_t u = 0; u < nodes; ++u)
+    {
+      for (std::uint32_t e = 0; e < degree; ++e)
+      {
+        g[u].push_back(edge{pick(rng), w(rng)});
+      }
+    }
+    return g;
+  }
+
+  template <class Heap>
+  std::uint64_t dijkstra_lazy(const graph &g, Heap &heap)
+  {
+    std::vector<std::uint64_t> dist(g.size(), inf);
+    dist[0] = 0;
+    heap.push(item{0, 0});
+    while (!heap.empty())
+    {
+      const item top = heap.pop();
+      if (top.first != dist[top.second])
+      {
+        continue;
+      }
+      for (const edge &e : g[top.second])
+      {
+        const std::uint64_t nd = top.first + e.weight;
+        if (nd < dist[e.to])
+        {
+          dist[e.to] = nd;
+          heap.push(item{nd, e.to});
+        }
+      }
+    }
+    std::uint64_t sum = 0;
+    for (std::uint64_t d : dist)
+    {
+      sum += (d == inf) ? 0 : d;
+    }
+    return sum;
+  }
+
+  std::uint64_t dijkstra_indexed(const graph &g)
+  {
+    heap_utils::indexed_heap<std::uint64_t> heap(g.size());
+    std::vector<std::uint64_t> dist(g.size(), inf);
+    dist[0] = 0;
+    heap.push(0, 0);
+    while (!heap.empty())
+    {
+      const std::uint64_t du = heap.top_key();
+      const auto u = heap.pop();
+      for (const edge &e : g[u])
+      {
+        const std::uint64_t nd = du + e.weight;
+        if (nd < dist[e.to])
+        {
+          dist[e.to] = nd;
+          heap.push_or_update(e.to, nd);
+        }
+      }
+    }
+    std::uint64_t sum = 0;
+    for (std::uint64_t d : dist)
+    {
+      sum += (d == inf) ? 0 : d;
+    }
+    return sum;
+  }
+
+  template <class Heap>
+  std::uint64_t dijkstra_pairing(const graph &g, Heap &heap)
+  {
+    using heap_t = Heap;
+    std::vector<typename heap_t::handle> handles(g.size());
+    std::vector<bool> done(g.size(), false);
+    std::vector<std::uint64_t> dist(g.size(), inf);
+    dist[0] = 0;
+    handles[0] = heap.push(item{0, 0});
+    while (!heap.empty())
+    {
+      const item top = heap.pop();
+      done[top.second] = true;
+      for (const edge &e : g[top.second])
+      {
+        const std::uint64_t nd = top.first + e.weight;
+        if (!done[e.to] && nd < dist[e.to])
+        {
+          if (dist[e.to] == inf)
+          {
+            handles[e.to] = heap.push(item{nd, e.to});
+          }
+          else
+          {
+            heap.decrease_key(handles[e.to], item{nd, e.to});
+          }
+          dist[e.to] = nd;
+        }
+      }
+    }
+    std::uint64_t sum = 0;
+    for (std::uint64_t d : dist)
+    {
+      sum += (d == inf) ? 0 : d;
+    }
+    return sum;
+  }
+
+  template <class F>
+  void report(const char *name, F &&run)
+  {
+    double best = 1e300;
+    std::uint64_t check = 0;
+    for (int rep = 0; rep < 3; ++rep)
+    {
+      const auto t0 = std::chrono::steady_clock::now();
+      check = run();
+      const auto t1 = std::chrono::steady_clock::now();
+      const double ms = std::chrono::duration<double, std::milli>(t1 - t0).count();
+      best = (ms < best) ? ms : best;
+    }
+    std::printf("%-22s %10.3f ms  (checksum %llu)\n", name, best,
+                static_cast<unsigned long long>(check));
+  }
+} // namespace
+
+int main()
+{
+  for (std::uint32_t nodes : {100000u, 1000000u})
+  {
+    const graph g = make_graph(nodes, 8);
+    std::printf("dijkstra: %u nodes, %u edges\n", nodes, nodes * 8);
+
+    report("binary_heap (lazy)", [&]
+           { heap_utils::binary_heap<item, std::greater<>> h; return dijkstra_lazy(g, h); });
+    report("d_ary_heap<4> (lazy)", [&]
+           { heap_utils::d_ary_heap<item, 4, std::greater<>> h; return dijkstra_lazy(g, h); });
+    report("d_ary_heap<8> (lazy)", [&]
+           { heap_utils::d_ary_heap<item, 8, std::greater<>> h; return dijkstra_lazy(g, h); });
+    report("radix_heap (lazy)", [&]
+           { heap_utils::radix_heap<item, heap_utils::radix_first> h; return dijkstra_lazy(g, h); });
+    report("indexed_heap", [&]
+           { return dijkstra_indexed(g); });
+    report("pairing_heap", [&]
+           { heap_utils::pairing_heap<item, std::greater<>> h; return dijkstra_pairing(g, h); });
+    report("pairing_heap (pool)", [&]
+           {
+             heap_utils::fixed_pool pool(4096);
+             heap_utils::pairing_heap<item, std::greater<>, heap_utils::pool_allocator<item>> h{
+                 heap_utils::pool_allocator<item>(pool)};
+             return dijkstra_pairing(g, h); });
+    report("pairing_heap (arena)", [&]
+           {
+             heap_utils::arena a(1 << 20);
+             heap_utils::pairing_heap<item, std::greater<>, heap_utils::arena_allocator<item>> h{
+                 heap_utils::arena_allocator<item>(a)};
+             return dijkstra_pairing(g, h); });
+  }
+  return 0;
+}
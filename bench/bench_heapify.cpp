@@ -0,0 +1,82 @@
+// Parallel heapify benchmark.
+//
+// Compares std::make_heap against heapify(parallel_policy{t}, ...) for
+// 1M / 10M / 100M uint32 keys (add --huge for 1B, which needs ~8 GB) and
+// t = 1, 2, 4, ... up to hardware_concurrency(). Timings exclude copying
+// the unordered input.
+//
+// Build with -DHEAP_UTILS_BUILD_BENCHMARKS=ON and run in Release mode.
+
+#include <heap_utils/parallel.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <thread>
+#include <vector>
+
+namespace
+{
+  volatile std::uint64_t sink = 0;
+
+  template <class F>
+  double best_ms(const std::vector<std::uint32_t> &base, std::vector<std::uint32_t> &work, int reps, F &&run)
+  {
+    double best = 1e300;
+    for (int rep = 0; rep < reps; ++rep)
+    {
+      std::copy(base.begin(), base.end(), work.begin());
+      const auto t0 = std::chrono::steady_clock::now();
+      run();
+      const auto t1 = std::chrono::steady_clock::now();
+      const double ms = std::chrono::duration<double, std::milli>(t1 - t0).count();
+      best = (ms < best) ? ms : best;
+      sink = sink + work.front();
+    }
+    return best;
+  }
+
+  void bench(std::size_t n, std::size_t max_threads)
+  {
+    std::mt19937 rng(1);
+    std::vector<std::uint32_t> base(n);
+    for (auto &x : base)
+    {
+      x = static_cast<std::uint32_t>(rng());
+    }
+    std::vector<std::uint32_t> work(n);
+    const int reps = (n >= 100000000) ? 1 : 3;
+
+    const double seq = best_ms(base, work, reps, [&]
+                               { std::make_heap(work.begin(), work.end()); });
+    std::printf("%12zu  std::make_heap        %10.1f ms\n", n, seq);
+
+    for (std::size_t t = 1; t <= max_threads; t *= 2)
+    {
+      const double par = best_ms(base, work, reps, [&]
+                                 { heap_utils::heapify(heap_utils::parallel_policy{t}, work.begin(), work.end()); });
+      std::printf("%12zu  heapify(par, t=%-3zu)  %10.1f ms  (x%.2f)\n", n, t, par, seq / par);
+    }
+  }
+} // namespace
+
+int main(int argc, char **argv)
+{
+  const bool huge = argc > 1 && std::strcmp(argv[1], "--huge") == 0;
+  const unsigned hw = std::thread::hardware_concurrency();
+  const std::size_t max_threads = (hw == 0) ? 1 : hw;
+
+  std::printf("hardware threads: %zu\n", max_threads);
+  for (std::size_t n : {std::size_t(1000000), std::size_t(10000000), std::size_t(100000000)})
+  {
+    bench(n, max_threads);
+  }
+  if (huge)
+  {
+    bench(1000000000, max_threads);
+  }
+  return 0;
+}
@@ -0,0 +1,121 @@
+// k-way merge benchmark.
+//
+// Merges k sorted runs of uint64 keys (8M elements in total) with:
+//
+//   pop+push     std::vector heap of cursors with heap_pop / heap_push
+//   replace-top  the small-k path of k_way_merge (heap, in-place sift-down)
+//   loser tree   loser_tree (the large-k path of k_way_merge)
+//
+// Used to pick k_way_merge_heap_threshold.
+//
+// Build with -DHEAP_UTILS_BUILD_BENCHMARKS=ON and run in Release mode.
+
+#include <heap_utils/k_way_merge.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <random>
+#include <utility>
+#include <vector>
+
+namespace
+{
+  using run_t = std::vector<std::uint64_t>;
+  using iter_t = run_t::const_iterator;
+
+  volatile std::uint64_t sink = 0;
+
+  template <class F>
+  double best_ms(F &&run)
+  {
+    double best = 1e300;
+    for (int rep = 0; rep < 3; ++rep)
+    {
+      const auto t0 = std::chrono::steady_clock::now();
+      run();
+      const auto t1 = std::chrono::steady_clock::now();
+      const double ms = std::chrono::duration<double, std::milli>(t1 - t0).count();
+      best = (ms < best) ? ms : best;
+    }
+    return best;
+  }
+
+  std::vector<std::pair<iter_t, iter_t>> bounds(const std::vector<run_t> &runs)
+  {
+    std::vector<std::pair<iter_t, iter_t>> b;
+    for (const run_t &r : runs)
+    {
+      b.emplace_back(r.cbegin(), r.cend());
+    }
+    return b;
+  }
+
+  void bench(std::size_t k, std::size_t total)
+  {
+    std::mt19937_64 rng(k);
+    std::vector<run_t> runs(k);
+    for (std::size_t i = 0; i < total; ++i)
+    {
+      runs[i % k].push_back(rng());
+    }
+    for (run_t &r : runs)
+    {
+      std::sort(r.begin(), r.end());
+    }
+    std::vector<std::uint64_t> out(total);
+
+    const double pop_push = best_ms([&]
+                                    {
+      struct cursor
+      {
+        iter_t cur;
+        iter_t end;
+      };
+      auto later = [](const cursor &a, const cursor &b) { return *b.cur < *a.cur; };
+      std::vector<cursor> heap;
+      for (const run_t &r : runs)
+        if (!r.empty())
+          heap_utils::heap_push(heap, cursor{r.cbegin(), r.cend()}, later);
+      auto o = out.begin();
+      while (!heap.empty())
+      {
+        cursor c = heap_utils::heap_pop(heap, later);
+        *o++ = *c.cur++;
+        if (c.cur != c.end)
+          heap_utils::heap_push(heap, c, later);
+      }
+      sink = sink + out.back(); });
+
+    const double replace_top = best_ms([&]
+                                       {
+      auto b = bounds(runs);
+      heap_utils::detail::heap_merge_runs(b, out.begin(), std::less<>{});
+      sink = sink + out.back(); });
+
+    const double tree = best_ms([&]
+                                {
+      heap_utils::loser_tree<iter_t> t(bounds(runs));
+      auto o = out.begin();
+      while (!t.empty())
+      {
+        *o++ = t.take_top();
+        t.advance();
+      }
+      sink = sink + out.back(); });
+
+    std::printf("k=%5zu  pop+push %8.1f ms  replace-top %8.1f ms  loser tree %8.1f ms\n", k, pop_push,
+                replace_top, tree);
+  }
+} // namespace
+
+int main()
+{
+  const std::size_t total = std::size_t(8) << 20;
+  for (std::size_t k : {2u, 4u, 8u, 16u, 64u, 256u, 1024u})
+  {
+    bench(k, total);
+  }
+  return 0;
+}
@@ -0,0 +1,111 @@
+// Heap layout benchmark on large in-RAM heaps.
+//
+// Heapifies n random uint64 keys, then runs n / 4 pops each followed by a
+// push (a steady-state queue of size n), with:
+//
+//   std heap       std::vector with heap_pop / heap_push (std::pop_heap)
+//   d-ary<8>       paged_heap with d_ary_layout<8>
+//   b-heap 4K      paged_heap with b_heap_layout<4096>
+//   b-heap 2M      paged_heap with b_heap_layout<2 MiB> (huge-page blocks)
+//
+// Usage: heap_utils_bench_paged_heap [max_n]   (default 32M; needs about 26 bytes per element)
+//
+// Build with -DHEAP_UTILS_BUILD_BENCHMARKS=ON and run in Release mode.
+
+#include <heap_utils/b_heap.hpp>
+#include <heap_utils/heap_utils.hpp>
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <utility>
+#include <vector>
+
+namespace
+{
+  volatile std::uint64_t sink = 0;
+
+  struct timing
+  {
+    double heapify_ms;
+    double churn_ms;
+  };
+
+  double elapsed_ms(std::chrono::steady_clock::time_point t0)
+  {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+  }
+
+  timing run_std(const std::vector<std::uint64_t> &keys, const std::vector<std::uint64_t> &refill)
+  {
+    std::vector<std::uint64_t> heap(keys);
+    auto t0 = std::chrono::steady_clock::now();
+    heap_utils::heapify(heap.begin(), heap.end());
+    const double build = elapsed_ms(t0);
+
+    t0 = std::chrono::steady_clock::now();
+    std::uint64_t acc = 0;
+    for (std::uint64_t x : refill)
+    {
+      acc += heap_utils::heap_pop(heap);
+      heap_utils::heap_push(heap, x);
+    }
+    sink = sink + acc;
+    return {build, elapsed_ms(t0)};
+  }
+
+  template <class Layout>
+  timing run_paged(const std::vector<std::uint64_t> &keys, const std::vector<std::uint64_t> &refill)
+  {
+    using heap_t = heap_utils::paged_heap<std::uint64_t, Layout>;
+    typename heap_t::container_type values(keys.begin(), keys.end());
+    heap_t heap;
+    auto t0 = std::chrono::steady_clock::now();
+    heap.heapify(std::move(values));
+    const double build = elapsed_ms(t0);
+
+    t0 = std::chrono::steady_clock::now();
+    std::uint64_t acc = 0;
+    for (std::uint64_t x : refill)
+    {
+      acc += heap.pop();
+      heap.push(x);
+    }
+    sink = sink + acc;
+    return {build, elapsed_ms(t0)};
+  }
+
+  void print(const char *name, std::size_t ops, timing t)
+  {
+    std::printf("  %-10s heapify %9.1f ms   pop+push %9.1f ms  (%6.1f ns/op)\n", name, t.heapify_ms, t.churn_ms,
+                t.churn_ms * 1e6 / static_cast<double>(ops));
+  }
+} // namespace
+
+int main(int argc, char **argv)
+{
+  const std::size_t max_n = (argc > 1) ? std::strtoull(argv[1], nullptr, 10) : (std::size_t{1} << 25);
+  for (std::size_t n = std::size_t{1} << 20; n <= max_n; n *= 4)
+  {
+    std::mt19937_64 rng(n);
+    std::vector<std::uint64_t> keys(n);
+    for (std::uint64_t &k : keys)
+    {
+      k = rng();
+    }
+    std::vector<std::uint64_t> refill(n / 4);
+    for (std::uint64_t &k : refill)
+    {
+      k = rng();
+    }
+
+    std::printf("n = %zu\n", n);
+    print("std heap", refill.size(), run_std(keys, refill));
+    print("d-ary<8>", refill.size(), run_paged<heap_utils::d_ary_layout<8>>(keys, refill));
+    print("b-heap 4K", refill.size(), run_paged<heap_utils::b_heap_layout<4096>>(keys, refill));
+    print("b-heap 2M", refill.size(), run_paged<heap_utils::b_heap_layout<(2u << 20)>>(keys, refill));
+  }
+  return 0;
+}
@@ -0,0 +1,411 @@
+// Benchmark suite for the core heap helpers and the top_k strategies.
+//
+// Times heapify, heap_push, heap_pop and every top_k strategy for
+// int32 / uint64 keys and 16 / 64 / 128-byte records, over random, sorted,
+// reverse and many-duplicates inputs, from 1K elements up to --max-size
+// (default 10M; pass --max-size 100000000 for 100M). Inputs larger than
+// --max-bytes (default 2 GiB) are skipped. Each row reports the best of
+// several repetitions in ns per element and, on Linux when perf events are
+// accessible, last-level cache misses per element.
+//
+//   heap_utils_bench [--max-size N] [--max-bytes N] [--filter TEXT] [--csv]
+//
+// --filter keeps the rows whose "op/type/dist" label contains TEXT, e.g.
+// --filter top_k or --filter u64/random.
+//
+// Build with -DHEAP_UTILS_BUILD_BENCHMARKS=ON and run in Release mode.
+
+#include <heap_utils/heap_utils.hpp>
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+  template <std::size_t Bytes>
+  struct record
+  {
+    std::uint64_t key;
+    std::array<unsigned char, Bytes - sizeof(std::uint64_t)> payload;
+
+    friend bool operator<(const record &a, const record &b) { return a.key < b.key; }
+  };
+
+  template <class T>
+  T make_value(std::uint64_t key)
+  {
+    if constexpr (std::is_arithmetic_v<T>)
+    {
+      return static_cast<T>(key);
+    }
+    else
+    {
+      T v{};
+      v.key = key;
+      return v;
+    }
+  }
+
+  template <class T>
+  std::uint64_t key_of(const T &v)
+  {
+    if constexpr (std::is_arithmetic_v<T>)
+    {
+      return static_cast<std::uint64_t>(v);
+    }
+    else
+    {
+      return v.key;
+    }
+  }
+
+  volatile std::uint64_t sink = 0;
+
+  /// Cache-miss counter for the calling thread; inactive when perf events are unavailable.
+  class miss_counter
+  {
+  public:
+    miss_counter()
+    {
+#if defined(__linux__)
+      perf_event_attr attr;
+      std::memset(&attr, 0, sizeof(attr));
+      attr.size = sizeof(attr);
+      attr.type = PERF_TYPE_HARDWARE;
+      attr.config = PERF_COUNT_HW_CACHE_MISSES;
+      attr.disabled = 1;
+      attr.exclude_kernel = 1;
+      attr.exclude_hv = 1;
+      fd_ = static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+#endif
+    }
+
+    miss_counter(const miss_counter &) = delete;
+    miss_counter &operator=(const miss_counter &) = delete;
+
+    ~miss_counter()
+    {
+#if defined(__linux__)
+      if (fd_ >= 0)
+      {
+        close(fd_);
+      }
+#endif
+    }
+
+    bool available() const noexcept { return fd_ >= 0; }
+
+    void start()
+    {
+#if defined(__linux__)
+      if (fd_ >= 0)
+      {
+        ioctl(fd_, PERF_EVENT_IOC_RESET, 0);
+        ioctl(fd_, PERF_EVENT_IOC_ENABLE, 0);
+      }
+#endif
+    }
+
+    std::uint64_t stop()
+    {
+      std::uint64_t count = 0;
+#if defined(__linux__)
+      if (fd_ >= 0)
+      {
+        ioctl(fd_, PERF_EVENT_IOC_DISABLE, 0);
+        if (read(fd_, &count, sizeof(count)) != static_cast<ssize_t>(sizeof(count)))
+        {
+          count = 0;
+        }
+      }
+#endif
+      return count;
+    }
+
+  private:
+    int fd_ = -1;
+  };
+
+  struct options
+  {
+    std::size_t max_size = 10000000;
+    std::size_t max_bytes = std::size_t(2) << 30;
+    std::string filter;
+    bool csv = false;
+  };
+
+  struct runner
+  {
+    options opt;
+    miss_counter misses;
+
+    bool wanted(const std::string &label) const
+    {
+      return opt.filter.empty() || label.find(opt.filter) != std::string::npos;
+    }
+
+    /// Best of `reps` runs of `run` after `setup`; only `run` is timed.
+    template <class Setup, class Run>
+    void measure(const std::string &label, std::size_t n, std::size_t k, Setup &&setup, Run &&run)
+    {
+      if (!wanted(label))
+      {
+        return;
+      }
+      // Roughly 10M elements of work per row, but at least 3 repetitions.
+      const std::size_t reps = (n >= 3000000) ? 3 : 10000000 / n;
+      double best_ns = 1e300;
+      std::uint64_t best_misses = 0;
+      for (std::size_t rep = 0; rep < reps; ++rep)
+      {
+        setup();
+        misses.start();
+        const auto t0 = std::chrono::steady_clock::now();
+        run();
+        const auto t1 = std::chrono::steady_clock::now();
+        const std::uint64_t m = misses.stop();
+        const double ns = std::chrono::duration<double, std::nano>(t1 - t0).count();
+        if (ns < best_ns)
+        {
+          best_ns = ns;
+          best_misses = m;
+        }
+      }
+
+      const double per = static_cast<double>(n);
+      if (opt.csv)
+      {
+        std::printf("%s,%zu,%zu,%.3f,", label.c_str(), n, k, best_ns / per);
+        if (misses.available())
+        {
+          std::printf("%.4f", static_cast<double>(best_misses) / per);
+        }
+        std::printf("\n");
+      }
+      else
+      {
+        std::printf("%-34s n=%-10zu k=%-8zu %10.3f ns/elem", label.c_str(), n, k, best_ns / per);
+        if (misses.available())
+        {
+          std::printf("  %8.4f misses/elem", static_cast<double>(best_misses) / per);
+        }
+        std::printf("\n");
+      }
+      std::fflush(stdout);
+    }
+  };
+
+  enum class distribution
+  {
+    random,
+    sorted,
+    reverse,
+    duplicates
+  };
+
+  const char *distribution_name(distribution d)
+  {
+    switch (d)
+    {
+    case distribution::random:
+      return "random";
+    case distribution::sorted:
+      return "sorted";
+    case distribution::reverse:
+      return "reverse";
+    case distribution::duplicates:
+      return "dups";
+    }
+    return "?";
+  }
+
+  template <class T>
+  std::vector<T> make_input(std::size_t n, distribution d)
+  {
+    std::mt19937_64 rng(42);
+    std::vector<T> out;
+    out.reserve(n);
+    for (std::size_t i = 0; i < n; ++i)
+    {
+      std::uint64_t key = 0;
+      switch (d)
+      {
+      case distribution::random:
+        key = rng() >> 33; // fits every key type, including int32
+        break;
+      case distribution::sorted:
+        key = i;
+        break;
+      case distribution::reverse:
+        key = n - i;
+        break;
+      case distribution::duplicates:
+        key = rng() % 16;
+        break;
+      }
+      out.push_back(make_value<T>(key));
+    }
+    return out;
+  }
+
+  const char *strategy_name(heap_utils::top_k_strategy s)
+  {
+    switch (s)
+    {
+    case heap_utils::top_k_strategy::automatic:
+      return "automatic";
+    case heap_utils::top_k_strategy::heap_pop:
+      return "heap_pop";
+    case heap_utils::top_k_strategy::bounded_heap:
+      return "bounded_heap";
+    case heap_utils::top_k_strategy::selection:
+      return "selection";
+    }
+    return "?";
+  }
+
+  template <class T>
+  void run_type(runner &r, const char *type_name)
+  {
+    for (std::size_t n = 1000; n <= r.opt.max_size; n *= 10)
+    {
+      if (n * sizeof(T) * 2 > r.opt.max_bytes)
+      {
+        break;
+      }
+      for (distribution d : {distribution::random, distribution::sorted, distribution::reverse,
+                             distribution::duplicates})
+      {
+        const std::string suffix = std::string("/") + type_name + "/" + distribution_name(d);
+        const std::vector<T> input = make_input<T>(n, d);
+        std::vector<T> work;
+        work.reserve(n);
+
+        r.measure("heapify" + suffix, n, 0, [&]
+                  { work.assign(input.begin(), input.end()); },
+                  [&]
+                  {
+                    heap_utils::heapify(work.begin(), work.end());
+                    sink = sink + key_of(work.front());
+                  });
+
+        r.measure("heap_push" + suffix, n, 0, [&]
+                  { work.clear(); },
+                  [&]
+                  {
+                    for (const T &x : input)
+                    {
+                      heap_utils::heap_push(work, x);
+                    }
+                    sink = sink + key_of(work.front());
+                  });
+
+        std::vector<T> heap = input;
+        heap_utils::heapify(heap.begin(), heap.end());
+        r.measure("heap_pop" + suffix, n, 0, [&]
+                  { work.assign(heap.begin(), heap.end()); },
+                  [&]
+                  {
+                    std::uint64_t acc = 0;
+                    while (!work.empty())
+                    {
+                      acc += key_of(heap_utils::heap_pop(work));
+                    }
+                    sink = sink + acc;
+                  });
+
+        for (std::size_t k : {std::size_t{10}, std::size_t{1000}, n / 10})
+        {
+          if (k > n || (k == n / 10 && (k == 10 || k == 1000)))
+          {
+            continue; // out of range, or already covered by a fixed k
+          }
+          for (heap_utils::top_k_strategy s :
+               {heap_utils::top_k_strategy::automatic, heap_utils::top_k_strategy::heap_pop,
+                heap_utils::top_k_strategy::bounded_heap, heap_utils::top_k_strategy::selection})
+          {
+            // The input copy is part of the cost of the by-value overload.
+            r.measure(std::string("top_k.") + strategy_name(s) + suffix, n, k, [] {},
+                      [&]
+                      {
+                        const std::vector<T> best = heap_utils::top_k(input, k, std::less<>{}, s);
+                        sink = sink + key_of(best.front());
+                      });
+          }
+          r.measure("top_k.streaming" + suffix, n, k, [] {},
+                    [&]
+                    {
+                      const std::vector<T> best = heap_utils::top_k(input.begin(), input.end(), k, std::less<>{});
+                      sink = sink + key_of(best.front());
+                    });
+        }
+      }
+    }
+  }
+
+  void usage()
+  {
+    std::fprintf(stderr, "usage: heap_utils_bench [--max-size N] [--max-bytes N] [--filter TEXT] [--csv]\n");
+  }
+} // namespace
+
+int main(int argc, char **argv)
+{
+  runner r;
+  for (int i = 1; i < argc; ++i)
+  {
+    const bool has_value = i + 1 < argc;
+    if (std::strcmp(argv[i], "--max-size") == 0 && has_value)
+    {
+      r.opt.max_size = std::strtoull(argv[++i], nullptr, 10);
+    }
+    else if (std::strcmp(argv[i], "--max-bytes") == 0 && has_value)
+    {
+      r.opt.max_bytes = std::strtoull(argv[++i], nullptr, 10);
+    }
+    else if (std::strcmp(argv[i], "--filter") == 0 && has_value)
+    {
+      r.opt.filter = argv[++i];
+    }
+    else if (std::strcmp(argv[i], "--csv") == 0)
+    {
+      r.opt.csv = true;
+    }
+    else
+    {
+      usage();
+      return 2;
+    }
+  }
+
+  if (r.opt.csv)
+  {
+    std::printf("label,n,k,ns_per_elem,misses_per_elem\n");
+  }
+  else if (!r.misses.available())
+  {
+    std::printf("(cache-miss counters unavailable: perf events not accessible)\n");
+  }
+
+  run_type<std::int32_t>(r, "i32");
+  run_type<std::uint64_t>(r, "u64");
+  run_type<record<16>>(r, "rec16");
+  run_type<record<64>>(r, "rec64");
+  run_type<record<128>>(r, "rec128");
+  return 0;
+}
@@ -0,0 +1,152 @@
+// Timer benchmark: keep-alive resets on a large connection table.
+//
+// n connections each hold a timeout of 30 s +- 1 s (ticks are milliseconds).
+// Every simulated millisecond, `resets` random connections see traffic and
+// push their timeout back, then the expired ones are collected and re-armed.
+// Engines:
+//
+//   lazy heap     std::vector min-heap of { deadline, id } with heap_push /
+//                 heap_pop; a reset pushes a new entry and the stale one is
+//                 skipped when it surfaces (the usual std-heap approach;
+//                 the heap grows by one stale entry per reset)
+//   indexed heap  indexed_heap::push_or_update (O(log n) per reset)
+//   timer queue   timer_queue (wheel of 65536 x 1 ms slots + far heap)
+//
+// Usage: heap_utils_bench_timers [n]   (default 1M)
+//
+// Build with -DHEAP_UTILS_BUILD_BENCHMARKS=ON and run in Release mode.
+
+#include <heap_utils/heap_utils.hpp>
+#include <heap_utils/indexed_heap.hpp>
+#include <heap_utils/timer_queue.hpp>
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <iterator>
+#include <random>
+#include <utility>
+#include <vector>
+
+namespace
+{
+  constexpr std::uint64_t timeout_ms = 30000;
+  constexpr std::uint64_t sim_ms = 5000;
+  constexpr std::size_t resets = 2000;
+
+  using item = std::pair<std::uint64_t, std::uint32_t>;
+
+  std::uint64_t jitter(std::mt19937_64 &rng) { return rng() % 2000; }
+
+  template <class Engine>
+  void run(const char *name, std::size_t n, Engine &engine)
+  {
+    std::mt19937_64 rng(1);
+    for (std::size_t id = 0; id < n; ++id)
+    {
+      engine.arm(id, 1000 + rng() % timeout_ms);
+    }
+
+    std::size_t fired = 0;
+    std::vector<std::size_t> expired;
+    const auto t0 = std::chrono::steady_clock::now();
+    for (std::uint64_t now = 1; now <= sim_ms; ++now)
+    {
+      for (std::size_t i = 0; i < resets; ++i)
+      {
+        engine.arm(rng() % n, now + timeout_ms - 1000 + jitter(rng));
+      }
+      expired.clear();
+      engine.expire(now, expired);
+      fired += expired.size();
+      for (std::size_t id : expired)
+      {
+        engine.arm(id, now + timeout_ms - 1000 + jitter(rng));
+      }
+    }
+    const double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+    std::printf("  %-13s %9.1f ms  (%6.1f ns per reset, %zu fired)\n", name, ms,
+                ms * 1e6 / static_cast<double>(sim_ms * resets + fired), fired);
+  }
+
+  struct lazy_heap
+  {
+    std::vector<item> heap;
+    std::vector<std::uint64_t> current;
+
+    explicit lazy_heap(std::size_t n) : current(n, 0) {}
+
+    void arm(std::size_t id, std::uint64_t deadline)
+    {
+      current[id] = deadline;
+      heap_utils::heap_push(heap, item{deadline, static_cast<std::uint32_t>(id)}, std::greater<>{});
+    }
+
+    void expire(std::uint64_t now, std::vector<std::size_t> &out)
+    {
+      while (!heap.empty() && heap.front().first <= now)
+      {
+        const item top = heap_utils::heap_pop(heap, std::greater<>{});
+        if (current[top.second] == top.first)
+        {
+          current[top.second] = 0;
+          out.push_back(top.second);
+        }
+      }
+    }
+  };
+
+  struct indexed
+  {
+    heap_utils::indexed_heap<std::uint64_t> heap;
+
+    explicit indexed(std::size_t n) : heap(n) {}
+
+    void arm(std::size_t id, std::uint64_t deadline) { heap.push_or_update(id, deadline); }
+
+    void expire(std::uint64_t now, std::vector<std::size_t> &out)
+    {
+      while (!heap.empty() && heap.top_key() <= now)
+      {
+        out.push_back(heap.pop());
+      }
+    }
+  };
+
+  struct wheel
+  {
+    heap_utils::timer_queue<std::uint64_t> timers{65536};
+
+    explicit wheel(std::size_t n) { timers.reserve(n); }
+
+    void arm(std::size_t id, std::uint64_t deadline) { timers.schedule(id, deadline); }
+
+    void expire(std::uint64_t now, std::vector<std::size_t> &out)
+    {
+      timers.pop_expired(now, std::back_inserter(out));
+    }
+  };
+} // namespace
+
+int main(int argc, char **argv)
+{
+  const std::size_t n = (argc > 1) ? std::strtoull(argv[1], nullptr, 10) : 1000000;
+  std::printf("n = %zu connections, %zu resets per ms, %llu ms\n", n, resets,
+              static_cast<unsigned long long>(sim_ms));
+  {
+    lazy_heap lazy(n);
+    run("lazy heap", n, lazy);
+    std::printf("  %-13s %9zu entries left in the heap\n", "", lazy.heap.size());
+  }
+  {
+    indexed heap(n);
+    run("indexed heap", n, heap);
+  }
+  {
+    wheel timers(n);
+    run("timer queue", n, timers);
+  }
+  return 0;
+}
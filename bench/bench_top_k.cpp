@@ -0,0 +1,114 @@
+// Crossover benchmark for the top_k strategies.
+//
+// For each (n, k, element size) it times heap_pop, bounded_heap and
+// selection, and reports which one choose_top_k_strategy() would pick.
+//
+// Build with -DHEAP_UTILS_BUILD_BENCHMARKS=ON and run in Release mode.
+
+#include <heap_utils/heap_utils.hpp>
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+namespace
+{
+  template <std::size_t Bytes>
+  struct record
+  {
+    std::uint64_t key;
+    std::array<unsigned char, Bytes - sizeof(std::uint64_t)> payload;
+
+    friend bool operator<(const record &a, const record &b) { return a.key < b.key; }
+  };
+
+  template <class T>
+  T make_value(std::uint64_t key)
+  {
+    if constexpr (std::is_arithmetic_v<T>)
+    {
+      return static_cast<T>(key);
+    }
+    else
+    {
+      T v{};
+      v.key = key;
+      return v;
+    }
+  }
+
+  const char *strategy_name(heap_utils::top_k_strategy s)
+  {
+    switch (s)
+    {
+    case heap_utils::top_k_strategy::automatic:
+      return "automatic";
+    case heap_utils::top_k_strategy::heap_pop:
+      return "heap_pop";
+    case heap_utils::top_k_strategy::bounded_heap:
+      return "bounded_heap";
+    case heap_utils::top_k_strategy::selection:
+      return "selection";
+    }
+    return "?";
+  }
+
+  volatile std::size_t sink = 0;
+
+  template <class T>
+  double time_ms(const std::vector<T> &input, std::size_t k, heap_utils::top_k_strategy s)
+  {
+    double best = 1e300;
+    for (int rep = 0; rep < 3; ++rep)
+    {
+      const auto t0 = std::chrono::steady_clock::now();
+      const auto out = heap_utils::top_k(input, k, std::less<>{}, s);
+      const auto t1 = std::chrono::steady_clock::now();
+      sink = sink + out.size();
+      const double ms = std::chrono::duration<double, std::milli>(t1 - t0).count();
+      best = (ms < best) ? ms : best;
+    }
+    return best;
+  }
+
+  template <class T>
+  void run(const char *type_name, std::size_t n)
+  {
+    std::mt19937_64 rng(42);
+    std::vector<T> input;
+    input.reserve(n);
+    for (std::size_t i = 0; i < n; ++i)
+    {
+      input.push_back(make_value<T>(rng()));
+    }
+
+    for (std::size_t k : {std::size_t{10}, n / 1000, n / 100, n / 64, n / 16, n / 10, n / 2})
+    {
+      if (k == 0)
+      {
+        continue;
+      }
+      const double hp = time_ms(input, k, heap_utils::top_k_strategy::heap_pop);
+      const double bh = time_ms(input, k, heap_utils::top_k_strategy::bounded_heap);
+      const double se = time_ms(input, k, heap_utils::top_k_strategy::selection);
+      const auto pick = heap_utils::choose_top_k_strategy(n, k, sizeof(T));
+      std::printf("%-10s n=%-9zu k=%-9zu heap_pop=%9.3fms bounded=%9.3fms select=%9.3fms auto=%s\n",
+                  type_name, n, k, hp, bh, se, strategy_name(pick));
+    }
+  }
+} // namespace
+
+int main()
+{
+  for (std::size_t n : {std::size_t{100000}, std::size_t{1000000}, std::size_t{10000000}})
+  {
+    run<std::uint32_t>("u32", n);
+    run<std::uint64_t>("u64", n);
+    run<record<16>>("rec16", n);
+    run<record<128>>("rec128", n);
+  }
+  return 0;
+}
@@ -0,0 +1,431 @@
+/**
+ * @file allocators.hpp
+ * @brief Arena and fixed-size pool allocators for heap nodes (with std::pmr support).
+ *
+ * Node-based heaps (pairing_heap) allocate one small node per element and
+ * are malloc-bound under load. This header bundles two resources tuned for
+ * that pattern:
+ *
+ * - `arena`: monotonic bump allocator; deallocation is a no-op and memory is
+ *   returned all at once by release() or the destructor. Ideal for a heap
+ *   that is built, drained and thrown away (per query / per request).
+ * - `fixed_pool`: free list of equally sized blocks carved from large chunks.
+ *   Ideal for long-lived heaps with steady push / pop churn.
+ *
+ * Both derive from std::pmr::memory_resource, so they can back
+ * std::pmr::polymorphic_allocator (and std::pmr::vector for array heaps), and
+ * both come with a light typed allocator (arena_allocator, pool_allocator)
+ * that calls them without virtual dispatch.
+ *
+ * Neither resource is thread-safe.
+ *
+ * `aligned_allocator<T, Alignment>` is a stateless allocator for array heaps
+ * that need their storage aligned to a page (see paged_heap in b_heap.hpp).
+ *
+ * Requirements: C++17+
+ */
+
+#ifndef HEAP_UTILS_ALLOCATORS_HPP
+#define HEAP_UTILS_ALLOCATORS_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <new>
+
+namespace heap_utils
+{
+  /**
+   * @brief Monotonic arena: bump-pointer allocation from growing chunks.
+   */
+  class arena : public std::pmr::memory_resource
+  {
+  public:
+    /**
+     * @param chunk_bytes Size of each chunk requested from `upstream`.
+     * @param upstream Resource that provides the chunks.
+     */
+    explicit arena(std::size_t chunk_bytes = 64 * 1024,
+                   std::pmr::memory_resource *upstream = std::pmr::new_delete_resource()) noexcept
+        : chunk_bytes_(chunk_bytes), upstream_(upstream)
+    {
+    }
+
+    arena(const arena &) = delete;
+    arena &operator=(const arena &) = delete;
+
+    ~arena() override { release(); }
+
+    /**
+     * @brief Allocate `bytes` aligned to `align` (non-virtual fast path).
+     */
+    void *allocate_bytes(std::size_t bytes, std::size_t align)
+    {
+      std::size_t pad = padding(cur_, align);
+      if (cur_ == nullptr || pad + bytes > static_cast<std::size_t>(end_ - cur_))
+      {
+        grow(bytes + align);
+        pad = padding(cur_, align);
+      }
+      std::byte *p = cur_ + pad;
+      cur_ = p + bytes;
+      return p;
+    }
+
+    /**
+     * @brief Return every chunk to the upstream resource.
+     *
+     * Invalidates all memory handed out by this arena.
+     */
+    void release() noexcept
+    {
+      while (chunks_ != nullptr)
+      {
+        chunk_header *next = chunks_->next;
+        upstream_->deallocate(chunks_, chunks_->bytes, alignof(std::max_align_t));
+        chunks_ = next;
+      }
+      cur_ = nullptr;
+      end_ = nullptr;
+      reserved_ = 0;
+    }
+
+    /**
+     * @brief Total bytes currently obtained from upstream.
+     */
+    std::size_t bytes_reserved() const noexcept { return reserved_; }
+
+  private:
+    struct chunk_header
+    {
+      chunk_header *next;
+      std::size_t bytes;
+    };
+
+    static std::size_t padding(const std::byte *p, std::size_t align) noexcept
+    {
+      const auto addr = reinterpret_cast<std::uintptr_t>(p);
+      return static_cast<std::size_t>((align - (addr % align)) % align);
+    }
+
+    void grow(std::size_t min_bytes)
+    {
+      std::size_t bytes = sizeof(chunk_header) + ((min_bytes > chunk_bytes_) ? min_bytes : chunk_bytes_);
+      void *raw = upstream_->allocate(bytes, alignof(std::max_align_t));
+      auto *h = ::new (raw) chunk_header{chunks_, bytes};
+      chunks_ = h;
+      cur_ = reinterpret_cast<std::byte *>(h + 1);
+      end_ = reinterpret_cast<std::byte *>(h) + bytes;
+      reserved_ += bytes;
+    }
+
+    void *do_allocate(std::size_t bytes, std::size_t align) override
+    {
+      return allocate_bytes(bytes, align);
+    }
+
+    void do_deallocate(void *, std::size_t, std::size_t) override {}
+
+    bool do_is_equal(const std::pmr::memory_resource &other) const noexcept override
+    {
+      return this == &other;
+    }
+
+    std::size_t chunk_bytes_;
+    std::pmr::memory_resource *upstream_;
+    chunk_header *chunks_ = nullptr;
+    std::byte *cur_ = nullptr;
+    std::byte *end_ = nullptr;
+    std::size_t reserved_ = 0;
+  };
+
+  /**
+   * @brief Free-list pool of fixed-size blocks.
+   *
+   * The block size and alignment are fixed by the first allocation (for a
+   * node-based heap: one node). Later requests of a different size or a
+   * stricter alignment are forwarded to the upstream resource, so the pool
+   * is always safe to use, just only fast for its block size.
+   */
+  class fixed_pool : public std::pmr::memory_resource
+  {
+  public:
+    /**
+     * @param blocks_per_chunk Number of blocks carved from each upstream chunk.
+     * @param upstream Resource that provides the chunks and oversized requests.
+     */
+    explicit fixed_pool(std::size_t blocks_per_chunk = 1024,
+                        std::pmr::memory_resource *upstream = std::pmr::new_delete_resource()) noexcept
+        : blocks_per_chunk_(blocks_per_chunk ? blocks_per_chunk : 1), upstream_(upstream)
+    {
+    }
+
+    fixed_pool(const fixed_pool &) = delete;
+    fixed_pool &operator=(const fixed_pool &) = delete;
+
+    ~fixed_pool() override { release(); }
+
+    /**
+     * @brief Allocate `bytes` aligned to `align` (non-virtual fast path).
+     */
+    void *allocate_bytes(std::size_t bytes, std::size_t align)
+    {
+      if (block_size_ == 0)
+      {
+        adopt(bytes, align);
+      }
+      if (!serves(bytes, align))
+      {
+        return upstream_->allocate(bytes, align);
+      }
+      if (free_ == nullptr)
+      {
+        grow();
+      }
+      free_block *b = free_;
+      free_ = b->next;
+      return b;
+    }
+
+    /**
+     * @brief Return a block obtained from allocate_bytes(bytes, align).
+     */
+    void deallocate_bytes(void *p, std::size_t bytes, std::size_t align) noexcept
+    {
+      if (!serves(bytes, align))
+      {
+        upstream_->deallocate(p, bytes, align);
+        return;
+      }
+      auto *b = ::new (p) free_block{free_};
+      free_ = b;
+    }
+
+    /**
+     * @brief Return every chunk to the upstream resource.
+     *
+     * Invalidates all pooled blocks; the block size is kept.
+     */
+    void release() noexcept
+    {
+      while (chunks_ != nullptr)
+      {
+        chunk_header *next = chunks_->next;
+        upstream_->deallocate(chunks_, chunks_->bytes, chunk_align());
+        chunks_ = next;
+      }
+      free_ = nullptr;
+    }
+
+    /**
+     * @brief Size of pooled blocks (0 until the first allocation).
+     */
+    std::size_t block_size() const noexcept { return block_size_; }
+
+  private:
+    struct free_block
+    {
+      free_block *next;
+    };
+
+    struct chunk_header
+    {
+      chunk_header *next;
+      std::size_t bytes;
+    };
+
+    void adopt(std::size_t bytes, std::size_t align) noexcept
+    {
+      block_align_ = (align > alignof(free_block)) ? align : alignof(free_block);
+      std::size_t size = (bytes > sizeof(free_block)) ? bytes : sizeof(free_block);
+      block_size_ = (size + block_align_ - 1) / block_align_ * block_align_;
+      requested_ = bytes;
+    }
+
+    bool serves(std::size_t bytes, std::size_t align) const noexcept
+    {
+      return bytes == requested_ && align <= block_align_;
+    }
+
+    std::size_t chunk_align() const noexcept
+    {
+      return (block_align_ > alignof(chunk_header)) ? block_align_ : alignof(chunk_header);
+    }
+
+    void grow()
+    {
+      const std::size_t header = (sizeof(chunk_header) + block_align_ - 1) / block_align_ * block_align_;
+      const std::size_t bytes = header + block_size_ * blocks_per_chunk_;
+      void *raw = upstream_->allocate(bytes, chunk_align());
+      chunks_ = ::new (raw) chunk_header{chunks_, bytes};
+
+      std::byte *first = static_cast<std::byte *>(raw) + header;
+      for (std::size_t i = blocks_per_chunk_; i-- > 0;)
+      {
+        free_ = ::new (first + i * block_size_) free_block{free_};
+      }
+    }
+
+    void *do_allocate(std::size_t bytes, std::size_t align) override
+    {
+      return allocate_bytes(bytes, align);
+    }
+
+    void do_deallocate(void *p, std::size_t bytes, std::size_t align) override
+    {
+      deallocate_bytes(p, bytes, align);
+    }
+
+    bool do_is_equal(const std::pmr::memory_resource &other) const noexcept override
+    {
+      return this == &other;
+    }
+
+    std::size_t blocks_per_chunk_;
+    std::pmr::memory_resource *upstream_;
+    std::size_t block_size_ = 0;
+    std::size_t block_align_ = alignof(std::max_align_t);
+    std::size_t requested_ = 0;
+    free_block *free_ = nullptr;
+    chunk_header *chunks_ = nullptr;
+  };
+
+  /**
+   * @brief Typed allocator drawing from an arena (deallocate is a no-op).
+   */
+  template <class T>
+  class arena_allocator
+  {
+  public:
+    using value_type = T;
+
+    explicit arena_allocator(arena &a) noexcept : arena_(&a) {}
+
+    template <class U>
+    arena_allocator(const arena_allocator<U> &other) noexcept : arena_(other.resource()) {}
+
+    T *allocate(std::size_t n)
+    {
+      return static_cast<T *>(arena_->allocate_bytes(n * sizeof(T), alignof(T)));
+    }
+
+    void deallocate(T *, std::size_t) noexcept {}
+
+    arena *resource() const noexcept { return arena_; }
+
+    template <class U>
+    friend bool operator==(const arena_allocator &a, const arena_allocator<U> &b) noexcept
+    {
+      return a.resource() == b.resource();
+    }
+
+    template <class U>
+    friend bool operator!=(const arena_allocator &a, const arena_allocator<U> &b) noexcept
+    {
+      return a.resource() != b.resource();
+    }
+
+  private:
+    arena *arena_;
+  };
+
+  /**
+   * @brief Typed allocator drawing single objects from a fixed_pool.
+   */
+  template <class T>
+  class pool_allocator
+  {
+  public:
+    using value_type = T;
+
+    explicit pool_allocator(fixed_pool &p) noexcept : pool_(&p) {}
+
+    template <class U>
+    pool_allocator(const pool_allocator<U> &other) noexcept : pool_(other.resource()) {}
+
+    T *allocate(std::size_t n)
+    {
+      return static_cast<T *>(pool_->allocate_bytes(n * sizeof(T), alignof(T)));
+    }
+
+    void deallocate(T *p, std::size_t n) noexcept
+    {
+      pool_->deallocate_bytes(p, n * sizeof(T), alignof(T));
+    }
+
+    fixed_pool *resource() const noexcept { return pool_; }
+
+    template <class U>
+    friend bool operator==(const pool_allocator &a, const pool_allocator<U> &b) noexcept
+    {
+      return a.resource() == b.resource();
+    }
+
+    template <class U>
+    friend bool operator!=(const pool_allocator &a, const pool_allocator<U> &b) noexcept
+    {
+      return a.resource() != b.resource();
+    }
+
+  private:
+    fixed_pool *pool_;
+  };
+
+  /**
+   * @brief Stateless allocator returning storage aligned to `Alignment` bytes.
+   *
+   * With Alignment = 4096 (or 2 MiB) an array's first element starts a page,
+   * so fixed-size blocks of the array map onto whole pages.
+   */
+  template <class T, std::size_t Alignment>
+  class aligned_allocator
+  {
+    static_assert(Alignment != 0 && (Alignment & (Alignment - 1)) == 0,
+                  "heap_utils: aligned_allocator alignment must be a power of two");
+
+  public:
+    using value_type = T;
+
+    static constexpr std::size_t alignment = Alignment < alignof(T) ? alignof(T) : Alignment;
+
+    template <class U>
+    struct rebind
+    {
+      using other = aligned_allocator<U, Alignment>;
+    };
+
+    aligned_allocator() noexcept = default;
+
+    template <class U>
+    aligned_allocator(const aligned_allocator<U, Alignment> &) noexcept {}
+
+    T *allocate(std::size_t n)
+    {
+      if (n > static_cast<std::size_t>(-1) / sizeof(T))
+      {
+        throw std::bad_array_new_length();
+      }
+      return static_cast<T *>(::operator new(n * sizeof(T), std::align_val_t{alignment}));
+    }
+
+    void deallocate(T *p, std::size_t n) noexcept
+    {
+      ::operator delete(p, n * sizeof(T), std::align_val_t{alignment});
+    }
+
+    template <class U>
+    friend bool operator==(const aligned_allocator &, const aligned_allocator<U, Alignment> &) noexcept
+    {
+      return true;
+    }
+
+    template <class U>
+    friend bool operator!=(const aligned_allocator &, const aligned_allocator<U, Alignment> &) noexcept
+    {
+      return false;
+    }
+  };
+
+} // namespace heap_utils
+
+#endif // HEAP_UTILS_ALLOCATORS_HPP
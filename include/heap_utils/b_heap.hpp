@@ -0,0 +1,512 @@
+/**
+ * @file b_heap.hpp
+ * @brief Page-aware heap layout (B-heap) and a heap container with pluggable layouts.
+ *
+ * A binary heap of n elements in the usual array layout puts level k at
+ * [2^k - 1, 2^(k+1) - 1): below the first few levels every step of a sift
+ * lands on a different page, so on a 100M-element heap almost every level of
+ * std::pop_heap is a TLB miss (and, under memory pressure, a page fault).
+ *
+ * `b_heap_layout<PageBytes>` packs the tree into blocks of S slots, S the
+ * largest power of two with S * sizeof(T) <= PageBytes (the B-heap of
+ * P.-H. Kamp). Each block holds two sibling subtrees of (S - 2) / 2 nodes
+ * whose roots, at slots 1 and 2, are the children of one leaf of the parent
+ * block, so the two children compared when a sift crosses into a block
+ * share a cache line; the S / 2 leaves of a block open S / 2 child blocks.
+ * The root block keeps the heap root in slot 0. A root-to-leaf path of a
+ * heap with n elements therefore crosses only about log(n) / log(S / 2)
+ * blocks: 3 pages for 100M ints with 4 KiB pages, 2 with 2 MiB pages.
+ * Comparisons are those of a binary heap.
+ *
+ * Blocks are numbered breadth-first and filled in order, so a node's parent
+ * always precedes it in the fill order and the usual heap algorithms apply
+ * unchanged on the "dense" index 0..n-1; the layout only maps that index to
+ * a physical slot and its parent and children (shifts and multiplies, no
+ * division on the hot path).
+ *
+ * `paged_heap<T, Layout>` is a heap container with the push / top / pop /
+ * heapify API of d_ary_heap, parameterized on the layout; `d_ary_layout<D>`
+ * selects the flat d-ary array. With the default allocator the array is
+ * aligned to the layout's page size, so each block is exactly one page when
+ * sizeof(T) is a power of two. For 2 MiB blocks, whether the kernel backs
+ * the range with huge pages depends on its transparent huge page policy.
+ *
+ * Comparator semantics match the standard heap algorithms: with std::less<>
+ * the top is the largest element (max-heap), with std::greater<> the smallest.
+ *
+ * Requirements: C++17+; paged_heap needs a default constructible,
+ * move-assignable T (slots, padding included, are value-initialized).
+ */
+
+#ifndef HEAP_UTILS_B_HEAP_HPP
+#define HEAP_UTILS_B_HEAP_HPP
+
+#include <cstddef>
+#include <functional>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include <heap_utils/allocators.hpp>
+#include <heap_utils/d_ary_heap.hpp>
+
+namespace heap_utils
+{
+  namespace detail
+  {
+    constexpr std::size_t floor_pow2(std::size_t n) noexcept
+    {
+      std::size_t p = 1;
+      while (p <= n / 2)
+      {
+        p *= 2;
+      }
+      return p;
+    }
+
+    /**
+     * @brief Block geometry of a B-heap of T in pages of PageBytes.
+     *
+     * A node is addressed as (block, offset); its dense index is
+     * block * nodes + offset and its slot block * slots + offset. Offsets
+     * 1 .. slots - 2 are nodes; offset 0 is the heap root in block 0 and
+     * padding elsewhere, offset slots - 1 is padding.
+     */
+    template <class T, std::size_t PageBytes>
+    struct b_heap_geometry
+    {
+      static constexpr std::size_t slots = floor_pow2(PageBytes / sizeof(T));
+      static constexpr std::size_t nodes = slots - 2;
+      static constexpr std::size_t first_leaf = slots / 2 - 1;
+      static constexpr std::size_t fanout = slots / 2;
+
+      static_assert(PageBytes / sizeof(T) >= 4, "heap_utils: b_heap_layout page too small for T");
+
+      /// (block, offset) of dense index j.
+      static constexpr std::pair<std::size_t, std::size_t> position(std::size_t j) noexcept
+      {
+        if (j == 0)
+        {
+          return {0, 0};
+        }
+        const std::size_t b = (j - 1) / nodes;
+        return {b, j - b * nodes};
+      }
+
+      /// Parent of (b, o), which must not be the root.
+      static constexpr std::pair<std::size_t, std::size_t> parent(std::size_t b, std::size_t o) noexcept
+      {
+        if (b == 0 || o > 2)
+        {
+          return {b, (o - 1) / 2};
+        }
+        return {(b - 1) / fanout, first_leaf + (b - 1) % fanout};
+      }
+
+      /// Whether (b, o) has at least one child among n elements.
+      static constexpr bool has_child(std::size_t n, std::size_t b, std::size_t o) noexcept
+      {
+        if (o < first_leaf)
+        {
+          return b * nodes + 2 * o + 1 < n;
+        }
+        return (b * fanout + 1 + (o - first_leaf)) * nodes + 1 < n;
+      }
+    };
+
+    /**
+     * @brief Move `value` from the hole at (b, o) down to its place among n elements.
+     */
+    template <class G, class T, class Compare>
+    void b_heap_sift_down(T *first, std::size_t n, std::size_t b, std::size_t o, T value, Compare &comp)
+    {
+      for (;;)
+      {
+        // Children are (cb, co) and (cb, co + 1): a leaf's pair opens its child block.
+        std::size_t cb = b;
+        std::size_t co = 2 * o + 1;
+        if (o >= G::first_leaf)
+        {
+          cb = b * G::fanout + 1 + (o - G::first_leaf);
+          co = 1;
+        }
+        const std::size_t cd = cb * G::nodes + co;
+        if (cd >= n)
+        {
+          break;
+        }
+        if (cd + 1 < n && comp(first[cb * G::slots + co], first[cb * G::slots + co + 1]))
+        {
+          ++co;
+        }
+        if (!comp(value, first[cb * G::slots + co]))
+        {
+          break;
+        }
+        first[b * G::slots + o] = std::move(first[cb * G::slots + co]);
+        b = cb;
+        o = co;
+      }
+      first[b * G::slots + o] = std::move(value);
+    }
+
+    /**
+     * @brief Move `value` from the hole at (b, o) up towards the root.
+     */
+    template <class G, class T, class Compare>
+    void b_heap_sift_up(T *first, std::size_t b, std::size_t o, T value, Compare &comp)
+    {
+      while (b != 0 || o != 0)
+      {
+        const auto [pb, po] = G::parent(b, o);
+        if (!comp(first[pb * G::slots + po], value))
+        {
+          break;
+        }
+        first[b * G::slots + o] = std::move(first[pb * G::slots + po]);
+        b = pb;
+        o = po;
+      }
+      first[b * G::slots + o] = std::move(value);
+    }
+
+    /**
+     * @brief Fill the hole at the root with `value` among n elements.
+     *
+     * Like std::pop_heap: the hole follows the better child down to a leaf
+     * (one comparison per level), then `value` climbs back from there. The
+     * value taken from the end of the heap almost always belongs near the
+     * bottom, so this beats a sift-down that also compares against `value`.
+     */
+    template <class G, class T, class Compare>
+    void b_heap_pop_root(T *first, std::size_t n, T value, Compare &comp)
+    {
+      std::size_t b = 0;
+      std::size_t o = 0;
+      for (;;)
+      {
+        std::size_t cb = b;
+        std::size_t co = 2 * o + 1;
+        if (o >= G::first_leaf)
+        {
+          cb = b * G::fanout + 1 + (o - G::first_leaf);
+          co = 1;
+        }
+        const std::size_t cd = cb * G::nodes + co;
+        if (cd >= n)
+        {
+          break;
+        }
+        if (cd + 1 < n && comp(first[cb * G::slots + co], first[cb * G::slots + co + 1]))
+        {
+          ++co;
+        }
+        first[b * G::slots + o] = std::move(first[cb * G::slots + co]);
+        b = cb;
+        o = co;
+      }
+      b_heap_sift_up<G>(first, b, o, std::move(value), comp);
+    }
+  } // namespace detail
+
+  /**
+   * @brief Flat d-ary array layout: element j lives at slot j.
+   */
+  template <std::size_t D>
+  struct d_ary_layout
+  {
+    static_assert(D >= 2, "heap_utils: d-ary heap arity must be at least 2");
+
+    static constexpr std::size_t page_bytes = 64;
+
+    template <class T>
+    static constexpr std::size_t slot(std::size_t j) noexcept
+    {
+      return j;
+    }
+
+    template <class T>
+    static constexpr std::size_t storage_size(std::size_t n) noexcept
+    {
+      return n;
+    }
+
+    /// Restore the heap after the element at dense index n - 1 was written.
+    template <class T, class Compare>
+    static void push(T *first, std::size_t n, Compare &comp)
+    {
+      d_ary_push_heap<D>(first, first + n, comp);
+    }
+
+    /// Move the top to dense index n - 1 and restore the heap on the first n - 1.
+    template <class T, class Compare>
+    static void pop(T *first, std::size_t n, Compare &comp)
+    {
+      d_ary_pop_heap<D>(first, first + n, comp);
+    }
+
+    template <class T, class Compare>
+    static void heapify(T *first, std::size_t n, Compare &comp)
+    {
+      d_ary_heapify<D>(first, first + n, comp);
+    }
+
+    template <class T, class Compare>
+    static bool is_heap(const T *first, std::size_t n, Compare &comp)
+    {
+      return d_ary_is_heap<D>(first, first + n, comp);
+    }
+  };
+
+  /**
+   * @brief B-heap layout: binary subtrees packed into blocks of PageBytes.
+   *
+   * Storage for n elements is about n / (S - 2) blocks of S slots.
+   */
+  template <std::size_t PageBytes = 4096>
+  struct b_heap_layout
+  {
+    static_assert(PageBytes != 0 && (PageBytes & (PageBytes - 1)) == 0,
+                  "heap_utils: b_heap_layout page size must be a power of two");
+
+    static constexpr std::size_t page_bytes = PageBytes;
+
+    template <class T>
+    using geometry = detail::b_heap_geometry<T, PageBytes>;
+
+    /// Physical slot of dense index j.
+    template <class T>
+    static constexpr std::size_t slot(std::size_t j) noexcept
+    {
+      const auto [b, o] = geometry<T>::position(j);
+      return b * geometry<T>::slots + o;
+    }
+
+    template <class T>
+    static constexpr std::size_t storage_size(std::size_t n) noexcept
+    {
+      return (n == 0) ? 0 : (geometry<T>::position(n - 1).first + 1) * geometry<T>::slots;
+    }
+
+    /// Restore the heap after the element at dense index n - 1 was written.
+    template <class T, class Compare>
+    static void push(T *first, std::size_t n, Compare &comp)
+    {
+      using G = geometry<T>;
+      const auto [b, o] = G::position(n - 1);
+      T value = std::move(first[b * G::slots + o]);
+      detail::b_heap_sift_up<G>(first, b, o, std::move(value), comp);
+    }
+
+    /// Move the top to dense index n - 1 and restore the heap on the first n - 1.
+    template <class T, class Compare>
+    static void pop(T *first, std::size_t n, Compare &comp)
+    {
+      if (n < 2)
+      {
+        return;
+      }
+      T &last = first[slot<T>(n - 1)];
+      T value = std::move(last);
+      last = std::move(first[0]);
+      detail::b_heap_pop_root<geometry<T>>(first, n - 1, std::move(value), comp);
+    }
+
+    /// Floyd's bottom-up construction, walking blocks from the last one.
+    template <class T, class Compare>
+    static void heapify(T *first, std::size_t n, Compare &comp)
+    {
+      using G = geometry<T>;
+      if (n < 2)
+      {
+        return;
+      }
+      const auto [last_block, last_offset] = G::position(n - 1);
+      for (std::size_t b = last_block + 1; b-- > 0;)
+      {
+        const std::size_t lo = (b == 0) ? 0 : 1;
+        for (std::size_t o = (b == last_block) ? last_offset + 1 : G::nodes + 1; o-- > lo;)
+        {
+          if (G::has_child(n, b, o))
+          {
+            T value = std::move(first[b * G::slots + o]);
+            detail::b_heap_sift_down<G>(first, n, b, o, std::move(value), comp);
+          }
+        }
+      }
+    }
+
+    template <class T, class Compare>
+    static bool is_heap(const T *first, std::size_t n, Compare &comp)
+    {
+      using G = geometry<T>;
+      for (std::size_t j = 1; j < n; ++j)
+      {
+        const auto [b, o] = G::position(j);
+        const auto [pb, po] = G::parent(b, o);
+        if (comp(first[pb * G::slots + po], first[b * G::slots + o]))
+        {
+          return false;
+        }
+      }
+      return true;
+    }
+  };
+
+  /**
+   * @brief Heap container with a pluggable array layout.
+   *
+   * @tparam T Element type.
+   * @tparam Layout b_heap_layout<PageBytes> (page-aware) or d_ary_layout<D> (flat).
+   * @tparam Compare Heap comparator (default: max-heap via std::less<>).
+   * @tparam Allocator Defaults to storage aligned to the layout's page size.
+   */
+  template <class T, class Layout = b_heap_layout<>, class Compare = std::less<>,
+            class Allocator = aligned_allocator<T, Layout::page_bytes>>
+  class paged_heap
+  {
+  public:
+    using value_type = T;
+    using size_type = std::size_t;
+    using value_compare = Compare;
+    using allocator_type = Allocator;
+    using layout_type = Layout;
+    using container_type = std::vector<T, Allocator>;
+
+    paged_heap() = default;
+
+    explicit paged_heap(Compare comp, const Allocator &alloc = Allocator())
+        : comp_(comp), data_(alloc)
+    {
+    }
+
+    explicit paged_heap(const Allocator &alloc) : data_(alloc) {}
+
+    /**
+     * @brief Heapify `values` (any order) in O(n).
+     */
+    explicit paged_heap(container_type values, Compare comp = Compare{})
+        : comp_(comp), data_(values.get_allocator())
+    {
+      heapify(std::move(values));
+    }
+
+    void push(const T &value)
+    {
+      grow_for_one();
+      data_[Layout::template slot<T>(size_)] = value;
+      sift_up_back();
+    }
+
+    void push(T &&value)
+    {
+      grow_for_one();
+      data_[Layout::template slot<T>(size_)] = std::move(value);
+      sift_up_back();
+    }
+
+    template <class... Args>
+    void emplace(Args &&...args)
+    {
+      push(T(std::forward<Args>(args)...));
+    }
+
+    /**
+     * @brief Return the top element.
+     * @throws std::runtime_error if the heap is empty.
+     */
+    const T &top() const
+    {
+      if (size_ == 0)
+      {
+        throw std::runtime_error("heap_utils: paged_heap::top() on empty heap");
+      }
+      return data_.front();
+    }
+
+    /**
+     * @brief Remove the top element and return it.
+     * @throws std::runtime_error if the heap is empty.
+     */
+    T pop()
+    {
+      if (size_ == 0)
+      {
+        throw std::runtime_error("heap_utils: paged_heap::pop() on empty heap");
+      }
+      Layout::pop(data_.data(), size_, comp_);
+      --size_;
+      return std::move(data_[Layout::template slot<T>(size_)]);
+    }
+
+    /**
+     * @brief Replace the contents with `values` (any order), heapified in O(n).
+     */
+    void heapify(container_type values)
+    {
+      size_ = values.size();
+      if (Layout::template storage_size<T>(size_) == size_)
+      {
+        data_ = std::move(values);
+      }
+      else
+      {
+        data_.clear();
+        data_.resize(Layout::template storage_size<T>(size_));
+        for (std::size_t j = 0; j < size_; ++j)
+        {
+          data_[Layout::template slot<T>(j)] = std::move(values[j]);
+        }
+      }
+      Layout::heapify(data_.data(), size_, comp_);
+    }
+
+    bool empty() const noexcept { return size_ == 0; }
+    size_type size() const noexcept { return size_; }
+
+    void reserve(size_type n) { data_.reserve(Layout::template storage_size<T>(n)); }
+
+    void clear() noexcept
+    {
+      data_.clear();
+      size_ = 0;
+    }
+
+    /**
+     * @brief Heap order of the underlying array (for tests and debugging).
+     */
+    bool valid() const { return Layout::is_heap(data_.data(), size_, comp_); }
+
+    /**
+     * @brief The physical array, padding slots included (see Layout::slot()).
+     */
+    const container_type &container() const noexcept { return data_; }
+
+    const Compare &value_comp() const noexcept { return comp_; }
+
+    allocator_type get_allocator() const noexcept { return data_.get_allocator(); }
+
+  private:
+    void grow_for_one()
+    {
+      const std::size_t need = Layout::template storage_size<T>(size_ + 1);
+      if (need > data_.size())
+      {
+        data_.resize(need);
+      }
+    }
+
+    void sift_up_back()
+    {
+      ++size_;
+      Layout::push(data_.data(), size_, comp_);
+    }
+
+    Compare comp_{};
+    container_type data_;
+    std::size_t size_ = 0;
+  };
+
+} // namespace heap_utils
+
+#endif // HEAP_UTILS_B_HEAP_HPP
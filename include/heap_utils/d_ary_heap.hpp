@@ -0,0 +1,539 @@
+/**
+ * @file d_ary_heap.hpp
+ * @brief d-ary heap algorithms and container (configurable arity).
+ *
+ * A d-ary heap stores the children of node i at [D*i + 1, D*i + D]. Compared
+ * to the binary heap used by std::push_heap / std::pop_heap, the tree is
+ * log2(D) times shallower, and the D children of a node are contiguous, so a
+ * sift-down touches far fewer cache lines on large heaps. D = 4 or 8 are
+ * good defaults for small keys.
+ *
+ * For arithmetic keys with std::less / std::greater, child selection uses
+ * the SIMD kernels from simd.hpp when the target ISA provides them.
+ *
+ * Comparator semantics match the standard heap algorithms: with std::less<>
+ * the top is the largest element (max-heap), with std::greater<> the smallest.
+ *
+ * Requirements: C++17+
+ */
+
+#ifndef HEAP_UTILS_D_ARY_HEAP_HPP
+#define HEAP_UTILS_D_ARY_HEAP_HPP
+
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include <heap_utils/heap_utils.hpp>
+#include <heap_utils/instrumentation.hpp>
+#include <heap_utils/simd.hpp>
+
+namespace heap_utils
+{
+  namespace detail
+  {
+    /**
+     * @brief Index of the best child among [child, child + count).
+     *
+     * "Best" is the element that must move up: the greatest according to comp.
+     * Full groups of D arithmetic keys go through a SIMD kernel when one is
+     * available; ties resolve to the first best child on both paths.
+     */
+    template <std::size_t D, class RandomIt, class Compare>
+    inline typename std::iterator_traits<RandomIt>::difference_type
+    d_ary_best_child(RandomIt first,
+                     typename std::iterator_traits<RandomIt>::difference_type child,
+                     typename std::iterator_traits<RandomIt>::difference_type count,
+                     Compare &comp)
+    {
+      using diff_t = typename std::iterator_traits<RandomIt>::difference_type;
+
+      if constexpr (use_simd_child_select<RandomIt, Compare, D>::value)
+      {
+        using value_t = typename std::iterator_traits<RandomIt>::value_type;
+        using kernel = simd_child_select<value_t, D, use_simd_child_select<RandomIt, Compare, D>::order>;
+
+        if (count == static_cast<diff_t>(D))
+        {
+          const int lane = kernel::best(&*(first + child));
+          if (lane >= 0)
+          {
+            return child + lane;
+          }
+        }
+      }
+
+      diff_t best = child;
+      for (diff_t c = child + 1; c < child + count; ++c)
+      {
+        if (comp(first[best], first[c]))
+        {
+          best = c;
+        }
+      }
+      return best;
+    }
+
+    /**
+     * @brief Move `value` down from `hole` until the heap property holds in [first, first + n).
+     *
+     * `probe` (see instrumentation.hpp) is told about every move and the
+     * number of levels descended; the default policy compiles this out.
+     */
+    template <std::size_t D, class RandomIt, class T, class Compare, class Instrumentation = no_instrumentation>
+    inline void d_ary_sift_down(RandomIt first,
+                                typename std::iterator_traits<RandomIt>::difference_type n,
+                                typename std::iterator_traits<RandomIt>::difference_type hole,
+                                T &&value, Compare &comp, Instrumentation *probe = nullptr)
+    {
+      using diff_t = typename std::iterator_traits<RandomIt>::difference_type;
+      constexpr diff_t d = static_cast<diff_t>(D);
+
+      std::size_t levels = 0;
+      for (;;)
+      {
+        const diff_t child = d * hole + 1;
+        if (child >= n)
+        {
+          break;
+        }
+        const diff_t count = (n - child < d) ? (n - child) : d;
+        const diff_t best = d_ary_best_child<D>(first, child, count, comp);
+        if (!comp(value, first[best]))
+        {
+          break;
+        }
+        first[hole] = std::move(first[best]);
+        hole = best;
+        ++levels;
+      }
+      first[hole] = std::forward<T>(value);
+      note_move(probe, levels + 1);
+      note_sift(probe, levels);
+    }
+
+    /**
+     * @brief Move `value` up from `hole` towards the root.
+     */
+    template <std::size_t D, class RandomIt, class T, class Compare, class Instrumentation = no_instrumentation>
+    inline void d_ary_sift_up(RandomIt first,
+                              typename std::iterator_traits<RandomIt>::difference_type hole,
+                              T &&value, Compare &comp, Instrumentation *probe = nullptr)
+    {
+      using diff_t = typename std::iterator_traits<RandomIt>::difference_type;
+      constexpr diff_t d = static_cast<diff_t>(D);
+
+      std::size_t levels = 0;
+      while (hole > 0)
+      {
+        const diff_t parent = (hole - 1) / d;
+        if (!comp(first[parent], value))
+        {
+          break;
+        }
+        first[hole] = std::move(first[parent]);
+        hole = parent;
+        ++levels;
+      }
+      first[hole] = std::forward<T>(value);
+      note_move(probe, levels + 1);
+      note_sift(probe, levels);
+    }
+
+    template <std::size_t D, class RandomIt, class Compare, class Instrumentation>
+    inline void d_ary_heapify_probed(RandomIt begin, RandomIt end, Compare &comp, Instrumentation *probe)
+    {
+      using diff_t = typename std::iterator_traits<RandomIt>::difference_type;
+      using value_t = typename std::iterator_traits<RandomIt>::value_type;
+
+      const diff_t n = end - begin;
+      if (n < 2)
+      {
+        return;
+      }
+      for (diff_t i = (n - 2) / static_cast<diff_t>(D) + 1; i-- > 0;)
+      {
+        value_t v = std::move(begin[i]);
+        note_move(probe);
+        d_ary_sift_down<D>(begin, n, i, std::move(v), comp, probe);
+      }
+    }
+
+    template <std::size_t D, class RandomIt, class Compare, class Instrumentation>
+    inline void d_ary_push_heap_probed(RandomIt begin, RandomIt end, Compare &comp, Instrumentation *probe)
+    {
+      using value_t = typename std::iterator_traits<RandomIt>::value_type;
+
+      const auto n = end - begin;
+      if (n < 2)
+      {
+        return;
+      }
+      value_t v = std::move(begin[n - 1]);
+      note_move(probe);
+      d_ary_sift_up<D>(begin, n - 1, std::move(v), comp, probe);
+    }
+
+    template <std::size_t D, class RandomIt, class Compare, class Instrumentation>
+    inline void d_ary_pop_heap_probed(RandomIt begin, RandomIt end, Compare &comp, Instrumentation *probe)
+    {
+      using value_t = typename std::iterator_traits<RandomIt>::value_type;
+
+      const auto n = end - begin;
+      if (n < 2)
+      {
+        return;
+      }
+      value_t v = std::move(begin[n - 1]);
+      begin[n - 1] = std::move(begin[0]);
+      note_move(probe, 2);
+      d_ary_sift_down<D>(begin, n - 1, 0, std::move(v), comp, probe);
+    }
+  } // namespace detail
+
+  /**
+   * @brief Build a D-ary heap from [begin, end) (Floyd's bottom-up construction).
+   *
+   * Complexity: O(n).
+   */
+  template <std::size_t D, class RandomIt, class Compare = std::less<>>
+  inline void d_ary_heapify(RandomIt begin, RandomIt end, Compare comp = Compare{})
+  {
+    static_assert(D >= 2, "heap_utils: d-ary heap arity must be at least 2");
+    detail::d_ary_heapify_probed<D>(begin, end, comp, static_cast<no_instrumentation *>(nullptr));
+  }
+
+  /**
+   * @brief Restore the D-ary heap property after appending *(end - 1).
+   *
+   * Equivalent of std::push_heap for a D-ary heap.
+   */
+  template <std::size_t D, class RandomIt, class Compare = std::less<>>
+  inline void d_ary_push_heap(RandomIt begin, RandomIt end, Compare comp = Compare{})
+  {
+    static_assert(D >= 2, "heap_utils: d-ary heap arity must be at least 2");
+    detail::d_ary_push_heap_probed<D>(begin, end, comp, static_cast<no_instrumentation *>(nullptr));
+  }
+
+  /**
+   * @brief Move the top of a D-ary heap to *(end - 1) and re-heap [begin, end - 1).
+   *
+   * Equivalent of std::pop_heap for a D-ary heap.
+   */
+  template <std::size_t D, class RandomIt, class Compare = std::less<>>
+  inline void d_ary_pop_heap(RandomIt begin, RandomIt end, Compare comp = Compare{})
+  {
+    static_assert(D >= 2, "heap_utils: d-ary heap arity must be at least 2");
+    detail::d_ary_pop_heap_probed<D>(begin, end, comp, static_cast<no_instrumentation *>(nullptr));
+  }
+
+  /**
+   * @brief Check if [begin, end) satisfies the D-ary heap property.
+   */
+  template <std::size_t D, class RandomIt, class Compare = std::less<>>
+  inline bool d_ary_is_heap(RandomIt begin, RandomIt end, Compare comp = Compare{})
+  {
+    static_assert(D >= 2, "heap_utils: d-ary heap arity must be at least 2");
+    using diff_t = typename std::iterator_traits<RandomIt>::difference_type;
+
+    const diff_t n = end - begin;
+    for (diff_t i = 1; i < n; ++i)
+    {
+      if (comp(begin[(i - 1) / static_cast<diff_t>(D)], begin[i]))
+      {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  /**
+   * @brief Push a value into a D-ary heap (vector-style).
+   *
+   * Accepts the same heap containers as heap_push().
+   */
+  template <std::size_t D, class Container, class Compare = std::less<>,
+            std::enable_if_t<detail::is_heap_container_v<Container>, int> = 0>
+  inline void d_ary_heap_push(Container &data, const typename Container::value_type &value,
+                              Compare comp = Compare{})
+  {
+    data.push_back(value);
+    d_ary_push_heap<D>(std::begin(data), std::end(data), comp);
+  }
+
+  /**
+   * @brief Push a value into a D-ary heap (move).
+   */
+  template <std::size_t D, class Container, class Compare = std::less<>,
+            std::enable_if_t<detail::is_heap_container_v<Container>, int> = 0>
+  inline void d_ary_heap_push(Container &data, typename Container::value_type &&value,
+                              Compare comp = Compare{})
+  {
+    data.push_back(std::move(value));
+    d_ary_push_heap<D>(std::begin(data), std::end(data), comp);
+  }
+
+  /**
+   * @brief Pop the top element of a D-ary heap and return it.
+   * @throws std::runtime_error if the heap is empty.
+   */
+  template <std::size_t D, class Container, class Compare = std::less<>,
+            std::enable_if_t<detail::is_heap_container_v<Container>, int> = 0>
+  inline typename Container::value_type d_ary_heap_pop(Container &data, Compare comp = Compare{})
+  {
+    if (std::empty(data))
+    {
+      throw std::runtime_error("heap_utils: d_ary_heap_pop() on empty heap");
+    }
+
+    d_ary_pop_heap<D>(std::begin(data), std::end(data), comp);
+    typename Container::value_type out = std::move(data.back());
+    data.pop_back();
+    return out;
+  }
+
+  /**
+   * @brief Merge the D-ary heap `b` into the D-ary heap `a`, leaving `b` empty.
+   *
+   * D-ary counterpart of heap_merge(): with equal allocators the larger
+   * array is kept as the base and the smaller one is sifted up element by
+   * element; the result is rebuilt only when unequal allocators keep a much
+   * smaller `a` as the base (see heap_push_range_should_rebuild()).
+   */
+  template <std::size_t D, class T, class Allocator, class Compare = std::less<>>
+  inline void d_ary_heap_merge(std::vector<T, Allocator> &a, std::vector<T, Allocator> &&b,
+                               Compare comp = Compare{})
+  {
+    if (&a == &b)
+    {
+      return;
+    }
+    if (a.size() < b.size() && a.get_allocator() == b.get_allocator())
+    {
+      a.swap(b);
+    }
+    const std::size_t old_size = a.size();
+    a.reserve(old_size + b.size());
+    for (T &x : b)
+    {
+      a.push_back(std::move(x));
+    }
+    b.clear();
+
+    if (heap_push_range_should_rebuild(old_size, a.size() - old_size))
+    {
+      d_ary_heapify<D>(a.begin(), a.end(), comp);
+      return;
+    }
+    for (auto it = a.begin() + static_cast<std::ptrdiff_t>(old_size); it != a.end();)
+    {
+      ++it;
+      d_ary_push_heap<D>(a.begin(), it, comp);
+    }
+  }
+
+  /**
+   * @brief Priority queue backed by a D-ary heap stored in a std::vector.
+   *
+   * With an enabled `Instrumentation` policy (e.g. counting_instrumentation,
+   * see instrumentation.hpp) every comparison, move, sift and size change is
+   * reported to the policy instance owned by the heap, readable through
+   * instrumentation(). Comparisons then always take the scalar path. The
+   * default policy adds no state and no work.
+   *
+   * @tparam T Element type.
+   * @tparam D Arity (number of children per node), at least 2.
+   * @tparam Compare Heap comparator (default: max-heap via std::less<>).
+   * @tparam Allocator Allocator of the underlying vector (e.g. std::pmr::polymorphic_allocator).
+   * @tparam Instrumentation Instrumentation policy (default: no_instrumentation).
+   */
+  template <class T, std::size_t D = 4, class Compare = std::less<>, class Allocator = std::allocator<T>,
+            class Instrumentation = no_instrumentation>
+  class d_ary_heap : private Instrumentation
+  {
+    static_assert(D >= 2, "heap_utils: d-ary heap arity must be at least 2");
+
+  public:
+    using value_type = T;
+    using size_type = std::size_t;
+    using value_compare = Compare;
+    using allocator_type = Allocator;
+    using container_type = std::vector<T, Allocator>;
+    using instrumentation_type = Instrumentation;
+
+    static constexpr std::size_t arity = D;
+
+    d_ary_heap() = default;
+
+    explicit d_ary_heap(Compare comp, const Allocator &alloc = Allocator())
+        : comp_(comp), data_(alloc)
+    {
+    }
+
+    explicit d_ary_heap(const Allocator &alloc) : data_(alloc) {}
+
+    /**
+     * @brief Take ownership of `data` and heapify it in O(n).
+     */
+    explicit d_ary_heap(container_type data, Compare comp = Compare{})
+        : comp_(comp), data_(std::move(data))
+    {
+      rebuild();
+    }
+
+    void push(const T &value)
+    {
+      data_.push_back(value);
+      sift_up_back();
+    }
+
+    void push(T &&value)
+    {
+      data_.push_back(std::move(value));
+      sift_up_back();
+    }
+
+    template <class... Args>
+    void emplace(Args &&...args)
+    {
+      data_.emplace_back(std::forward<Args>(args)...);
+      sift_up_back();
+    }
+
+    /**
+     * @brief Return the top element.
+     * @throws std::runtime_error if the heap is empty.
+     */
+    const T &top() const
+    {
+      if (data_.empty())
+      {
+        throw std::runtime_error("heap_utils: d_ary_heap::top() on empty heap");
+      }
+      return data_.front();
+    }
+
+    /**
+     * @brief Remove the top element and return it.
+     * @throws std::runtime_error if the heap is empty.
+     */
+    T pop()
+    {
+      if (data_.empty())
+      {
+        throw std::runtime_error("heap_utils: d_ary_heap::pop() on empty heap");
+      }
+      with_comp([&](auto &comp)
+                { detail::d_ary_pop_heap_probed<D>(data_.begin(), data_.end(), comp, probe()); });
+      if constexpr (Instrumentation::enabled)
+      {
+        probe()->on_pop();
+      }
+      T out = std::move(data_.back());
+      data_.pop_back();
+      return out;
+    }
+
+    /**
+     * @brief Move all elements of `other` into this heap (see d_ary_heap_merge()).
+     */
+    void merge(d_ary_heap &&other)
+    {
+      with_comp([&](auto &comp)
+                { d_ary_heap_merge<D>(data_, std::move(other.data_), comp); });
+      if constexpr (Instrumentation::enabled)
+      {
+        probe()->on_size(data_.size());
+      }
+    }
+
+    /**
+     * @brief Replace the contents with `data`, heapified in O(n).
+     */
+    void heapify(container_type data)
+    {
+      data_ = std::move(data);
+      rebuild();
+    }
+
+    bool empty() const noexcept { return data_.empty(); }
+    size_type size() const noexcept { return data_.size(); }
+
+    void reserve(size_type n) { data_.reserve(n); }
+    void clear() noexcept { data_.clear(); }
+
+    /**
+     * @brief Read-only view of the underlying array in heap order.
+     */
+    const container_type &container() const noexcept { return data_; }
+
+    /**
+     * @brief Move the underlying array out, leaving the heap empty.
+     */
+    container_type release() noexcept
+    {
+      container_type out = std::move(data_);
+      data_.clear();
+      return out;
+    }
+
+    const Compare &value_comp() const noexcept { return comp_; }
+
+    allocator_type get_allocator() const noexcept { return data_.get_allocator(); }
+
+    /**
+     * @brief The policy instance, e.g. `heap.instrumentation().stats()`.
+     */
+    const Instrumentation &instrumentation() const noexcept { return *this; }
+    Instrumentation &instrumentation() noexcept { return *this; }
+
+  private:
+    Instrumentation *probe() noexcept { return this; }
+
+    /// Call `f` with the comparator, wrapped when the policy is enabled.
+    template <class F>
+    void with_comp(F &&f)
+    {
+      if constexpr (Instrumentation::enabled)
+      {
+        instrumented_compare<Compare, Instrumentation> comp{comp_, probe()};
+        f(comp);
+      }
+      else
+      {
+        f(comp_);
+      }
+    }
+
+    void sift_up_back()
+    {
+      if constexpr (Instrumentation::enabled)
+      {
+        probe()->on_push();
+        probe()->on_size(data_.size());
+      }
+      with_comp([&](auto &comp)
+                { detail::d_ary_push_heap_probed<D>(data_.begin(), data_.end(), comp, probe()); });
+    }
+
+    void rebuild()
+    {
+      if constexpr (Instrumentation::enabled)
+      {
+        probe()->on_size(data_.size());
+      }
+      with_comp([&](auto &comp)
+                { detail::d_ary_heapify_probed<D>(data_.begin(), data_.end(), comp, probe()); });
+    }
+
+    Compare comp_{};
+    container_type data_;
+  };
+
+} // namespace heap_utils
+
+#endif // HEAP_UTILS_D_ARY_HEAP_HPP
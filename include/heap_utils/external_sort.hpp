@@ -0,0 +1,563 @@
+/**
+ * @file external_sort.hpp
+ * @brief External-memory sort and top-k with a memory budget in bytes.
+ *
+ * `external_sorter<T>` sorts inputs larger than memory:
+ *
+ * 1. Run formation by replacement selection: a heap of as many elements as
+ *    fit in the budget emits its minimum into the current run and takes the
+ *    next input in its place (heap_replace_top). Inputs smaller than the last
+ *    emitted element are tagged for the next run. Runs average twice the
+ *    heap size on random input, and a sorted input yields a single run.
+ * 2. Merge: runs are read back through buffered readers and merged with the
+ *    loser_tree from k_way_merge.hpp, in several passes if there are more
+ *    runs than the budget can buffer at once.
+ *
+ * Nothing touches the disk while the input fits in the budget: the heap is
+ * then drained straight into the output.
+ *
+ * `external_top_k()` keeps the k best elements in a bounded_top_k when they
+ * fit in the budget, and otherwise streams the first k elements of an
+ * external sort.
+ *
+ * Elements are spilled as raw bytes, so T must be trivially copyable. Run
+ * files are created in a caller-chosen directory (default: the system
+ * temporary directory) and removed as soon as they have been merged.
+ *
+ * Requirements: C++17+
+ */
+
+#ifndef HEAP_UTILS_EXTERNAL_SORT_HPP
+#define HEAP_UTILS_EXTERNAL_SORT_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <functional>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <heap_utils/heap_utils.hpp>
+#include <heap_utils/k_way_merge.hpp>
+
+namespace heap_utils
+{
+  /**
+   * @brief Bytes of read or write buffer per run file during a merge (at least).
+   *
+   * The merge fan-in is memory_budget / external_run_buffer_bytes (minimum 2).
+   */
+  inline constexpr std::size_t external_run_buffer_bytes = 64 * 1024;
+
+  namespace detail
+  {
+    /// Temporary file holding one run; removed on destruction.
+    class run_file
+    {
+    public:
+      explicit run_file(const std::filesystem::path &dir)
+      {
+        static std::atomic<std::uint64_t> counter{0};
+        for (int attempt = 0; attempt < 100 && file_ == nullptr; ++attempt)
+        {
+          path_ = dir / ("heap_utils_run_" + std::to_string(reinterpret_cast<std::uintptr_t>(this)) + "_" +
+                         std::to_string(++counter) + ".tmp");
+          file_ = std::fopen(path_.string().c_str(), "w+bx"); // "x": fail if the name is taken
+        }
+        if (file_ == nullptr)
+        {
+          throw std::runtime_error("heap_utils: external_sorter: cannot create run file in " + dir.string());
+        }
+      }
+
+      run_file(const run_file &) = delete;
+      run_file &operator=(const run_file &) = delete;
+
+      ~run_file()
+      {
+        std::fclose(file_);
+        std::error_code ignored;
+        std::filesystem::remove(path_, ignored);
+      }
+
+      std::FILE *get() const noexcept { return file_; }
+
+    private:
+      std::filesystem::path path_;
+      std::FILE *file_ = nullptr;
+    };
+
+    /// Buffered append of raw elements to a run file.
+    template <class T>
+    class run_writer
+    {
+    public:
+      run_writer(std::FILE *f, std::size_t buffer_elems) : file_(f) { buf_.reserve(buffer_elems); }
+
+      void push(const T &value)
+      {
+        buf_.push_back(value);
+        if (buf_.size() == buf_.capacity())
+        {
+          flush();
+        }
+      }
+
+      void flush()
+      {
+        if (!buf_.empty() && std::fwrite(buf_.data(), sizeof(T), buf_.size(), file_) != buf_.size())
+        {
+          throw std::runtime_error("heap_utils: external_sorter: write to run file failed");
+        }
+        buf_.clear();
+      }
+
+    private:
+      std::FILE *file_;
+      std::vector<T> buf_;
+    };
+
+    /// Output iterator over a run_writer.
+    template <class T>
+    class run_output
+    {
+    public:
+      using iterator_category = std::output_iterator_tag;
+      using value_type = void;
+      using difference_type = std::ptrdiff_t;
+      using pointer = void;
+      using reference = void;
+
+      explicit run_output(run_writer<T> &w) noexcept : w_(&w) {}
+
+      run_output &operator=(const T &value)
+      {
+        w_->push(value);
+        return *this;
+      }
+      run_output &operator*() noexcept { return *this; }
+      run_output &operator++() noexcept { return *this; }
+      run_output &operator++(int) noexcept { return *this; }
+
+    private:
+      run_writer<T> *w_;
+    };
+  } // namespace detail
+
+  /**
+   * @brief Buffered sequential reader of raw T values from a file.
+   *
+   * begin() / end() are input iterators, so a reader can be passed straight
+   * to external_sort() or external_top_k() to process a binary file of T.
+   * The reader does not own the FILE.
+   */
+  template <class T>
+  class binary_file_reader
+  {
+    static_assert(std::is_trivially_copyable_v<T>, "heap_utils: binary_file_reader requires a trivially copyable T");
+
+  public:
+    class iterator
+    {
+    public:
+      using iterator_category = std::input_iterator_tag;
+      using value_type = T;
+      using difference_type = std::ptrdiff_t;
+      using pointer = const T *;
+      using reference = const T &;
+
+      iterator() = default;
+      explicit iterator(binary_file_reader *r) noexcept : r_(r) {}
+
+      reference operator*() const noexcept { return r_->current(); }
+      pointer operator->() const noexcept { return &r_->current(); }
+
+      iterator &operator++()
+      {
+        r_->advance();
+        return *this;
+      }
+
+      /// Post-increment: the returned iterator is for comparison only.
+      iterator operator++(int)
+      {
+        iterator old = *this;
+        ++*this;
+        return old;
+      }
+
+      friend bool operator==(const iterator &a, const iterator &b) noexcept { return a.at_end() == b.at_end(); }
+      friend bool operator!=(const iterator &a, const iterator &b) noexcept { return !(a == b); }
+
+    private:
+      bool at_end() const noexcept { return r_ == nullptr || r_->done(); }
+
+      binary_file_reader *r_ = nullptr;
+    };
+
+    /**
+     * @param f File positioned at the first element.
+     * @param buffer_bytes Read buffer size (at least one element).
+     */
+    explicit binary_file_reader(std::FILE *f, std::size_t buffer_bytes = external_run_buffer_bytes)
+        : file_(f), buf_((buffer_bytes / sizeof(T) > 0) ? buffer_bytes / sizeof(T) : 1)
+    {
+      refill();
+    }
+
+    binary_file_reader(const binary_file_reader &) = delete;
+    binary_file_reader &operator=(const binary_file_reader &) = delete;
+
+    /// Iterators refer to this reader, which must outlive them.
+    iterator begin() noexcept { return iterator(this); }
+    iterator end() noexcept { return iterator(); }
+
+    bool done() const noexcept { return pos_ == len_; }
+
+  private:
+    const T &current() const noexcept { return buf_[pos_]; }
+
+    void advance()
+    {
+      if (++pos_ == len_)
+      {
+        refill();
+      }
+    }
+
+    void refill()
+    {
+      len_ = std::fread(buf_.data(), sizeof(T), buf_.size(), file_);
+      pos_ = 0;
+      if (len_ == 0 && std::ferror(file_))
+      {
+        throw std::runtime_error("heap_utils: binary_file_reader: read failed");
+      }
+    }
+
+    std::FILE *file_;
+    std::vector<T> buf_;
+    std::size_t pos_ = 0;
+    std::size_t len_ = 0;
+  };
+
+  /**
+   * @brief Sort a stream larger than memory (ascending by `comp`, as std::sort).
+   *
+   * push() the input (one element or one chunk at a time), then call
+   * finish() once to write the sorted sequence. The budget bounds the
+   * selection heap during run formation and the read buffers during the
+   * merge; each open run writer adds external_run_buffer_bytes.
+   *
+   * The sort is not stable.
+   *
+   * @tparam T Trivially copyable element type.
+   * @tparam Compare Strict weak ordering.
+   */
+  template <class T, class Compare = std::less<>>
+  class external_sorter
+  {
+    static_assert(std::is_trivially_copyable_v<T>, "heap_utils: external_sorter requires a trivially copyable T");
+
+  public:
+    using value_type = T;
+
+    /**
+     * @param memory_budget Bytes available for buffered elements.
+     * @param comp Ordering of the output.
+     * @param temp_dir Directory for run files (default: std::filesystem::temp_directory_path()).
+     */
+    explicit external_sorter(std::size_t memory_budget, Compare comp = Compare{},
+                             std::filesystem::path temp_dir = {})
+        : comp_(comp), budget_(memory_budget), dir_(std::move(temp_dir))
+    {
+      const std::size_t fit = memory_budget / sizeof(entry);
+      capacity_ = (fit > 0) ? fit : 1;
+    }
+
+    external_sorter(const external_sorter &) = delete;
+    external_sorter &operator=(const external_sorter &) = delete;
+
+    void push(const T &value)
+    {
+      if (heap_.size() < capacity_)
+      {
+        if (heap_.capacity() == 0)
+        {
+          // Allocate the budgeted heap once instead of letting push_back overshoot it.
+          heap_.reserve(capacity_);
+        }
+        heap_push(heap_, entry{run_, value}, later());
+        return;
+      }
+      // Full: emit the minimum, then admit `value` to this run or the next.
+      const entry &top = heap_.front();
+      emit(top);
+      const std::uint64_t run = comp_(value, top.value) ? run_ + 1 : run_;
+      heap_replace_top(heap_, entry{run, value}, later());
+      if (heap_.front().run != run_)
+      {
+        start_next_run();
+      }
+    }
+
+    template <class InputIt>
+    void push(InputIt first, InputIt last)
+    {
+      for (; first != last; ++first)
+      {
+        push(*first);
+      }
+    }
+
+    /**
+     * @brief Write the first `limit` elements of the sorted input to `out`.
+     *
+     * Must be called at most once. Run files are removed before returning.
+     *
+     * @return Output iterator past the last element written.
+     */
+    template <class OutputIt>
+    OutputIt finish(OutputIt out, std::size_t limit = std::numeric_limits<std::size_t>::max())
+    {
+      if (runs_.empty() && writer_ == nullptr)
+      {
+        // Everything fit in the budget: drain the heap directly.
+        for (; limit > 0 && !heap_.empty(); --limit)
+        {
+          *out = heap_pop(heap_, later()).value;
+          ++out;
+        }
+        heap_ = std::vector<entry>();
+        return out;
+      }
+
+      while (!heap_.empty())
+      {
+        const entry e = heap_pop(heap_, later());
+        if (e.run != run_)
+        {
+          start_next_run();
+        }
+        emit(e);
+      }
+      heap_ = std::vector<entry>();
+      close_run();
+      return merge(out, limit);
+    }
+
+    /// Runs written to disk so far (0 if the input fit in the budget).
+    std::size_t spilled_runs() const noexcept { return spilled_; }
+
+    /// Intermediate merge passes performed by finish() (0 for a single final merge).
+    std::size_t merge_passes() const noexcept { return passes_; }
+
+    /// Elements held by the selection heap.
+    std::size_t heap_capacity() const noexcept { return capacity_; }
+
+    /// Elements the selection heap has allocated room for (at most heap_capacity()).
+    std::size_t heap_allocated() const noexcept { return heap_.capacity(); }
+
+  private:
+    struct entry
+    {
+      std::uint64_t run;
+      T value;
+    };
+
+    /// Heap order: the top is the smallest value of the lowest run.
+    struct later_entry
+    {
+      Compare comp;
+      bool operator()(const entry &a, const entry &b) const
+      {
+        if (a.run != b.run)
+        {
+          return a.run > b.run;
+        }
+        return comp(b.value, a.value);
+      }
+    };
+
+    later_entry later() const { return later_entry{comp_}; }
+
+    std::filesystem::path dir() const { return dir_.empty() ? std::filesystem::temp_directory_path() : dir_; }
+
+    static std::size_t buffer_elems(std::size_t bytes) noexcept
+    {
+      return (bytes / sizeof(T) > 0) ? bytes / sizeof(T) : 1;
+    }
+
+    void emit(const entry &e)
+    {
+      if (writer_ == nullptr)
+      {
+        runs_.push_back(std::make_unique<detail::run_file>(dir()));
+        writer_ = std::make_unique<detail::run_writer<T>>(runs_.back()->get(),
+                                                          buffer_elems(external_run_buffer_bytes));
+        ++spilled_;
+      }
+      writer_->push(e.value);
+    }
+
+    void close_run()
+    {
+      if (writer_ != nullptr)
+      {
+        writer_->flush();
+        writer_.reset();
+      }
+    }
+
+    void start_next_run()
+    {
+      close_run();
+      ++run_;
+    }
+
+    /// Merge `files` into `out` (at most `limit` elements); the files are rewound first.
+    template <class OutputIt>
+    OutputIt merge_files(const std::vector<std::unique_ptr<detail::run_file>> &files, OutputIt out,
+                         std::size_t limit)
+    {
+      const std::size_t per_run = budget_ / files.size();
+      const std::size_t buffer_bytes = (per_run > external_run_buffer_bytes) ? per_run : external_run_buffer_bytes;
+
+      std::vector<std::unique_ptr<binary_file_reader<T>>> readers;
+      std::vector<std::pair<typename binary_file_reader<T>::iterator, typename binary_file_reader<T>::iterator>>
+          cursors;
+      for (const auto &f : files)
+      {
+        std::rewind(f->get());
+        readers.push_back(std::make_unique<binary_file_reader<T>>(f->get(), buffer_bytes));
+        cursors.emplace_back(readers.back()->begin(), readers.back()->end());
+      }
+
+      loser_tree<typename binary_file_reader<T>::iterator, Compare> tree(std::move(cursors), comp_);
+      for (; limit > 0 && !tree.empty(); --limit)
+      {
+        *out = tree.take_top();
+        ++out;
+        tree.advance();
+      }
+      return out;
+    }
+
+    template <class OutputIt>
+    OutputIt merge(OutputIt out, std::size_t limit)
+    {
+      const std::size_t by_budget = budget_ / external_run_buffer_bytes;
+      const std::size_t fan_in = (by_budget > 2) ? by_budget : 2;
+
+      while (runs_.size() > fan_in)
+      {
+        // Merge groups of fan_in runs into longer runs until one final merge remains.
+        std::vector<std::unique_ptr<detail::run_file>> next;
+        for (std::size_t i = 0; i < runs_.size(); i += fan_in)
+        {
+          const std::size_t end = (i + fan_in < runs_.size()) ? i + fan_in : runs_.size();
+          std::vector<std::unique_ptr<detail::run_file>> group;
+          for (std::size_t j = i; j < end; ++j)
+          {
+            group.push_back(std::move(runs_[j]));
+          }
+          if (group.size() == 1)
+          {
+            next.push_back(std::move(group.front()));
+            continue;
+          }
+          next.push_back(std::make_unique<detail::run_file>(dir()));
+          detail::run_writer<T> w(next.back()->get(), buffer_elems(external_run_buffer_bytes));
+          merge_files(group, detail::run_output<T>(w), std::numeric_limits<std::size_t>::max());
+          w.flush();
+        }
+        runs_ = std::move(next);
+        ++passes_;
+      }
+
+      out = merge_files(runs_, out, limit);
+      runs_.clear();
+      return out;
+    }
+
+    Compare comp_;
+    std::size_t budget_;
+    std::filesystem::path dir_;
+    std::size_t capacity_ = 1;
+    std::vector<entry> heap_;
+    std::uint64_t run_ = 0;
+    std::vector<std::unique_ptr<detail::run_file>> runs_;
+    std::unique_ptr<detail::run_writer<T>> writer_;
+    std::size_t spilled_ = 0;
+    std::size_t passes_ = 0;
+  };
+
+  /**
+   * @brief Sort [first, last) into `out` (ascending by `comp`) within `memory_budget` bytes.
+   *
+   * @return Output iterator past the last element written.
+   */
+  template <class InputIt, class OutputIt, class Compare = std::less<>>
+  inline OutputIt external_sort(InputIt first, InputIt last, OutputIt out, std::size_t memory_budget,
+                                Compare comp = Compare{}, std::filesystem::path temp_dir = {})
+  {
+    using value_t = typename std::iterator_traits<InputIt>::value_type;
+    external_sorter<value_t, Compare> sorter(memory_budget, comp, std::move(temp_dir));
+    sorter.push(first, last);
+    return sorter.finish(out);
+  }
+
+  /**
+   * @brief Write the k "best" elements of [first, last) to `out`, best first.
+   *
+   * Same order as top_k(): greatest according to `comp` first. When k
+   * elements fit in `memory_budget` bytes they are kept in a bounded_top_k
+   * and nothing is spilled; otherwise the input goes through an
+   * external_sorter and only its first k elements are merged.
+   *
+   * @return Output iterator past the last element written.
+   */
+  template <class InputIt, class OutputIt, class Compare = std::less<>>
+  inline OutputIt external_top_k(InputIt first, InputIt last, std::size_t k, OutputIt out, std::size_t memory_budget,
+                                 Compare comp = Compare{}, std::filesystem::path temp_dir = {})
+  {
+    using value_t = typename std::iterator_traits<InputIt>::value_type;
+    if (k == 0)
+    {
+      return out;
+    }
+    if (k <= memory_budget / sizeof(value_t))
+    {
+      // Exactly k: growing by doubling from the constructor's small
+      // reservation could allocate up to twice the budget.
+      bounded_top_k<value_t, Compare> acc(k, comp);
+      acc.reserve(k);
+      for (; first != last; ++first)
+      {
+        acc.push(*first);
+      }
+      for (value_t &v : acc.take_sorted())
+      {
+        *out = std::move(v);
+        ++out;
+      }
+      return out;
+    }
+
+    external_sorter<value_t, detail::reverse_compare<Compare>> sorter(
+        memory_budget, detail::reverse_compare<Compare>{comp}, std::move(temp_dir));
+    sorter.push(first, last);
+    return sorter.finish(out, k);
+  }
+
+} // namespace heap_utils
+
+#endif // HEAP_UTILS_EXTERNAL_SORT_HPP
@@ -11,6 +11,12 @@
  * - minimal API surface
  * - header-only, zero dependencies
  *
+ * Compile time: in C++20 the helpers are constexpr (HEAP_UTILS_CONSTEXPR),
+ * and the vector-based ones are too where std::vector is constexpr
+ * (HEAP_UTILS_CONSTEXPR_VECTOR). top_k<K>(std::array) needs no allocation,
+ * so its result can initialize a constexpr table. Errors that throw at
+ * runtime (e.g. heap_pop() on an empty heap) fail the constant evaluation.
+ *
  * Requirements: C++17+
  */
 
@@ -18,22 +24,248 @@
 #define HEAP_UTILS_HEAP_UTILS_HPP
 
 #include <algorithm>
+#include <array>
+#include <cassert>
 #include <cstddef>
 #include <functional>
+#include <iterator>
+#include <memory>
+#include <optional>
 #include <stdexcept>
 #include <type_traits>
 #include <utility>
 #include <vector>
 
+#if __has_include(<version>)
+#include <version>
+#endif
+
+#include <heap_utils/instrumentation.hpp>
+
+/// `constexpr` where the std heap algorithms are (C++20), plain `inline` before.
+#if defined(__cpp_lib_constexpr_algorithms) && __cpp_lib_constexpr_algorithms >= 201806L
+#define HEAP_UTILS_CONSTEXPR constexpr
+#define HEAP_UTILS_HAS_CONSTEXPR_ALGORITHMS 1
+#else
+#define HEAP_UTILS_CONSTEXPR inline
+#endif
+
+/// `constexpr` where std::vector is as well (C++20 transient allocation).
+#if defined(HEAP_UTILS_HAS_CONSTEXPR_ALGORITHMS) && defined(__cpp_lib_constexpr_vector) && \
+    __cpp_lib_constexpr_vector >= 201907L
+#define HEAP_UTILS_CONSTEXPR_VECTOR constexpr
+#define HEAP_UTILS_HAS_CONSTEXPR_VECTOR 1
+#else
+#define HEAP_UTILS_CONSTEXPR_VECTOR inline
+#endif
+
 namespace heap_utils
 {
+  namespace detail
+  {
+    /**
+     * @brief Comparator adaptor that swaps the arguments of `Compare`.
+     *
+     * A heap ordered by reverse_compare<Compare> keeps the *worst* element
+     * (according to `Compare`) at the top.
+     */
+    template <class Compare>
+    struct reverse_compare
+    {
+      Compare comp;
+
+      template <class A, class B>
+      constexpr bool operator()(const A &a, const B &b) const
+      {
+        return comp(b, a);
+      }
+    };
+
+    /// Elements reserved up front by the k-bounded accumulators; a larger k
+    /// (possibly far beyond the input size) grows the heap on demand.
+    inline constexpr std::size_t top_k_initial_reserve = 1024;
+
+    template <class C, class = void>
+    struct is_heap_container : std::false_type
+    {
+    };
+
+    template <class C>
+    struct is_heap_container<
+        C, std::void_t<typename C::value_type,
+                       decltype(std::declval<C &>().push_back(std::declval<typename C::value_type>())),
+                       decltype(std::declval<C &>().pop_back()),
+                       decltype(std::declval<C &>().back())>>
+        : std::is_base_of<std::random_access_iterator_tag,
+                          typename std::iterator_traits<decltype(std::begin(std::declval<C &>()))>::iterator_category>
+    {
+    };
+
+    /// Container usable by heap_push / heap_pop: random access + push_back / pop_back / back.
+    template <class C>
+    inline constexpr bool is_heap_container_v = is_heap_container<C>::value;
+
+    template <class Range>
+    using range_value_t =
+        typename std::iterator_traits<decltype(std::begin(std::declval<Range &>()))>::value_type;
+
+    /**
+     * @brief Fill the hole at `top` of the binary heap [first, first + n) with `value`.
+     *
+     * Bottom-up sift: the hole is walked down to a leaf along the better
+     * children (one comparison per level), then `value` is sifted back up,
+     * no higher than `top`. New values usually belong near the leaves, so
+     * this averages about log2(n) + O(1) comparisons. Same steps as the
+     * std::make_heap / std::pop_heap of libstdc++.
+     *
+     * `probe` (see instrumentation.hpp) is told about every move and the
+     * depth below `top` that `value` ends at; the default policy compiles
+     * this out.
+     */
+    template <class RandomIt, class T, class Compare, class Instrumentation = no_instrumentation>
+    HEAP_UTILS_CONSTEXPR void adjust_heap(RandomIt first, typename std::iterator_traits<RandomIt>::difference_type n,
+                                          typename std::iterator_traits<RandomIt>::difference_type top, T &&value,
+                                          Compare &comp, Instrumentation *probe = nullptr)
+    {
+      using diff_t = typename std::iterator_traits<RandomIt>::difference_type;
+
+      std::size_t moves = 1;
+      std::size_t depth = 0;
+      diff_t hole = top;
+      diff_t child = 2 * top + 2;
+      while (child < n)
+      {
+        if (comp(first[child], first[child - 1]))
+        {
+          --child;
+        }
+        first[hole] = std::move(first[child]);
+        hole = child;
+        child = 2 * child + 2;
+        ++moves;
+        ++depth;
+      }
+      if (child == n)
+      {
+        first[hole] = std::move(first[child - 1]);
+        hole = child - 1;
+        ++moves;
+        ++depth;
+      }
+      while (hole > top)
+      {
+        const diff_t parent = (hole - 1) / 2;
+        if (!comp(first[parent], value))
+        {
+          break;
+        }
+        first[hole] = std::move(first[parent]);
+        hole = parent;
+        ++moves;
+        --depth;
+      }
+      first[hole] = std::forward<T>(value);
+      note_move(probe, moves);
+      note_sift(probe, depth);
+    }
+
+    /**
+     * @brief Overwrite the top of the binary heap [first, first + n) with `value` (n > 0).
+     *
+     * adjust_heap() from the root.
+     */
+    template <class RandomIt, class T, class Compare, class Instrumentation = no_instrumentation>
+    HEAP_UTILS_CONSTEXPR void replace_top(RandomIt first, typename std::iterator_traits<RandomIt>::difference_type n,
+                                          T &&value, Compare &comp, Instrumentation *probe = nullptr)
+    {
+      adjust_heap(first, n, 0, std::forward<T>(value), comp, probe);
+    }
+
+    /// An element tagged with its position in the input.
+    template <class T>
+    struct indexed_value
+    {
+      T value;
+      std::size_t index;
+    };
+
+    /**
+     * @brief Total order "a ranks below b": by `Compare`, ties broken by input position.
+     *
+     * Among equivalent values the earlier one ranks higher, so a heap
+     * ordered by stable_order<Compare> is deterministic.
+     */
+    template <class Compare>
+    struct stable_order
+    {
+      Compare comp;
+
+      template <class T>
+      constexpr bool operator()(const indexed_value<T> &a, const indexed_value<T> &b) const
+      {
+        if (comp(a.value, b.value))
+        {
+          return true;
+        }
+        return !comp(b.value, a.value) && a.index > b.index;
+      }
+    };
+
+    /// Moves the values of tagged elements into a plain vector.
+    template <class T>
+    HEAP_UTILS_CONSTEXPR_VECTOR std::vector<T> strip_indices(std::vector<indexed_value<T>> &items)
+    {
+      std::vector<T> out;
+      out.reserve(items.size());
+      for (indexed_value<T> &item : items)
+      {
+        out.push_back(std::move(item.value));
+      }
+      return out;
+    }
+
+    /// Binary-heap sift-up of `value` into `hole`, reporting moves and levels to `probe`.
+    template <class RandomIt, class T, class Compare, class Instrumentation>
+    inline void probed_sift_up(RandomIt first, std::ptrdiff_t hole, T &&value, Compare &comp, Instrumentation *probe)
+    {
+      std::size_t levels = 0;
+      while (hole > 0)
+      {
+        const std::ptrdiff_t parent = (hole - 1) / 2;
+        if (!comp(first[parent], value))
+        {
+          break;
+        }
+        first[hole] = std::move(first[parent]);
+        hole = parent;
+        ++levels;
+      }
+      first[hole] = std::forward<T>(value);
+      note_move(probe, levels + 1);
+      note_sift(probe, levels);
+    }
+
+    /// Floyd heap construction through adjust_heap(), reporting to `probe`.
+    template <class RandomIt, class Compare, class Instrumentation>
+    inline void probed_heapify(RandomIt first, std::ptrdiff_t n, Compare &comp, Instrumentation *probe)
+    {
+      using value_t = typename std::iterator_traits<RandomIt>::value_type;
+      for (std::ptrdiff_t i = n / 2; i-- > 0;)
+      {
+        value_t v = std::move(first[i]);
+        note_move(probe);
+        adjust_heap(first, n, i, std::move(v), comp, probe);
+      }
+    }
+  } // namespace detail
+
   /**
    * @brief Build a heap from a container range [begin, end).
    *
    * Equivalent to std::make_heap(begin, end, comp).
    */
   template <class RandomIt, class Compare = std::less<>>
-  inline void heapify(RandomIt begin, RandomIt end, Compare comp = Compare{})
+  HEAP_UTILS_CONSTEXPR void heapify(RandomIt begin, RandomIt end, Compare comp = Compare{})
   {
     std::make_heap(begin, end, comp);
   }
@@ -42,39 +274,50 @@ namespace heap_utils
    * @brief Push a value into a heap (vector-style).
    *
    * This helper appends `value` to `data` and restores the heap property.
+   * `data` can be any heap container: random-access iterators plus
+   * push_back / pop_back / back (std::vector, std::pmr::vector,
+   * boost::small_vector, static_vector, ...).
    *
-   * @tparam T Element type.
+   * @tparam Container Heap container type.
    * @tparam Compare Comparator used by the heap (default: max-heap via std::less<>).
    */
-  template <class T, class Compare = std::less<>>
-  inline void heap_push(std::vector<T> &data, const T &value, Compare comp = Compare{})
+  template <class Container, class Compare = std::less<>,
+            std::enable_if_t<detail::is_heap_container_v<Container>, int> = 0>
+  HEAP_UTILS_CONSTEXPR void heap_push(Container &data, const typename Container::value_type &value,
+                        Compare comp = Compare{})
   {
     data.push_back(value);
-    std::push_heap(data.begin(), data.end(), comp);
+    std::push_heap(std::begin(data), std::end(data), comp);
   }
 
   /**
    * @brief Push a value into a heap (move).
    */
-  template <class T, class Compare = std::less<>>
-  inline void heap_push(std::vector<T> &data, T &&value, Compare comp = Compare{})
+  template <class Container, class Compare = std::less<>,
+            std::enable_if_t<detail::is_heap_container_v<Container>, int> = 0>
+  HEAP_UTILS_CONSTEXPR void heap_push(Container &data, typename Container::value_type &&value,
+                        Compare comp = Compare{})
   {
     data.push_back(std::move(value));
-    std::push_heap(data.begin(), data.end(), comp);
+    std::push_heap(std::begin(data), std::end(data), comp);
   }
 
   /**
    * @brief Return the top element of a heap.
+   *
+   * Works on any non-owning or owning range (including std::span over
+   * externally managed memory): only std::empty and std::begin are used.
+   *
    * @throws std::runtime_error if the heap is empty.
    */
-  template <class T>
-  inline const T &heap_top(const std::vector<T> &data)
+  template <class Range>
+  HEAP_UTILS_CONSTEXPR auto heap_top(const Range &data) -> decltype(*std::begin(data))
   {
-    if (data.empty())
+    if (std::empty(data))
     {
       throw std::runtime_error("heap_utils: heap_top() on empty heap");
     }
-    return data.front();
+    return *std::begin(data);
   }
 
   /**
@@ -84,46 +327,701 @@ namespace heap_utils
    *
    * @throws std::runtime_error if the heap is empty.
    */
-  template <class T, class Compare = std::less<>>
-  inline T heap_pop(std::vector<T> &data, Compare comp = Compare{})
+  template <class Container, class Compare = std::less<>,
+            std::enable_if_t<detail::is_heap_container_v<Container>, int> = 0>
+  HEAP_UTILS_CONSTEXPR typename Container::value_type heap_pop(Container &data, Compare comp = Compare{})
   {
-    if (data.empty())
+    if (std::empty(data))
     {
       throw std::runtime_error("heap_utils: heap_pop() on empty heap");
     }
 
-    std::pop_heap(data.begin(), data.end(), comp);
-    T out = std::move(data.back());
+    std::pop_heap(std::begin(data), std::end(data), comp);
+    typename Container::value_type out = std::move(data.back());
+    data.pop_back();
+    return out;
+  }
+
+  /**
+   * @brief Return the top element of a non-empty heap (no check in release builds).
+   *
+   * Empty input is caught by an assert() only. Never throws, so it can be
+   * used with -fno-exceptions.
+   */
+  template <class Range>
+  HEAP_UTILS_CONSTEXPR auto heap_top_unchecked(const Range &data) noexcept -> decltype(*std::begin(data))
+  {
+    assert(!std::empty(data) && "heap_utils: heap_top_unchecked() on empty heap");
+    return *std::begin(data);
+  }
+
+  /**
+   * @brief Pop the top element of a non-empty heap (no check in release builds).
+   *
+   * Same as heap_pop() with the empty check reduced to an assert(). Never
+   * throws by itself (only element moves and the comparator can), so it can
+   * be used with -fno-exceptions.
+   */
+  template <class Container, class Compare = std::less<>,
+            std::enable_if_t<detail::is_heap_container_v<Container>, int> = 0>
+  HEAP_UTILS_CONSTEXPR typename Container::value_type heap_pop_unchecked(Container &data, Compare comp = Compare{})
+  {
+    assert(!std::empty(data) && "heap_utils: heap_pop_unchecked() on empty heap");
+    std::pop_heap(std::begin(data), std::end(data), comp);
+    typename Container::value_type out = std::move(data.back());
+    data.pop_back();
+    return out;
+  }
+
+  /**
+   * @brief Pop the top element if there is one.
+   *
+   * @return The former top, or std::nullopt if the heap is empty.
+   */
+  template <class Container, class Compare = std::less<>,
+            std::enable_if_t<detail::is_heap_container_v<Container>, int> = 0>
+  HEAP_UTILS_CONSTEXPR std::optional<typename Container::value_type> try_heap_pop(Container &data, Compare comp = Compare{})
+  {
+    if (std::empty(data))
+    {
+      return std::nullopt;
+    }
+    std::pop_heap(std::begin(data), std::end(data), comp);
+    std::optional<typename Container::value_type> out(std::move(data.back()));
+    data.pop_back();
+    return out;
+  }
+
+  /**
+   * @brief Pop the top element into caller storage if there is one.
+   *
+   * Move-assigns into `out`, so a long-lived slot (e.g. an order object
+   * with reserved buffers) is reused instead of constructing a new value.
+   *
+   * @return false (and `out` untouched) if the heap is empty.
+   */
+  template <class Container, class Compare = std::less<>,
+            std::enable_if_t<detail::is_heap_container_v<Container>, int> = 0>
+  HEAP_UTILS_CONSTEXPR bool heap_pop_into(Container &data, typename Container::value_type &out, Compare comp = Compare{})
+  {
+    if (std::empty(data))
+    {
+      return false;
+    }
+    std::pop_heap(std::begin(data), std::end(data), comp);
+    out = std::move(data.back());
     data.pop_back();
+    return true;
+  }
+
+  /**
+   * @brief Replace the top element of a heap with `value` and return the old top.
+   *
+   * Same result as heap_pop() followed by heap_push() (Python's
+   * heapq.heapreplace), but done with a single in-place sift: no
+   * pop_back / push_back and one move per level instead of two passes.
+   * Works on any random-access range, including std::span.
+   *
+   * @throws std::runtime_error if the heap is empty.
+   */
+  template <class Range, class Compare = std::less<>>
+  HEAP_UTILS_CONSTEXPR detail::range_value_t<Range> heap_replace_top(Range &data, detail::range_value_t<Range> value,
+                                                       Compare comp = Compare{})
+  {
+    if (std::empty(data))
+    {
+      throw std::runtime_error("heap_utils: heap_replace_top() on empty heap");
+    }
+    const auto first = std::begin(data);
+    detail::range_value_t<Range> out = std::move(*first);
+    detail::replace_top(first, std::end(data) - first, std::move(value), comp);
+    return out;
+  }
+
+  /**
+   * @brief Push `value`, then pop and return the top element.
+   *
+   * Same result as heap_push() followed by heap_pop() (Python's
+   * heapq.heappushpop). If `value` would be the new top (or the heap is
+   * empty) it is returned right away and the heap is untouched; otherwise
+   * it replaces the top with a single in-place sift.
+   */
+  template <class Range, class Compare = std::less<>>
+  HEAP_UTILS_CONSTEXPR detail::range_value_t<Range> heap_pushpop(Range &data, detail::range_value_t<Range> value,
+                                                   Compare comp = Compare{})
+  {
+    const auto first = std::begin(data);
+    const auto n = std::end(data) - first;
+    if (n == 0 || !comp(value, *first))
+    {
+      return value;
+    }
+    detail::range_value_t<Range> out = std::move(*first);
+    detail::replace_top(first, n, std::move(value), comp);
+    return out;
+  }
+
+  /**
+   * @brief Batch size above which heap_push_range() rebuilds instead of sifting up.
+   *
+   * Appending m elements to a heap of n costs m sift-ups (O(1) each on
+   * average for random keys, O(log n) worst case), or one O(n + m) rebuild.
+   * Measured with bench/bench_batch.cpp, the rebuild only wins once the batch
+   * is at least about twice the size of the existing heap.
+   */
+  constexpr bool heap_push_range_should_rebuild(std::size_t heap_size, std::size_t batch_size) noexcept
+  {
+    return batch_size >= 64 && batch_size >= 2 * heap_size;
+  }
+
+  /**
+   * @brief Push every element of [first, last) into a heap.
+   *
+   * Elements are appended first; the heap property is then restored either
+   * by one sift-up per new element or by a single Floyd rebuild of the whole
+   * container, whichever is cheaper for the batch size
+   * (see heap_push_range_should_rebuild()).
+   *
+   * Complexity: O(min(m log(n + m), n + m)) for m new elements.
+   */
+  template <class Container, class InputIt, class Compare = std::less<>,
+            std::enable_if_t<detail::is_heap_container_v<Container>, int> = 0>
+  HEAP_UTILS_CONSTEXPR void heap_push_range(Container &data, InputIt first, InputIt last, Compare comp = Compare{})
+  {
+    const auto old_size = static_cast<std::size_t>(std::size(data));
+    for (; first != last; ++first)
+    {
+      data.push_back(*first);
+    }
+
+    const auto begin = std::begin(data);
+    const auto end = std::end(data);
+    const auto new_size = static_cast<std::size_t>(end - begin);
+
+    if (heap_push_range_should_rebuild(old_size, new_size - old_size))
+    {
+      std::make_heap(begin, end, comp);
+      return;
+    }
+    for (auto it = begin + static_cast<std::ptrdiff_t>(old_size); it != end;)
+    {
+      ++it;
+      std::push_heap(begin, it, comp);
+    }
+  }
+
+  /**
+   * @brief Pop up to `n` top elements into `out`, best first.
+   *
+   * Equivalent to calling heap_pop() min(n, size) times, without the
+   * per-call empty check: the pops are performed in place, then the popped
+   * tail is moved out and trimmed.
+   *
+   * @return Output iterator past the last written element.
+   */
+  template <class Container, class OutputIt, class Compare = std::less<>,
+            std::enable_if_t<detail::is_heap_container_v<Container>, int> = 0>
+  HEAP_UTILS_CONSTEXPR OutputIt heap_pop_n(Container &data, std::size_t n, OutputIt out, Compare comp = Compare{})
+  {
+    const auto begin = std::begin(data);
+    auto end = std::end(data);
+    const auto size = static_cast<std::size_t>(end - begin);
+    const std::size_t count = (n < size) ? n : size;
+
+    for (std::size_t i = 0; i < count; ++i, --end)
+    {
+      std::pop_heap(begin, end, comp);
+    }
+    for (std::size_t i = 0; i < count; ++i)
+    {
+      *out = std::move(data.back());
+      ++out;
+      data.pop_back();
+    }
     return out;
   }
 
+  /**
+   * @brief Merge the heap `b` into the heap `a`, leaving `b` empty.
+   *
+   * When the allocators compare equal, the larger of the two arrays is kept
+   * as the base (its storage is taken over) and the smaller one is sifted up
+   * element by element: the batch is then never more than the base, well
+   * below the 2x break-even of heap_push_range_should_rebuild(), and
+   * bench/bench_batch.cpp shows the sift-ups ahead of a rebuild even for
+   * equal sizes. Only when unequal allocators keep `a` as the base and `b`
+   * is at least twice its size is the result rebuilt with one make_heap.
+   *
+   * Complexity: O(m log(n + m)) with m = min(|a|, |b|) for equal allocators,
+   * otherwise as heap_push_range(); O(1) extra work when `b` is empty.
+   */
+  template <class T, class Allocator, class Compare = std::less<>>
+  HEAP_UTILS_CONSTEXPR_VECTOR void heap_merge(std::vector<T, Allocator> &a, std::vector<T, Allocator> &&b, Compare comp = Compare{})
+  {
+    if (&a == &b)
+    {
+      return;
+    }
+    if (a.size() < b.size() && a.get_allocator() == b.get_allocator())
+    {
+      a.swap(b);
+    }
+    // Sizes after the swap decide between sift-up and rebuild.
+    a.reserve(a.size() + b.size());
+    heap_push_range(a, std::make_move_iterator(b.begin()), std::make_move_iterator(b.end()), comp);
+    b.clear();
+  }
+
   /**
    * @brief Check if the container currently satisfies the heap property.
    */
   template <class RandomIt, class Compare = std::less<>>
-  inline bool is_heap(RandomIt begin, RandomIt end, Compare comp = Compare{})
+  HEAP_UTILS_CONSTEXPR bool is_heap(RandomIt begin, RandomIt end, Compare comp = Compare{})
   {
     return std::is_heap(begin, end, comp);
   }
 
   /**
-   * @brief Extract the k "best" elements according to a comparator.
+   * @brief Streaming accumulator that keeps the k "best" elements seen so far.
    *
-   * With the default comparator (std::less<>), this returns the k largest elements.
-   * The result is sorted in descending order (best first for the chosen comparator).
+   * Internally this is a k-sized heap ordered by the reversed comparator, so
+   * the worst retained element sits at the top and can be evicted in O(log k).
+   * "Best" has the same meaning as in top_k(): with std::less<> the largest
+   * elements are kept, with std::greater<> the smallest.
+   *
+   * Complexity: O(log k) per push, O(k) memory.
+   *
+   * With an enabled `Instrumentation` policy (see instrumentation.hpp) the
+   * accumulator reports comparisons, moves, sift depths, retained pushes,
+   * evictions (as pops) and the size high-water mark to the policy instance
+   * it owns, readable through instrumentation(). The default policy adds no
+   * state and no work.
+   *
+   * @tparam T Element type.
+   * @tparam Compare Heap comparator (same semantics as top_k()).
+   * @tparam Instrumentation Instrumentation policy (default: no_instrumentation).
+   */
+  template <class T, class Compare = std::less<>, class Instrumentation = no_instrumentation>
+  class bounded_top_k : private Instrumentation
+  {
+  public:
+    HEAP_UTILS_CONSTEXPR_VECTOR explicit bounded_top_k(std::size_t k, Compare comp = Compare{})
+        : k_(k), comp_{comp}
+    {
+      heap_.reserve((k < detail::top_k_initial_reserve) ? k : detail::top_k_initial_reserve);
+    }
+
+    /**
+     * @brief Pre-allocate room for min(n, capacity()) elements.
+     *
+     * The constructor only reserves a small prefix, so an oversized k
+     * (e.g. SIZE_MAX for "keep everything") costs nothing up front.
+     */
+    HEAP_UTILS_CONSTEXPR_VECTOR void reserve(std::size_t n) { heap_.reserve((n < k_) ? n : k_); }
+
+    /**
+     * @brief Offer a value to the accumulator (copy).
+     * @return true if the value was retained.
+     */
+    HEAP_UTILS_CONSTEXPR_VECTOR bool push(const T &value)
+    {
+      if constexpr (Instrumentation::enabled)
+      {
+        return push_probed(value);
+      }
+      if (heap_.size() < k_)
+      {
+        heap_.push_back(value);
+        std::push_heap(heap_.begin(), heap_.end(), comp_);
+        return true;
+      }
+      if (k_ == 0 || !comp_.comp(heap_.front(), value))
+      {
+        return false;
+      }
+      detail::replace_top(heap_.begin(), static_cast<std::ptrdiff_t>(heap_.size()), value, comp_);
+      return true;
+    }
+
+    /**
+     * @brief Offer a value to the accumulator (move).
+     * @return true if the value was retained.
+     */
+    HEAP_UTILS_CONSTEXPR_VECTOR bool push(T &&value)
+    {
+      if constexpr (Instrumentation::enabled)
+      {
+        return push_probed(std::move(value));
+      }
+      if (heap_.size() < k_)
+      {
+        heap_.push_back(std::move(value));
+        std::push_heap(heap_.begin(), heap_.end(), comp_);
+        return true;
+      }
+      if (k_ == 0 || !comp_.comp(heap_.front(), value))
+      {
+        return false;
+      }
+      detail::replace_top(heap_.begin(), static_cast<std::ptrdiff_t>(heap_.size()), std::move(value), comp_);
+      return true;
+    }
+
+    /**
+     * @brief Return the worst retained element (the next one to be evicted).
+     * @throws std::runtime_error if nothing has been retained yet.
+     */
+    HEAP_UTILS_CONSTEXPR_VECTOR const T &worst() const
+    {
+      if (heap_.empty())
+      {
+        throw std::runtime_error("heap_utils: bounded_top_k::worst() on empty accumulator");
+      }
+      return heap_.front();
+    }
+
+    HEAP_UTILS_CONSTEXPR_VECTOR std::size_t size() const noexcept { return heap_.size(); }
+    HEAP_UTILS_CONSTEXPR_VECTOR std::size_t capacity() const noexcept { return k_; }
+    HEAP_UTILS_CONSTEXPR_VECTOR bool empty() const noexcept { return heap_.empty(); }
+    HEAP_UTILS_CONSTEXPR_VECTOR bool full() const noexcept { return heap_.size() >= k_; }
+
+    HEAP_UTILS_CONSTEXPR_VECTOR void clear() noexcept { heap_.clear(); }
+
+    /**
+     * @brief Move the retained elements out, best first.
+     *
+     * The accumulator is left empty and can be reused.
+     */
+    HEAP_UTILS_CONSTEXPR_VECTOR std::vector<T> take_sorted()
+    {
+      // sort_heap with the reversed comparator yields best-first order.
+      if constexpr (Instrumentation::enabled)
+      {
+        auto comp = probed_comp();
+        std::sort_heap(heap_.begin(), heap_.end(), comp);
+      }
+      else
+      {
+        std::sort_heap(heap_.begin(), heap_.end(), comp_);
+      }
+      std::vector<T> out = std::move(heap_);
+      heap_.clear();
+      return out;
+    }
+
+    /**
+     * @brief The policy instance, e.g. `acc.instrumentation().stats()`.
+     */
+    const Instrumentation &instrumentation() const noexcept { return *this; }
+    Instrumentation &instrumentation() noexcept { return *this; }
+
+  private:
+    Instrumentation *probe() noexcept { return this; }
+
+    detail::reverse_compare<instrumented_compare<Compare, Instrumentation>> probed_comp() noexcept
+    {
+      return {{comp_.comp, probe()}};
+    }
+
+    template <class U>
+    bool push_probed(U &&value)
+    {
+      auto comp = probed_comp();
+      if (heap_.size() < k_)
+      {
+        heap_.push_back(std::forward<U>(value));
+        probe()->on_push();
+        probe()->on_size(heap_.size());
+        T v = std::move(heap_.back());
+        detail::note_move(probe());
+        detail::probed_sift_up(heap_.begin(), static_cast<std::ptrdiff_t>(heap_.size()) - 1, std::move(v), comp,
+                               probe());
+        return true;
+      }
+      if (k_ == 0 || !comp.comp(heap_.front(), value))
+      {
+        return false;
+      }
+      // The worst element is evicted through the same replace_top() as push().
+      probe()->on_pop();
+      probe()->on_push();
+      detail::replace_top(heap_.begin(), static_cast<std::ptrdiff_t>(heap_.size()), std::forward<U>(value), comp,
+                          probe());
+      return true;
+    }
+
+    std::size_t k_;
+    detail::reverse_compare<Compare> comp_;
+    std::vector<T> heap_;
+  };
+
+  /**
+   * @brief Extract the k "best" elements of [first, last) without copying the input.
+   *
+   * Streams the range through a bounded_top_k, so only k elements are ever
+   * stored. Output order matches the vector overload of top_k() (best first).
    *
    * Notes:
-   * - If k >= data.size(), returns all elements sorted accordingly.
-   * - Complexity: O(n + k log n) due to heapify + k pops.
+   * - Works with single-pass input iterators.
+   * - Complexity: O(n log k) time, O(k) memory.
    *
-   * @param data Input vector (copied internally).
+   * @param first Beginning of the input range.
+   * @param last End of the input range.
    * @param k Number of elements to extract.
    * @param comp Heap comparator (same semantics as std::make_heap).
    * @return Vector of extracted elements (best first).
    */
+  template <class InputIt, class Compare = std::less<>>
+  HEAP_UTILS_CONSTEXPR_VECTOR std::vector<typename std::iterator_traits<InputIt>::value_type>
+  top_k(InputIt first, InputIt last, std::size_t k, Compare comp = Compare{})
+  {
+    using T = typename std::iterator_traits<InputIt>::value_type;
+
+    if (k == 0 || first == last)
+    {
+      return {};
+    }
+
+    bounded_top_k<T, Compare> acc(k, comp);
+    if constexpr (std::is_base_of_v<std::random_access_iterator_tag,
+                                    typename std::iterator_traits<InputIt>::iterator_category>)
+    {
+      acc.reserve(static_cast<std::size_t>(std::distance(first, last)));
+    }
+    for (; first != last; ++first)
+    {
+      acc.push(*first);
+    }
+    return acc.take_sorted();
+  }
+
+  /**
+   * @brief Minimal priority queue over the helpers above (std heap algorithms).
+   *
+   * Offers the same push / top / pop surface as d_ary_heap, pairing_heap and
+   * radix_heap, so the std-heap path can be swapped in as a template
+   * parameter and compared against the other engines.
+   *
+   * With an enabled `Instrumentation` policy (see instrumentation.hpp) every
+   * comparison, move, sift and size change is reported to the policy
+   * instance owned by the heap, as in d_ary_heap; the heap then sifts with
+   * its own (layout-identical) binary sift loops instead of the std ones.
+   *
+   * @tparam T Element type.
+   * @tparam Compare Heap comparator (default: max-heap via std::less<>).
+   * @tparam Allocator Allocator of the underlying vector (e.g. std::pmr::polymorphic_allocator).
+   * @tparam Instrumentation Instrumentation policy (default: no_instrumentation).
+   */
+  template <class T, class Compare = std::less<>, class Allocator = std::allocator<T>,
+            class Instrumentation = no_instrumentation>
+  class binary_heap : private Instrumentation
+  {
+  public:
+    using value_type = T;
+    using size_type = std::size_t;
+    using value_compare = Compare;
+    using allocator_type = Allocator;
+    using container_type = std::vector<T, Allocator>;
+    using instrumentation_type = Instrumentation;
+
+    binary_heap() = default;
+
+    explicit binary_heap(Compare comp, const Allocator &alloc = Allocator())
+        : comp_(comp), data_(alloc)
+    {
+    }
+
+    explicit binary_heap(const Allocator &alloc) : data_(alloc) {}
+
+    /**
+     * @brief Take ownership of `data` and heapify it in O(n).
+     */
+    explicit binary_heap(container_type data, Compare comp = Compare{})
+        : comp_(comp), data_(std::move(data))
+    {
+      if constexpr (Instrumentation::enabled)
+      {
+        probe()->on_size(data_.size());
+        auto probed = probed_comp();
+        detail::probed_heapify(data_.begin(), static_cast<std::ptrdiff_t>(data_.size()), probed, probe());
+      }
+      else
+      {
+        heapify(data_.begin(), data_.end(), comp_);
+      }
+    }
+
+    void push(const T &value)
+    {
+      data_.push_back(value);
+      sift_up_back();
+    }
+
+    void push(T &&value)
+    {
+      data_.push_back(std::move(value));
+      sift_up_back();
+    }
+
+    /**
+     * @brief Return the top element.
+     * @throws std::runtime_error if the heap is empty.
+     */
+    const T &top() const { return heap_top(data_); }
+
+    /**
+     * @brief Remove the top element and return it.
+     * @throws std::runtime_error if the heap is empty.
+     */
+    T pop()
+    {
+      if (data_.empty())
+      {
+        throw std::runtime_error("heap_utils: heap_pop() on empty heap");
+      }
+      if constexpr (Instrumentation::enabled)
+      {
+        probe()->on_pop();
+      }
+      // Bottom-up, as std::pop_heap; the same code runs with or without a probe.
+      T out = std::move(data_.front());
+      detail::note_move(probe());
+      const auto n = static_cast<std::ptrdiff_t>(data_.size()) - 1;
+      if (n > 0)
+      {
+        T v = std::move(data_.back());
+        data_.pop_back();
+        detail::note_move(probe());
+        auto probed = probed_comp();
+        detail::replace_top(data_.begin(), n, std::move(v), probed, probe());
+      }
+      else
+      {
+        data_.pop_back();
+      }
+      return out;
+    }
+
+    /**
+     * @brief Move all elements of `other` into this heap (see heap_merge()).
+     */
+    void merge(binary_heap &&other)
+    {
+      if constexpr (Instrumentation::enabled)
+      {
+        heap_merge(data_, std::move(other.data_), probed_comp());
+        probe()->on_size(data_.size());
+      }
+      else
+      {
+        heap_merge(data_, std::move(other.data_), comp_);
+      }
+    }
+
+    bool empty() const noexcept { return data_.empty(); }
+    size_type size() const noexcept { return data_.size(); }
+
+    void reserve(size_type n) { data_.reserve(n); }
+    void clear() noexcept { data_.clear(); }
+
+    /**
+     * @brief Read-only view of the underlying array in heap order.
+     */
+    const container_type &container() const noexcept { return data_; }
+
+    const Compare &value_comp() const noexcept { return comp_; }
+
+    allocator_type get_allocator() const noexcept { return data_.get_allocator(); }
+
+    /**
+     * @brief The policy instance, e.g. `heap.instrumentation().stats()`.
+     */
+    const Instrumentation &instrumentation() const noexcept { return *this; }
+    Instrumentation &instrumentation() noexcept { return *this; }
+
+  private:
+    Instrumentation *probe() noexcept { return this; }
+
+    instrumented_compare<Compare, Instrumentation> probed_comp() noexcept { return {comp_, probe()}; }
+
+    void sift_up_back()
+    {
+      if constexpr (Instrumentation::enabled)
+      {
+        probe()->on_push();
+        probe()->on_size(data_.size());
+        T v = std::move(data_.back());
+        detail::note_move(probe());
+        auto probed = probed_comp();
+        detail::probed_sift_up(data_.begin(), static_cast<std::ptrdiff_t>(data_.size()) - 1, std::move(v), probed,
+                               probe());
+      }
+      else
+      {
+        std::push_heap(data_.begin(), data_.end(), comp_);
+      }
+    }
+
+    Compare comp_{};
+    container_type data_;
+  };
+
+  /**
+   * @brief Algorithm used by top_k() to extract the k best elements.
+   */
+  enum class top_k_strategy
+  {
+    /// Pick one of the strategies below from n, k and sizeof(T).
+    automatic,
+    /// heapify the whole input, then k pops: O(n + k log n).
+    heap_pop,
+    /// Stream through a k-sized bounded_top_k: O(n log k), O(k) extra memory.
+    bounded_heap,
+    /// Introselect the k best (std::nth_element), then sort them: O(n + k log k).
+    selection
+  };
+
+  /**
+   * @brief Strategy chosen by top_k_strategy::automatic for a given problem size.
+   *
+   * Crossovers were measured with bench/bench_top_k.cpp:
+   * - the bounded heap wins while k is a small fraction of n, since most
+   *   elements are rejected by one comparison against the current worst;
+   *   large elements widen that window because selection moves every element;
+   * - selection wins for larger k, where k successive pops over an n-sized
+   *   heap are dominated by cache misses.
+   *
+   * On random input the crossover sits near k = n/100 for elements up to
+   * 64 bytes and near k = n/50 above that. heap_pop was never the fastest
+   * and is only used when requested explicitly.
+   *
+   * @param n Number of input elements.
+   * @param k Number of requested elements.
+   * @param element_size sizeof(T).
+   */
+  constexpr top_k_strategy choose_top_k_strategy(std::size_t n, std::size_t k,
+                                                 std::size_t element_size) noexcept
+  {
+    if (k >= n)
+    {
+      return top_k_strategy::selection;
+    }
+    const std::size_t ratio = (element_size > 64) ? 64 : 128;
+    if (k <= 8 || k <= n / ratio)
+    {
+      return top_k_strategy::bounded_heap;
+    }
+    return top_k_strategy::selection;
+  }
+
+  /**
+   * @brief top_k() using heapify + k pops, without per-pop checks.
+   *
+   * Popped elements accumulate at the back of `data` and are moved out in
+   * best-first order at the end.
+   */
   template <class T, class Compare = std::less<>>
-  inline std::vector<T> top_k(std::vector<T> data, std::size_t k, Compare comp = Compare{})
+  HEAP_UTILS_CONSTEXPR_VECTOR std::vector<T> top_k_heap_pop(std::vector<T> data, std::size_t k, Compare comp = Compare{})
   {
     if (k == 0 || data.empty())
     {
@@ -135,15 +1033,101 @@ namespace heap_utils
     const std::size_t n = data.size();
     const std::size_t kk = (k > n) ? n : k;
 
+    auto end = data.end();
+    for (std::size_t i = 0; i < kk; ++i, --end)
+    {
+      std::pop_heap(data.begin(), end, comp);
+    }
+
     std::vector<T> out;
     out.reserve(kk);
+    for (auto it = data.end(); it != end;)
+    {
+      --it;
+      out.push_back(std::move(*it));
+    }
+    return out;
+  }
 
-    for (std::size_t i = 0; i < kk; ++i)
+  /**
+   * @brief top_k() using selection: std::nth_element, then sort the k winners.
+   *
+   * Complexity: O(n + k log k) on average.
+   */
+  template <class T, class Compare = std::less<>>
+  HEAP_UTILS_CONSTEXPR_VECTOR std::vector<T> top_k_select(std::vector<T> data, std::size_t k, Compare comp = Compare{})
+  {
+    if (k == 0 || data.empty())
     {
-      out.push_back(heap_pop(data, comp));
+      return {};
     }
 
-    return out;
+    const detail::reverse_compare<Compare> better{comp};
+    if (k < data.size())
+    {
+      std::nth_element(data.begin(), data.begin() + static_cast<std::ptrdiff_t>(k - 1),
+                       data.end(), better);
+      data.resize(k);
+    }
+    std::sort(data.begin(), data.end(), better);
+    return data;
+  }
+
+  /**
+   * @brief Extract the k "best" elements according to a comparator.
+   *
+   * With the default comparator (std::less<>), this returns the k largest elements.
+   * The result is sorted in descending order (best first for the chosen comparator).
+   *
+   * Notes:
+   * - If k >= data.size(), returns all elements sorted accordingly.
+   * - Order among equivalent elements is unspecified and may differ between
+   *   strategies; see top_k_stable() and top_k_with_ties() for deterministic
+   *   tie handling.
+   * - Complexity depends on `strategy`, see top_k_strategy.
+   *
+   * @param data Input vector (copied internally).
+   * @param k Number of elements to extract.
+   * @param comp Heap comparator (same semantics as std::make_heap).
+   * @param strategy Extraction algorithm (default: chosen from n, k and sizeof(T)).
+   * @return Vector of extracted elements (best first).
+   */
+  template <class T, class Compare>
+  HEAP_UTILS_CONSTEXPR_VECTOR std::vector<T> top_k(std::vector<T> data, std::size_t k, Compare comp,
+                              top_k_strategy strategy)
+  {
+    if (k == 0 || data.empty())
+    {
+      return {};
+    }
+
+    if (strategy == top_k_strategy::automatic)
+    {
+      strategy = choose_top_k_strategy(data.size(), k, sizeof(T));
+    }
+
+    switch (strategy)
+    {
+    case top_k_strategy::heap_pop:
+      return top_k_heap_pop(std::move(data), k, comp);
+    case top_k_strategy::bounded_heap:
+      return top_k(std::make_move_iterator(data.begin()), std::make_move_iterator(data.end()), k, comp);
+    case top_k_strategy::selection:
+    case top_k_strategy::automatic:
+      break;
+    }
+    return top_k_select(std::move(data), k, comp);
+  }
+
+  /**
+   * @brief Extract the k "best" elements, choosing the strategy automatically.
+   *
+   * Equivalent to top_k(data, k, comp, top_k_strategy::automatic).
+   */
+  template <class T, class Compare = std::less<>>
+  HEAP_UTILS_CONSTEXPR_VECTOR std::vector<T> top_k(std::vector<T> data, std::size_t k, Compare comp = Compare{})
+  {
+    return top_k(std::move(data), k, comp, top_k_strategy::automatic);
   }
 
   /**
@@ -152,7 +1136,7 @@ namespace heap_utils
    * Equivalent to top_k(data, k, std::less<>()).
    */
   template <class T>
-  inline std::vector<T> largest_k(std::vector<T> data, std::size_t k)
+  HEAP_UTILS_CONSTEXPR_VECTOR std::vector<T> largest_k(std::vector<T> data, std::size_t k)
   {
     return top_k(std::move(data), k, std::less<>{});
   }
@@ -163,12 +1147,191 @@ namespace heap_utils
    * Uses a min-heap comparator (std::greater<>), then returns results in ascending order.
    */
   template <class T>
-  inline std::vector<T> smallest_k(std::vector<T> data, std::size_t k)
+  HEAP_UTILS_CONSTEXPR_VECTOR std::vector<T> smallest_k(std::vector<T> data, std::size_t k)
   {
     // With std::greater<>, pop returns the smallest first (best).
     return top_k(std::move(data), k, std::greater<>{});
   }
 
+  /**
+   * @brief top_k() with a deterministic order: ties go to the earliest input element.
+   *
+   * Returns the k best elements of [first, last), best first; equivalent
+   * elements keep their input order, and when equivalent elements compete
+   * for the last places the earliest ones win. Single pass, O(k) extra
+   * memory: every later element equivalent to the current worst is rejected
+   * with one comparison, so long runs of duplicates cost no heap work.
+   *
+   * Complexity: O(n log k) time, O(k) memory.
+   */
+  template <class InputIt, class Compare = std::less<>>
+  HEAP_UTILS_CONSTEXPR_VECTOR std::vector<typename std::iterator_traits<InputIt>::value_type>
+  top_k_stable(InputIt first, InputIt last, std::size_t k, Compare comp = Compare{})
+  {
+    using T = typename std::iterator_traits<InputIt>::value_type;
+    using item = detail::indexed_value<T>;
+
+    if (k == 0 || first == last)
+    {
+      return {};
+    }
+
+    bounded_top_k<item, detail::stable_order<Compare>> acc(k, detail::stable_order<Compare>{comp});
+    if constexpr (std::is_base_of_v<std::random_access_iterator_tag,
+                                    typename std::iterator_traits<InputIt>::iterator_category>)
+    {
+      acc.reserve(static_cast<std::size_t>(std::distance(first, last)));
+    }
+    for (std::size_t index = 0; first != last; ++first, ++index)
+    {
+      auto &&x = *first;
+      // Later than everything retained: only a strictly better value gets in.
+      if (acc.full() && !comp(acc.worst().value, x))
+      {
+        continue;
+      }
+      acc.push(item{std::forward<decltype(x)>(x), index});
+    }
+    std::vector<item> items = acc.take_sorted();
+    return detail::strip_indices(items);
+  }
+
+  /**
+   * @brief top_k_stable() over a vector.
+   */
+  template <class T, class Compare = std::less<>>
+  HEAP_UTILS_CONSTEXPR_VECTOR std::vector<T> top_k_stable(const std::vector<T> &data, std::size_t k,
+                                                          Compare comp = Compare{})
+  {
+    return top_k_stable(data.begin(), data.end(), k, comp);
+  }
+
+  /**
+   * @brief The k best elements of [first, last) plus every element tied with the k-th.
+   *
+   * The result has at least min(k, n) elements, best first, in the same
+   * order as top_k_stable() (ties by input position). Single pass: next to
+   * the k-sized heap it keeps only the elements equivalent to the current
+   * k-th, which are dropped as soon as a better element raises the bar.
+   *
+   * Complexity: O(n log k + t log t) time and O(k + t) memory for t ties.
+   */
+  template <class InputIt, class Compare = std::less<>>
+  HEAP_UTILS_CONSTEXPR_VECTOR std::vector<typename std::iterator_traits<InputIt>::value_type>
+  top_k_with_ties(InputIt first, InputIt last, std::size_t k, Compare comp = Compare{})
+  {
+    using T = typename std::iterator_traits<InputIt>::value_type;
+    using item = detail::indexed_value<T>;
+
+    if (k == 0 || first == last)
+    {
+      return {};
+    }
+    // Only k known to fit the input is reserved in full.
+    std::size_t initial = (k < detail::top_k_initial_reserve) ? k : detail::top_k_initial_reserve;
+    if constexpr (std::is_base_of_v<std::random_access_iterator_tag,
+                                    typename std::iterator_traits<InputIt>::iterator_category>)
+    {
+      const auto n = static_cast<std::size_t>(std::distance(first, last));
+      k = (k < n) ? k : n;
+      initial = k;
+    }
+
+    // Worst retained element on top.
+    detail::reverse_compare<detail::stable_order<Compare>> worst_on_top{{comp}};
+    std::vector<item> heap;
+    heap.reserve(initial);
+    std::vector<item> ties;
+
+    for (std::size_t index = 0; first != last; ++first, ++index)
+    {
+      auto &&x = *first;
+      if (heap.size() < k)
+      {
+        heap.push_back(item{std::forward<decltype(x)>(x), index});
+        std::push_heap(heap.begin(), heap.end(), worst_on_top);
+      }
+      else if (comp(heap.front().value, x))
+      {
+        item evicted = std::move(heap.front());
+        detail::replace_top(heap.begin(), static_cast<std::ptrdiff_t>(k), item{std::forward<decltype(x)>(x), index},
+                            worst_on_top);
+        if (comp(evicted.value, heap.front().value))
+        {
+          ties.clear();
+        }
+        else
+        {
+          ties.push_back(std::move(evicted));
+        }
+      }
+      else if (!comp(x, heap.front().value))
+      {
+        ties.push_back(item{std::forward<decltype(x)>(x), index});
+      }
+    }
+
+    // Every tie ranks below the retained elements, so the result is the
+    // sorted heap followed by the ties in input order.
+    std::sort_heap(heap.begin(), heap.end(), worst_on_top);
+    std::sort(ties.begin(), ties.end(), [](const item &a, const item &b) { return a.index < b.index; });
+    for (item &t : ties)
+    {
+      heap.push_back(std::move(t));
+    }
+    return detail::strip_indices(heap);
+  }
+
+  /**
+   * @brief top_k_with_ties() over a vector.
+   */
+  template <class T, class Compare = std::less<>>
+  HEAP_UTILS_CONSTEXPR_VECTOR std::vector<T> top_k_with_ties(const std::vector<T> &data, std::size_t k,
+                                                             Compare comp = Compare{})
+  {
+    return top_k_with_ties(data.begin(), data.end(), k, comp);
+  }
+
+  /**
+   * @brief Fixed-size top_k(): the K best elements of an array, best first.
+   *
+   * Same result as the vector overload, computed with a K-sized bounded heap
+   * held in a std::array, so nothing is allocated and the call is a constant
+   * expression in C++20:
+   *
+   * @code
+   * constexpr auto hottest = heap_utils::top_k<3>(std::array{4, 9, 1, 7, 3});   // {9, 7, 4}
+   * @endcode
+   *
+   * @tparam K Number of elements to extract (at most N).
+   * @param comp Heap comparator (same semantics as std::make_heap).
+   */
+  template <std::size_t K, class T, std::size_t N, class Compare = std::less<>>
+  HEAP_UTILS_CONSTEXPR std::array<T, K> top_k(const std::array<T, N> &data, Compare comp = Compare{})
+  {
+    static_assert(K <= N, "heap_utils: top_k<K>() with K larger than the array");
+
+    std::array<T, K> out{};
+    if constexpr (K > 0)
+    {
+      detail::reverse_compare<Compare> worse{comp};
+      for (std::size_t i = 0; i < K; ++i)
+      {
+        out[i] = data[i];
+      }
+      std::make_heap(out.begin(), out.end(), worse);
+      for (std::size_t i = K; i < N; ++i)
+      {
+        if (comp(out[0], data[i]))
+        {
+          detail::replace_top(out.begin(), static_cast<std::ptrdiff_t>(K), data[i], worse);
+        }
+      }
+      std::sort_heap(out.begin(), out.end(), worse);
+    }
+    return out;
+  }
+
 } // namespace heap_utils
 
 #endif // HEAP_UTILS_HEAP_UTILS_HPP
@@ -0,0 +1,361 @@
+/**
+ * @file indexed_heap.hpp
+ * @brief Addressable heap keyed by dense integer IDs (decrease/increase key, erase).
+ *
+ * `indexed_heap` stores { key, id } entries in a D-ary heap and keeps a
+ * position map from id to heap slot, so an element already in the heap can
+ * be re-prioritized or removed in O(log n) instead of being re-pushed and
+ * discarded lazily later (Dijkstra, timers, schedulers).
+ *
+ * IDs are dense non-negative integers; the position map grows to the largest
+ * id seen.
+ *
+ * Requirements: C++17+
+ */
+
+#ifndef HEAP_UTILS_INDEXED_HEAP_HPP
+#define HEAP_UTILS_INDEXED_HEAP_HPP
+
+#include <cstddef>
+#include <functional>
+#include <limits>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include <heap_utils/d_ary_heap.hpp>
+
+namespace heap_utils
+{
+  /**
+   * @brief Addressable priority queue over dense integer IDs.
+   *
+   * Comparator semantics match the standard heap algorithms, but the default
+   * is std::greater<> (min-heap), the usual choice for shortest paths and
+   * timers. decrease_key() / increase_key() follow the min-heap naming:
+   * decrease_key() moves an element towards the top, increase_key() away
+   * from it. update() accepts either direction.
+   *
+   * @tparam Key Priority key.
+   * @tparam Compare Key comparator (default: min-heap via std::greater<>).
+   * @tparam D Arity of the underlying heap.
+   */
+  template <class Key, class Compare = std::greater<>, std::size_t D = 4>
+  class indexed_heap
+  {
+    static_assert(D >= 2, "heap_utils: d-ary heap arity must be at least 2");
+
+  public:
+    using key_type = Key;
+    using id_type = std::size_t;
+    using size_type = std::size_t;
+
+    static constexpr size_type npos = std::numeric_limits<size_type>::max();
+
+    struct entry
+    {
+      Key key;
+      id_type id;
+    };
+
+    indexed_heap() = default;
+
+    /**
+     * @param id_capacity Pre-size the position map for ids in [0, id_capacity).
+     * @param comp Key comparator.
+     */
+    explicit indexed_heap(size_type id_capacity, Compare comp = Compare{})
+        : comp_{comp}, pos_(id_capacity, npos)
+    {
+    }
+
+    /**
+     * @brief Insert `id` with priority `key`.
+     * @throws std::invalid_argument if `id` is already in the heap.
+     * @throws std::length_error if `id` is npos.
+     */
+    void push(id_type id, const Key &key)
+    {
+      if (contains(id))
+      {
+        throw std::invalid_argument("heap_utils: indexed_heap::push() with an id already in the heap");
+      }
+      if (id >= npos)
+      {
+        // id + 1 below would wrap to zero.
+        throw std::length_error("heap_utils: indexed_heap::push() id out of range");
+      }
+      if (id >= pos_.size())
+      {
+        pos_.resize(id + 1, npos);
+      }
+      heap_.push_back(entry{key, id});
+      pos_[id] = heap_.size() - 1;
+      sift_up(heap_.size() - 1);
+    }
+
+    /**
+     * @brief Insert `id`, or change its key if it is already in the heap.
+     */
+    void push_or_update(id_type id, const Key &key)
+    {
+      if (contains(id))
+      {
+        update(id, key);
+      }
+      else
+      {
+        push(id, key);
+      }
+    }
+
+    /**
+     * @brief True if `id` is currently in the heap.
+     */
+    bool contains(id_type id) const noexcept
+    {
+      return id < pos_.size() && pos_[id] != npos;
+    }
+
+    /**
+     * @brief Current key of `id`.
+     * @throws std::out_of_range if `id` is not in the heap.
+     */
+    const Key &key(id_type id) const
+    {
+      return heap_[checked_pos(id, "heap_utils: indexed_heap::key() on missing id")].key;
+    }
+
+    /**
+     * @brief Id of the top element.
+     * @throws std::runtime_error if the heap is empty.
+     */
+    id_type top() const
+    {
+      return top_entry("heap_utils: indexed_heap::top() on empty heap").id;
+    }
+
+    /**
+     * @brief Key of the top element.
+     * @throws std::runtime_error if the heap is empty.
+     */
+    const Key &top_key() const
+    {
+      return top_entry("heap_utils: indexed_heap::top_key() on empty heap").key;
+    }
+
+    /**
+     * @brief Remove the top element and return its id.
+     * @throws std::runtime_error if the heap is empty.
+     */
+    id_type pop()
+    {
+      const id_type id = top_entry("heap_utils: indexed_heap::pop() on empty heap").id;
+      remove_at(0);
+      return id;
+    }
+
+    /**
+     * @brief Move `id` towards the top with a new key.
+     * @throws std::out_of_range if `id` is not in the heap.
+     * @throws std::invalid_argument if `key` would move it away from the top.
+     */
+    void decrease_key(id_type id, const Key &key)
+    {
+      const size_type i = checked_pos(id, "heap_utils: indexed_heap::decrease_key() on missing id");
+      if (comp_(key, heap_[i].key))
+      {
+        throw std::invalid_argument("heap_utils: indexed_heap::decrease_key() would move the key away from the top");
+      }
+      heap_[i].key = key;
+      sift_up(i);
+    }
+
+    /**
+     * @brief Move `id` away from the top with a new key.
+     * @throws std::out_of_range if `id` is not in the heap.
+     * @throws std::invalid_argument if `key` would move it towards the top.
+     */
+    void increase_key(id_type id, const Key &key)
+    {
+      const size_type i = checked_pos(id, "heap_utils: indexed_heap::increase_key() on missing id");
+      if (comp_(heap_[i].key, key))
+      {
+        throw std::invalid_argument("heap_utils: indexed_heap::increase_key() would move the key towards the top");
+      }
+      heap_[i].key = key;
+      sift_down(i);
+    }
+
+    /**
+     * @brief Change the key of `id`, sifting in whichever direction is needed.
+     * @throws std::out_of_range if `id` is not in the heap.
+     */
+    void update(id_type id, const Key &key)
+    {
+      const size_type i = checked_pos(id, "heap_utils: indexed_heap::update() on missing id");
+      const bool up = comp_(heap_[i].key, key);
+      heap_[i].key = key;
+      if (up)
+      {
+        sift_up(i);
+      }
+      else
+      {
+        sift_down(i);
+      }
+    }
+
+    /**
+     * @brief Remove `id` from the heap.
+     * @return false if `id` was not in the heap.
+     */
+    bool erase(id_type id)
+    {
+      if (!contains(id))
+      {
+        return false;
+      }
+      remove_at(pos_[id]);
+      return true;
+    }
+
+    bool empty() const noexcept { return heap_.empty(); }
+    size_type size() const noexcept { return heap_.size(); }
+
+    /**
+     * @brief Pre-size storage for `n` elements with ids in [0, n).
+     */
+    void reserve(size_type n)
+    {
+      heap_.reserve(n);
+      if (n > pos_.size())
+      {
+        pos_.resize(n, npos);
+      }
+    }
+
+    void clear() noexcept
+    {
+      for (const entry &e : heap_)
+      {
+        pos_[e.id] = npos;
+      }
+      heap_.clear();
+    }
+
+    /**
+     * @brief Read-only view of the entry array in heap order.
+     */
+    const std::vector<entry> &entries() const noexcept { return heap_; }
+
+    const Compare &key_comp() const noexcept { return comp_; }
+
+  private:
+    struct entry_compare
+    {
+      const Compare &comp;
+
+      bool operator()(const entry &a, const entry &b) const
+      {
+        return comp(a.key, b.key);
+      }
+    };
+
+    size_type checked_pos(id_type id, const char *what) const
+    {
+      if (!contains(id))
+      {
+        throw std::out_of_range(what);
+      }
+      return pos_[id];
+    }
+
+    const entry &top_entry(const char *what) const
+    {
+      if (heap_.empty())
+      {
+        throw std::runtime_error(what);
+      }
+      return heap_.front();
+    }
+
+    void place(size_type i, entry &&e)
+    {
+      pos_[e.id] = i;
+      heap_[i] = std::move(e);
+    }
+
+    void remove_at(size_type i)
+    {
+      pos_[heap_[i].id] = npos;
+      const size_type last = heap_.size() - 1;
+      if (i != last)
+      {
+        const bool up = comp_(heap_[i].key, heap_[last].key);
+        place(i, std::move(heap_[last]));
+        heap_.pop_back();
+        if (up)
+        {
+          sift_up(i);
+        }
+        else
+        {
+          sift_down(i);
+        }
+        return;
+      }
+      heap_.pop_back();
+    }
+
+    void sift_up(size_type hole)
+    {
+      entry value = std::move(heap_[hole]);
+      while (hole > 0)
+      {
+        const size_type parent = (hole - 1) / D;
+        if (!comp_(heap_[parent].key, value.key))
+        {
+          break;
+        }
+        place(hole, std::move(heap_[parent]));
+        hole = parent;
+      }
+      place(hole, std::move(value));
+    }
+
+    void sift_down(size_type hole)
+    {
+      using diff_t = typename std::vector<entry>::difference_type;
+
+      const size_type n = heap_.size();
+      entry value = std::move(heap_[hole]);
+      entry_compare ecomp{comp_};
+      for (;;)
+      {
+        const size_type child = D * hole + 1;
+        if (child >= n)
+        {
+          break;
+        }
+        const size_type count = (n - child < D) ? (n - child) : D;
+        const auto best = static_cast<size_type>(detail::d_ary_best_child<D>(
+            heap_.begin(), static_cast<diff_t>(child), static_cast<diff_t>(count), ecomp));
+        if (!comp_(value.key, heap_[best].key))
+        {
+          break;
+        }
+        place(hole, std::move(heap_[best]));
+        hole = best;
+      }
+      place(hole, std::move(value));
+    }
+
+    Compare comp_{};
+    std::vector<entry> heap_;
+    std::vector<size_type> pos_;
+  };
+
+} // namespace heap_utils
+
+#endif // HEAP_UTILS_INDEXED_HEAP_HPP
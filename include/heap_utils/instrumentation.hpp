@@ -0,0 +1,186 @@
+/**
+ * @file instrumentation.hpp
+ * @brief Compile-time instrumentation policies for the heap hot paths.
+ *
+ * An instrumentation policy receives a callback for every comparator call,
+ * element move, finished sift and size change performed by a heap. Two
+ * policies are provided:
+ *
+ * - `no_instrumentation` (the default everywhere): `enabled == false`, every
+ *   hook is compiled out, so instrumented code paths are identical to the
+ *   plain ones.
+ * - `counting_instrumentation`: accumulates a `heap_stats` per instance
+ *   (comparisons, moves, pushes, pops, high-water mark and a histogram of
+ *   sift depths) that can be read, exported and reset.
+ *
+ * `d_ary_heap`, `binary_heap` (the std-heap layout behind heap_push /
+ * heap_pop) and `bounded_top_k` (the streaming top_k) take the policy as
+ * their last template parameter and report every counter. The free
+ * functions and the other top_k strategies only see their comparator, so
+ * `instrumented_compare` counts comparator calls through any policy:
+ *
+ * @code
+ * heap_utils::bounded_top_k<int, std::less<>, heap_utils::counting_instrumentation> acc(100);
+ * acc.instrumentation().stats().high_water_mark;
+ *
+ * heap_utils::counting_instrumentation probe;
+ * auto best = heap_utils::top_k(data, 100, heap_utils::instrumented_compare<std::less<>>{{}, &probe});
+ * probe.stats().comparisons;
+ * @endcode
+ *
+ * A policy is any type with a `static constexpr bool enabled` and, when
+ * enabled, the hooks of counting_instrumentation.
+ *
+ * Requirements: C++17+
+ */
+
+#ifndef HEAP_UTILS_INSTRUMENTATION_HPP
+#define HEAP_UTILS_INSTRUMENTATION_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+
+namespace heap_utils
+{
+  /**
+   * @brief Counters collected by counting_instrumentation.
+   *
+   * `moves` counts element moves done by the sift algorithms themselves
+   * (holes, final placement, swapping the top out on pop); the container's
+   * own push_back / pop_back and returning the popped value are not
+   * included.
+   */
+  struct heap_stats
+  {
+    static constexpr std::size_t depth_buckets = 64;
+
+    std::uint64_t comparisons = 0;
+    std::uint64_t moves = 0;
+    std::uint64_t pushes = 0;
+    std::uint64_t pops = 0;
+    std::size_t high_water_mark = 0;
+
+    /// sift_depth[d]: number of sifts that moved an element by d levels.
+    std::array<std::uint64_t, depth_buckets> sift_depth{};
+
+    void reset() noexcept { *this = heap_stats{}; }
+
+    /// Accumulate another instance's counters (e.g. to aggregate shards).
+    heap_stats &operator+=(const heap_stats &other) noexcept
+    {
+      comparisons += other.comparisons;
+      moves += other.moves;
+      pushes += other.pushes;
+      pops += other.pops;
+      high_water_mark = (other.high_water_mark > high_water_mark) ? other.high_water_mark : high_water_mark;
+      for (std::size_t d = 0; d < depth_buckets; ++d)
+      {
+        sift_depth[d] += other.sift_depth[d];
+      }
+      return *this;
+    }
+  };
+
+  /**
+   * @brief Default policy: no hooks, no state, no overhead.
+   */
+  struct no_instrumentation
+  {
+    static constexpr bool enabled = false;
+  };
+
+  /**
+   * @brief Policy that counts into a heap_stats.
+   */
+  class counting_instrumentation
+  {
+  public:
+    static constexpr bool enabled = true;
+
+    void on_compare() noexcept { ++stats_.comparisons; }
+    void on_move() noexcept { ++stats_.moves; }
+
+    void on_sift(std::size_t levels) noexcept
+    {
+      const std::size_t last = heap_stats::depth_buckets - 1;
+      ++stats_.sift_depth[(levels < last) ? levels : last];
+    }
+
+    void on_push() noexcept { ++stats_.pushes; }
+    void on_pop() noexcept { ++stats_.pops; }
+
+    void on_size(std::size_t size) noexcept
+    {
+      stats_.high_water_mark = (size > stats_.high_water_mark) ? size : stats_.high_water_mark;
+    }
+
+    const heap_stats &stats() const noexcept { return stats_; }
+    void reset_stats() noexcept { stats_.reset(); }
+
+  private:
+    heap_stats stats_;
+  };
+
+  /**
+   * @brief Comparator adaptor that reports every call to `probe->on_compare()`.
+   *
+   * Wrapping a comparator also disables the SIMD child selection of the
+   * d-ary algorithms (it only recognizes std::less / std::greater), so that
+   * every comparison is observed.
+   */
+  template <class Compare = std::less<>, class Instrumentation = counting_instrumentation>
+  struct instrumented_compare
+  {
+    Compare comp;
+    Instrumentation *probe = nullptr;
+
+    template <class A, class B>
+    bool operator()(const A &a, const B &b) const
+    {
+      if constexpr (Instrumentation::enabled)
+      {
+        probe->on_compare();
+      }
+      return comp(a, b);
+    }
+  };
+
+  namespace detail
+  {
+    template <class Instrumentation>
+    constexpr void note_move(Instrumentation *probe, std::size_t count = 1) noexcept
+    {
+      if constexpr (Instrumentation::enabled)
+      {
+        for (std::size_t i = 0; i < count; ++i)
+        {
+          probe->on_move();
+        }
+      }
+      else
+      {
+        (void)probe;
+        (void)count;
+      }
+    }
+
+    template <class Instrumentation>
+    constexpr void note_sift(Instrumentation *probe, std::size_t levels) noexcept
+    {
+      if constexpr (Instrumentation::enabled)
+      {
+        probe->on_sift(levels);
+      }
+      else
+      {
+        (void)probe;
+        (void)levels;
+      }
+    }
+  } // namespace detail
+
+} // namespace heap_utils
+
+#endif // HEAP_UTILS_INSTRUMENTATION_HPP
@@ -0,0 +1,309 @@
+/**
+ * @file k_way_merge.hpp
+ * @brief Merge k sorted runs with a loser (tournament) tree.
+ *
+ * A heap of run cursors costs a pop plus a push, two comparisons per level,
+ * for every output element. A loser tree keeps the loser of each match in
+ * the internal nodes, so advancing the winning run replays a single
+ * leaf-to-root path with one comparison per level (a replace-top, never a
+ * pop + push). For small k a heap of cursors with an in-place replace-top
+ * is just as fast and has less set-up cost, so k_way_merge() switches to it
+ * below `k_way_merge_heap_threshold` runs.
+ *
+ * Runs only need input iterators: each cursor is dereferenced and
+ * incremented in place, so runs can be streamed from files or sockets.
+ *
+ * As with std::merge, runs are sorted ascending by `comp` and so is the
+ * output; equal elements are taken from lower-indexed runs first (stable).
+ *
+ * Requirements: C++17+
+ */
+
+#ifndef HEAP_UTILS_K_WAY_MERGE_HPP
+#define HEAP_UTILS_K_WAY_MERGE_HPP
+
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <heap_utils/d_ary_heap.hpp>
+
+namespace heap_utils
+{
+  /**
+   * @brief Incremental k-way merge over input-iterator runs (loser tree).
+   *
+   * top() is the smallest remaining element (by `comp`); advance() moves
+   * past it. Each advance() costs ceil(log2 k) comparisons. Every node
+   * holds a copy of its run's current element, so a replay touches one
+   * contiguous node per level and dereferences only the advanced run.
+   *
+   * @tparam InputIt Iterator type of every run.
+   * @tparam Compare Strict weak ordering the runs are sorted by.
+   */
+  template <class InputIt, class Compare = std::less<>>
+  class loser_tree
+  {
+  public:
+    using iterator = InputIt;
+    using value_type = typename std::iterator_traits<InputIt>::value_type;
+
+    /**
+     * @param runs (begin, end) of each sorted run.
+     * @param comp Ordering of the runs.
+     */
+    explicit loser_tree(std::vector<std::pair<InputIt, InputIt>> runs, Compare comp = Compare{})
+        : comp_(comp), runs_(std::move(runs))
+    {
+      std::vector<node> leaves;
+      leaf_.resize(runs_.size());
+      for (std::size_t i = 0; i < runs_.size(); ++i)
+      {
+        if (runs_[i].first != runs_[i].second)
+        {
+          leaves.push_back(node{*runs_[i].first, i, false});
+        }
+      }
+      size_ = leaves.size();
+      if (size_ == 0)
+      {
+        return;
+      }
+      tree_.resize(size_, leaves.front());
+      tree_[0] = build(leaves, 1);
+    }
+
+    /// True when every run is exhausted.
+    bool empty() const noexcept { return size_ == 0 || tree_[0].done; }
+
+    /**
+     * @brief Smallest remaining element.
+     * @throws std::runtime_error if the merge is exhausted.
+     */
+    const value_type &top() const
+    {
+      if (empty())
+      {
+        throw std::runtime_error("heap_utils: loser_tree::top() on exhausted merge");
+      }
+      return tree_[0].key;
+    }
+
+    /**
+     * @brief Move top() out of the tree (requires !empty(); call advance() next).
+     */
+    value_type take_top() noexcept(std::is_nothrow_move_constructible_v<value_type>)
+    {
+      return std::move(tree_[0].key);
+    }
+
+    /// Index of the run top() belongs to (requires !empty()).
+    std::size_t top_run() const noexcept { return tree_[0].run; }
+
+    /**
+     * @brief Move past top() and replay its path (requires !empty()).
+     */
+    void advance()
+    {
+      node w = std::move(tree_[0]);
+      std::pair<InputIt, InputIt> &r = runs_[w.run];
+      ++r.first;
+      if (r.first == r.second)
+      {
+        w.done = true;
+      }
+      else
+      {
+        w.key = *r.first;
+      }
+      for (std::size_t n = (leaf_[w.run] + size_) / 2; n >= 1; n /= 2)
+      {
+        if (beats(tree_[n], w))
+        {
+          std::swap(tree_[n], w);
+        }
+      }
+      tree_[0] = std::move(w);
+    }
+
+    /// Number of non-empty runs at construction.
+    std::size_t run_count() const noexcept { return size_; }
+
+  private:
+    struct node
+    {
+      value_type key; // current element of `run` (stale once done)
+      std::size_t run;
+      bool done;
+    };
+
+    /// True if `a` must be output before `b`; ties go to the lower run index.
+    /// The run order picks the one comparison needed (runs are distinct).
+    bool beats(const node &a, const node &b) const
+    {
+      if (a.done || b.done)
+      {
+        return !a.done;
+      }
+      return (a.run < b.run) ? !comp_(b.key, a.key) : comp_(a.key, b.key);
+    }
+
+    /// Play the matches below tree position `n`; store losers, return the winner.
+    node build(std::vector<node> &leaves, std::size_t n)
+    {
+      if (n >= size_)
+      {
+        node &leaf = leaves[n - size_];
+        leaf_[leaf.run] = n - size_;
+        return std::move(leaf);
+      }
+      node l = build(leaves, 2 * n);
+      node r = build(leaves, 2 * n + 1);
+      if (beats(l, r))
+      {
+        tree_[n] = std::move(r);
+        return l;
+      }
+      tree_[n] = std::move(l);
+      return r;
+    }
+
+    Compare comp_;
+    std::vector<std::pair<InputIt, InputIt>> runs_;
+    std::size_t size_ = 0;
+    std::vector<node> tree_;        // [0] winner, [1, k) losers
+    std::vector<std::size_t> leaf_; // run index -> leaf slot
+  };
+
+  /**
+   * @brief Below this many runs k_way_merge() uses a heap of cursors.
+   */
+  inline constexpr std::size_t k_way_merge_heap_threshold = 8;
+
+  namespace detail
+  {
+    template <class T>
+    struct is_iterator_pair : std::false_type
+    {
+    };
+
+    template <class It>
+    struct is_iterator_pair<std::pair<It, It>> : std::true_type
+    {
+    };
+
+    /// (begin, end) of a run given as an iterator pair or as a range.
+    template <class Run>
+    inline auto run_bounds(const Run &run)
+    {
+      if constexpr (is_iterator_pair<Run>::value)
+      {
+        return run;
+      }
+      else
+      {
+        return std::make_pair(std::begin(run), std::end(run));
+      }
+    }
+
+    /**
+     * @brief Small-k merge: min-heap of (cursor, run index), advanced with an in-place replace-top.
+     */
+    template <class InputIt, class OutputIt, class Compare>
+    inline OutputIt heap_merge_runs(std::vector<std::pair<InputIt, InputIt>> &runs, OutputIt out, Compare comp)
+    {
+      struct cursor
+      {
+        InputIt cur;
+        InputIt end;
+        std::size_t run;
+      };
+
+      // "Greater" so that the smallest head (lowest run on ties) is on top;
+      // one comparison, chosen by the run order as in loser_tree::beats().
+      auto later = [&comp](const cursor &a, const cursor &b)
+      { return (a.run < b.run) ? comp(*b.cur, *a.cur) : !comp(*a.cur, *b.cur); };
+
+      std::vector<cursor> heap;
+      heap.reserve(runs.size());
+      for (std::size_t i = 0; i < runs.size(); ++i)
+      {
+        if (runs[i].first != runs[i].second)
+        {
+          heap.push_back(cursor{runs[i].first, runs[i].second, i});
+        }
+      }
+      d_ary_heapify<2>(heap.begin(), heap.end(), later);
+
+      using diff_t = typename std::vector<cursor>::difference_type;
+      while (!heap.empty())
+      {
+        cursor c = std::move(heap.front());
+        *out = *c.cur;
+        ++out;
+        ++c.cur;
+        if (c.cur == c.end)
+        {
+          c = std::move(heap.back());
+          heap.pop_back();
+          if (heap.empty())
+          {
+            break;
+          }
+        }
+        detail::d_ary_sift_down<2>(heap.begin(), static_cast<diff_t>(heap.size()), diff_t(0), std::move(c), later);
+      }
+      return out;
+    }
+  } // namespace detail
+
+  /**
+   * @brief Merge sorted runs into `out`.
+   *
+   * `runs` is a range whose elements are either std::pair<InputIt, InputIt>
+   * (for streamed runs) or ranges (std::vector, std::span, ...). Uses a
+   * loser tree for k >= k_way_merge_heap_threshold runs and a heap of
+   * cursors below.
+   *
+   * Complexity: O(n log k) comparisons for n output elements; about
+   * log2(k) per element with the loser tree.
+   *
+   * @param runs Sorted runs (ascending by comp).
+   * @param out Output iterator receiving the merged sequence.
+   * @param comp Strict weak ordering (same semantics as std::merge).
+   * @return Output iterator past the last element written.
+   */
+  template <class Runs, class OutputIt, class Compare = std::less<>>
+  inline OutputIt k_way_merge(const Runs &runs, OutputIt out, Compare comp = Compare{})
+  {
+    using bounds_t = decltype(detail::run_bounds(*std::begin(runs)));
+    using iter_t = typename bounds_t::first_type;
+
+    std::vector<std::pair<iter_t, iter_t>> cursors;
+    for (const auto &run : runs)
+    {
+      cursors.push_back(detail::run_bounds(run));
+    }
+
+    if (cursors.size() < k_way_merge_heap_threshold)
+    {
+      return detail::heap_merge_runs(cursors, out, comp);
+    }
+
+    loser_tree<iter_t, Compare> tree(std::move(cursors), comp);
+    while (!tree.empty())
+    {
+      *out = tree.take_top();
+      ++out;
+      tree.advance();
+    }
+    return out;
+  }
+
+} // namespace heap_utils
+
+#endif // HEAP_UTILS_K_WAY_MERGE_HPP
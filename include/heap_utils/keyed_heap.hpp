@@ -0,0 +1,239 @@
+/**
+ * @file keyed_heap.hpp
+ * @brief Heap with split key / payload storage for large value types.
+ *
+ * `keyed_heap` sifts only compact { key, 32-bit slot } entries; payloads live
+ * in a separate slot array and never move while they are in the heap. For
+ * large payloads ordered by a small key this shrinks the sift working set to
+ * sizeof(Key) + 4 bytes per element and makes pop() cost independent of the
+ * payload size (one move out of its slot).
+ *
+ * The entry array is a D-ary heap (see d_ary_heap.hpp); comparator semantics
+ * match the standard heap algorithms and apply to keys only.
+ *
+ * Requirements: C++17+
+ */
+
+#ifndef HEAP_UTILS_KEYED_HEAP_HPP
+#define HEAP_UTILS_KEYED_HEAP_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include <heap_utils/d_ary_heap.hpp>
+
+namespace heap_utils
+{
+  /**
+   * @brief Priority queue ordered by `Key`, storing `Payload` out of line.
+   *
+   * Payload slots freed by pop() are recycled by later pushes; a recycled
+   * slot is overwritten by move assignment, so `Payload` must be
+   * default-constructible and move-assignable.
+   *
+   * @tparam Key Ordering key (kept contiguous with a 32-bit slot index).
+   * @tparam Payload Value attached to each key.
+   * @tparam Compare Key comparator (default: max-heap via std::less<>).
+   * @tparam D Arity of the entry heap.
+   */
+  template <class Key, class Payload, class Compare = std::less<>, std::size_t D = 4>
+  class keyed_heap
+  {
+  public:
+    using key_type = Key;
+    using payload_type = Payload;
+    using size_type = std::size_t;
+    using slot_type = std::uint32_t;
+
+    /// Heap entry: the only thing moved during sift operations.
+    struct entry
+    {
+      Key key;
+      slot_type slot;
+    };
+
+    keyed_heap() = default;
+
+    explicit keyed_heap(Compare comp) : comp_{comp} {}
+
+    /**
+     * @brief Insert `payload` ordered by `key`.
+     *
+     * Strong guarantee: if copying the key or assigning the payload throws,
+     * the heap is unchanged and the slot is returned to the free list.
+     */
+    void push(const Key &key, const Payload &payload)
+    {
+      push_impl(key, payload);
+    }
+
+    void push(const Key &key, Payload &&payload)
+    {
+      push_impl(key, std::move(payload));
+    }
+
+    /**
+     * @brief Return the payload of the top element.
+     * @throws std::runtime_error if the heap is empty.
+     */
+    const Payload &top() const
+    {
+      return slots_[top_entry("heap_utils: keyed_heap::top() on empty heap").slot];
+    }
+
+    /**
+     * @brief Return the key of the top element.
+     * @throws std::runtime_error if the heap is empty.
+     */
+    const Key &top_key() const
+    {
+      return top_entry("heap_utils: keyed_heap::top_key() on empty heap").key;
+    }
+
+    /**
+     * @brief Remove the top element and return its payload.
+     * @throws std::runtime_error if the heap is empty.
+     */
+    Payload pop()
+    {
+      const entry e = pop_entry("heap_utils: keyed_heap::pop() on empty heap");
+      Payload out = std::move(slots_[e.slot]);
+      free_.push_back(e.slot);
+      return out;
+    }
+
+    /**
+     * @brief Remove the top element, returning its key and payload.
+     * @throws std::runtime_error if the heap is empty.
+     */
+    std::pair<Key, Payload> pop_with_key()
+    {
+      const entry e = pop_entry("heap_utils: keyed_heap::pop_with_key() on empty heap");
+      std::pair<Key, Payload> out(e.key, std::move(slots_[e.slot]));
+      free_.push_back(e.slot);
+      return out;
+    }
+
+    bool empty() const noexcept { return heap_.empty(); }
+    size_type size() const noexcept { return heap_.size(); }
+
+    void reserve(size_type n)
+    {
+      heap_.reserve(n);
+      slots_.reserve(n);
+    }
+
+    void clear() noexcept
+    {
+      heap_.clear();
+      slots_.clear();
+      free_.clear();
+    }
+
+    /**
+     * @brief Read-only view of the entry array in heap order.
+     */
+    const std::vector<entry> &entries() const noexcept { return heap_; }
+
+    const Compare &key_comp() const noexcept { return comp_.comp; }
+
+  private:
+    struct entry_compare
+    {
+      Compare comp;
+
+      bool operator()(const entry &a, const entry &b) const
+      {
+        return comp(a.key, b.key);
+      }
+    };
+
+    template <class P>
+    void push_impl(const Key &key, P &&payload)
+    {
+      // Grow the entry array first: once a slot is taken, push_back() must
+      // not be the thing that throws.
+      if (heap_.size() == heap_.capacity())
+      {
+        heap_.reserve(heap_.empty() ? 8 : 2 * heap_.size());
+      }
+      const bool recycled = !free_.empty();
+      const slot_type slot = acquire_slot();
+      try
+      {
+        slots_[slot] = std::forward<P>(payload);
+        heap_.push_back(entry{key, slot});
+      }
+      catch (...)
+      {
+        release_slot(slot, recycled);
+        throw;
+      }
+      d_ary_push_heap<D>(heap_.begin(), heap_.end(), comp_);
+    }
+
+    slot_type acquire_slot()
+    {
+      if (!free_.empty())
+      {
+        const slot_type slot = free_.back();
+        free_.pop_back();
+        return slot;
+      }
+      if (slots_.size() >= std::numeric_limits<slot_type>::max())
+      {
+        throw std::length_error("heap_utils: keyed_heap exceeds 32-bit slot capacity");
+      }
+      slots_.emplace_back();
+      return static_cast<slot_type>(slots_.size() - 1);
+    }
+
+    // Undo acquire_slot(); neither branch allocates (free_ still has the
+    // capacity the slot was popped from).
+    void release_slot(slot_type slot, bool recycled) noexcept
+    {
+      if (recycled)
+      {
+        free_.push_back(slot);
+      }
+      else
+      {
+        slots_.pop_back();
+      }
+    }
+
+    const entry &top_entry(const char *what) const
+    {
+      if (heap_.empty())
+      {
+        throw std::runtime_error(what);
+      }
+      return heap_.front();
+    }
+
+    entry pop_entry(const char *what)
+    {
+      if (heap_.empty())
+      {
+        throw std::runtime_error(what);
+      }
+      d_ary_pop_heap<D>(heap_.begin(), heap_.end(), comp_);
+      const entry e = heap_.back();
+      heap_.pop_back();
+      return e;
+    }
+
+    entry_compare comp_{};
+    std::vector<entry> heap_;
+    std::vector<Payload> slots_;
+    std::vector<slot_type> free_;
+  };
+
+} // namespace heap_utils
+
+#endif // HEAP_UTILS_KEYED_HEAP_HPP
@@ -0,0 +1,536 @@
+/**
+ * @file mapped_heap.hpp
+ * @brief File-backed priority queue for trivially copyable elements (POSIX).
+ *
+ * `mapped_heap<T>` keeps a D-ary heap array in a memory-mapped file, so a
+ * queue larger than RAM is paged in and out by the kernel and survives
+ * restarts: reopening a file maps it and is ready immediately, with no
+ * parse and no heapify.
+ *
+ * File layout: a 4 KiB header page (magic, format version, arity, element
+ * size and alignment, a caller-chosen comparator tag, capacity, size and a
+ * one-operation journal) followed by the heap array. Reopening checks every
+ * field against the instantiation and throws on mismatch, so a file written
+ * with a different element type or ordering is never silently misread.
+ *
+ * The default arity is 8: a sift visits log8(n) levels (about 10 for 2^31
+ * elements instead of 31 for a binary heap), and each level reads one
+ * contiguous group of children.
+ *
+ * Durability: every operation updates the mapping in place. The data
+ * survives a crash of the process (it sits in the page cache); call flush()
+ * to force it to storage. Before a push() or pop() moves anything it
+ * journals, in the header page, the element being sifted, the hole it is
+ * heading for and the resulting size; each move into the hole is followed
+ * by a journal update, so at every instant the array outside the hole plus
+ * the journaled element is exactly the multiset before or after the
+ * operation. A file reopened with an operation in flight (the process died
+ * mid-sift) finishes that sift. An interrupted push() either did not happen
+ * or is complete; an interrupted pop() that got as far as journaling has
+ * removed the top element, even if the caller never received it (at most
+ * once, never twice). Surviving power loss additionally requires flush().
+ *
+ * The comparator must not throw: a throwing push() or pop() leaves its
+ * operation in the journal, to be finished when the file is next opened,
+ * and the mapped_heap that threw must not be used again.
+ *
+ * Not thread-safe; a file must not be opened by two mapped_heaps at once.
+ *
+ * Requirements: C++17+, POSIX (mmap).
+ */
+
+#ifndef HEAP_UTILS_MAPPED_HEAP_HPP
+#define HEAP_UTILS_MAPPED_HEAP_HPP
+
+#if !defined(__unix__) && !defined(__APPLE__)
+#error "heap_utils: mapped_heap.hpp requires a POSIX system (mmap)"
+#endif
+
+#include <atomic>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <type_traits>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <heap_utils/d_ary_heap.hpp>
+
+namespace heap_utils
+{
+  /**
+   * @brief On-disk header of a mapped_heap file (first page of the file).
+   */
+  struct mapped_heap_header
+  {
+    static constexpr std::uint32_t current_version = 2;
+    static constexpr std::uint64_t data_offset = 4096;
+
+    /// Values of `in_flight`.
+    static constexpr std::uint32_t idle = 0;
+    static constexpr std::uint32_t pushing = 1;
+    static constexpr std::uint32_t popping = 2;
+
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t arity;
+    std::uint64_t element_size;
+    std::uint64_t element_align;
+    std::uint64_t comparator_tag;
+    std::uint64_t capacity;
+    std::uint64_t size;
+    std::uint32_t in_flight; ///< idle, or the operation the journal describes
+    std::uint32_t reserved;
+    std::uint64_t hole;         ///< journal: slot the sifted element is moving through
+    std::uint64_t journal_size; ///< journal: size once the operation completes
+    // The sifted element itself follows at mapped_heap<T>::journal_offset.
+  };
+
+  namespace detail
+  {
+    inline constexpr char mapped_heap_magic[8] = {'H', 'E', 'A', 'P', 'U', 'T', 'L', 'S'};
+
+    [[noreturn]] inline void throw_mapped_error(const char *what)
+    {
+      throw std::system_error(errno, std::generic_category(), std::string("heap_utils: mapped_heap: ") + what);
+    }
+  } // namespace detail
+
+  /**
+   * @brief D-ary max-heap (with std::less<>) stored in a memory-mapped file.
+   *
+   * @tparam T Element type; must be trivially copyable (stored as raw bytes).
+   * @tparam Compare Heap comparator (default: max-heap via std::less<>).
+   * @tparam D Arity, at least 2.
+   */
+  template <class T, class Compare = std::less<>, std::size_t D = 8>
+  class mapped_heap
+  {
+    static_assert(std::is_trivially_copyable_v<T>, "heap_utils: mapped_heap requires a trivially copyable T");
+    static_assert(alignof(T) <= mapped_heap_header::data_offset, "heap_utils: mapped_heap: over-aligned T");
+    static_assert(D >= 2, "heap_utils: d-ary heap arity must be at least 2");
+
+  public:
+    /// Offset of the journaled element in the header page.
+    static constexpr std::uint64_t journal_offset =
+        (sizeof(mapped_heap_header) + alignof(T) - 1) / alignof(T) * alignof(T);
+
+    static_assert(journal_offset + sizeof(T) <= mapped_heap_header::data_offset,
+                  "heap_utils: mapped_heap: T does not fit in the header page journal");
+
+    using value_type = T;
+    using size_type = std::size_t;
+    using value_compare = Compare;
+
+    static constexpr std::size_t arity = D;
+
+    /**
+     * @brief Open `path`, or create it if it does not exist or is empty.
+     *
+     * @param comparator_tag Caller-chosen identifier of the ordering (e.g. a
+     *   hash of its name). Stored on creation and checked on reopen.
+     * @param initial_capacity Elements to reserve when the file is created.
+     * @throws std::system_error if the file cannot be opened, sized or mapped.
+     * @throws std::runtime_error if an existing file does not match this
+     *   instantiation (magic, version, arity, element size, comparator tag).
+     */
+    explicit mapped_heap(const std::string &path, std::uint64_t comparator_tag = 0,
+                         std::size_t initial_capacity = 1024, Compare comp = Compare{})
+        : comp_(comp)
+    {
+      fd_ = ::open(path.c_str(), O_RDWR | O_CREAT, 0644);
+      if (fd_ < 0)
+      {
+        detail::throw_mapped_error("open");
+      }
+      try
+      {
+        struct stat st;
+        if (::fstat(fd_, &st) != 0)
+        {
+          detail::throw_mapped_error("fstat");
+        }
+        if (st.st_size == 0)
+        {
+          create(comparator_tag, initial_capacity);
+        }
+        else
+        {
+          attach(static_cast<std::uint64_t>(st.st_size), comparator_tag);
+        }
+      }
+      catch (...)
+      {
+        unmap();
+        ::close(fd_);
+        throw;
+      }
+    }
+
+    mapped_heap(const mapped_heap &) = delete;
+    mapped_heap &operator=(const mapped_heap &) = delete;
+
+    mapped_heap(mapped_heap &&other) noexcept
+        : comp_(std::move(other.comp_)), fd_(std::exchange(other.fd_, -1)),
+          map_(std::exchange(other.map_, nullptr)), map_bytes_(std::exchange(other.map_bytes_, 0))
+    {
+    }
+
+    mapped_heap &operator=(mapped_heap &&other) noexcept
+    {
+      if (this != &other)
+      {
+        close();
+        comp_ = std::move(other.comp_);
+        fd_ = std::exchange(other.fd_, -1);
+        map_ = std::exchange(other.map_, nullptr);
+        map_bytes_ = std::exchange(other.map_bytes_, 0);
+      }
+      return *this;
+    }
+
+    ~mapped_heap() { close(); }
+
+    /**
+     * @brief Push a value, growing the file geometrically when full.
+     * @throws std::system_error if the file cannot be grown.
+     */
+    void push(const T &value)
+    {
+      const T copy = value; // `value` may live in the mapping grow() replaces
+      if (header()->size == header()->capacity)
+      {
+        grow(header()->capacity * 2);
+      }
+      const std::uint64_t n = header()->size;
+      begin_journal(mapped_heap_header::pushing, copy, n, n + 1);
+      sift_up_journaled();
+    }
+
+    /**
+     * @brief Return the top element.
+     * @throws std::runtime_error if the heap is empty.
+     */
+    const T &top() const
+    {
+      if (empty())
+      {
+        throw std::runtime_error("heap_utils: mapped_heap::top() on empty heap");
+      }
+      return data()[0];
+    }
+
+    /**
+     * @brief Remove the top element and return it.
+     * @throws std::runtime_error if the heap is empty.
+     */
+    T pop()
+    {
+      if (empty())
+      {
+        throw std::runtime_error("heap_utils: mapped_heap::pop() on empty heap");
+      }
+      const T *first = slots();
+      const std::uint64_t n = header()->size;
+      const T out = first[0];
+      begin_journal(mapped_heap_header::popping, first[n - 1], 0, n - 1);
+      sift_down_journaled();
+      return out;
+    }
+
+    bool empty() const noexcept { return header()->size == 0; }
+    size_type size() const noexcept { return static_cast<size_type>(header()->size); }
+    size_type capacity() const noexcept { return static_cast<size_type>(header()->capacity); }
+    std::uint64_t comparator_tag() const noexcept { return header()->comparator_tag; }
+
+    /**
+     * @brief Grow the file so that at least `n` elements fit without remapping.
+     * @throws std::system_error if the file cannot be grown.
+     */
+    void reserve(size_type n)
+    {
+      if (n > header()->capacity)
+      {
+        grow(n);
+      }
+    }
+
+    /// Drop every element (the file keeps its capacity).
+    void clear() noexcept { header()->size = 0; }
+
+    /**
+     * @brief Write dirty pages and the header to storage (msync + fsync).
+     * @throws std::system_error on I/O errors.
+     */
+    void flush()
+    {
+      if (::msync(map_, map_bytes_, MS_SYNC) != 0)
+      {
+        detail::throw_mapped_error("msync");
+      }
+      if (::fsync(fd_) != 0)
+      {
+        detail::throw_mapped_error("fsync");
+      }
+    }
+
+    /**
+     * @brief Heap order of the mapped array, e.g. to check a file after a crash.
+     */
+    bool valid() const
+    {
+      const T *first = data();
+      return d_ary_is_heap<D>(first, first + size(), comp_);
+    }
+
+    /// The mapped array in heap order (size() elements).
+    const T *data() const noexcept
+    {
+      return reinterpret_cast<const T *>(static_cast<const char *>(map_) + mapped_heap_header::data_offset);
+    }
+
+    const Compare &value_comp() const noexcept { return comp_; }
+
+  private:
+    mapped_heap_header *header() noexcept { return static_cast<mapped_heap_header *>(map_); }
+    const mapped_heap_header *header() const noexcept { return static_cast<const mapped_heap_header *>(map_); }
+
+    T *slots() noexcept
+    {
+      return reinterpret_cast<T *>(static_cast<char *>(map_) + mapped_heap_header::data_offset);
+    }
+
+    T *journaled() noexcept
+    {
+      return reinterpret_cast<T *>(static_cast<char *>(map_) + journal_offset);
+    }
+
+    // Orders stores to the mapping: a process killed between two of them
+    // leaves the earlier one in the page cache and not the later one.
+    static void ordered() noexcept { std::atomic_signal_fence(std::memory_order_seq_cst); }
+
+    /// Journal the operation, then publish it; only then may the array change.
+    void begin_journal(std::uint32_t op, const T &value, std::uint64_t hole, std::uint64_t new_size) noexcept
+    {
+      mapped_heap_header *h = header();
+      *journaled() = value;
+      h->hole = hole;
+      h->journal_size = new_size;
+      ordered();
+      h->in_flight = op;
+      ordered();
+      h->size = new_size;
+    }
+
+    void end_journal(std::uint64_t hole, const T &value) noexcept
+    {
+      slots()[hole] = value;
+      ordered();
+      header()->in_flight = mapped_heap_header::idle;
+    }
+
+    // Both sifts restart from the journal, so they also finish an operation
+    // interrupted by a crash: repeating a move whose journal update was lost
+    // copies the same element into the same hole again.
+    void sift_up_journaled()
+    {
+      mapped_heap_header *h = header();
+      T *first = slots();
+      const T value = *journaled();
+      std::uint64_t hole = h->hole;
+      while (hole > 0)
+      {
+        const std::uint64_t parent = (hole - 1) / D;
+        if (!comp_(first[parent], value))
+        {
+          break;
+        }
+        first[hole] = first[parent];
+        ordered();
+        h->hole = hole = parent;
+        ordered();
+      }
+      end_journal(hole, value);
+    }
+
+    void sift_down_journaled()
+    {
+      mapped_heap_header *h = header();
+      T *first = slots();
+      const std::uint64_t n = h->journal_size;
+      std::uint64_t hole = h->hole;
+      if (hole >= n)
+      {
+        // Popped the only element: nothing to place.
+        h->in_flight = mapped_heap_header::idle;
+        return;
+      }
+      const T value = *journaled();
+      for (;;)
+      {
+        const std::uint64_t child = D * hole + 1;
+        if (child >= n)
+        {
+          break;
+        }
+        const std::uint64_t count = (n - child < D) ? (n - child) : D;
+        const auto best = static_cast<std::uint64_t>(detail::d_ary_best_child<D>(
+            first, static_cast<std::ptrdiff_t>(child), static_cast<std::ptrdiff_t>(count), comp_));
+        if (!comp_(value, first[best]))
+        {
+          break;
+        }
+        first[hole] = first[best];
+        ordered();
+        h->hole = hole = best;
+        ordered();
+      }
+      end_journal(hole, value);
+    }
+
+    static std::uint64_t file_bytes(std::uint64_t capacity) noexcept
+    {
+      return mapped_heap_header::data_offset + capacity * sizeof(T);
+    }
+
+    /// Map the first `bytes` of the file, replacing the current mapping only on success.
+    void map(std::uint64_t bytes)
+    {
+      void *p = ::mmap(nullptr, static_cast<std::size_t>(bytes), PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+      if (p == MAP_FAILED)
+      {
+        detail::throw_mapped_error("mmap");
+      }
+      unmap();
+      map_ = p;
+      map_bytes_ = static_cast<std::size_t>(bytes);
+    }
+
+    void unmap() noexcept
+    {
+      if (map_ != nullptr)
+      {
+        ::munmap(map_, map_bytes_);
+        map_ = nullptr;
+        map_bytes_ = 0;
+      }
+    }
+
+    void close() noexcept
+    {
+      unmap();
+      if (fd_ >= 0)
+      {
+        ::close(fd_);
+        fd_ = -1;
+      }
+    }
+
+    void resize_file(std::uint64_t bytes)
+    {
+      if (::ftruncate(fd_, static_cast<off_t>(bytes)) != 0)
+      {
+        detail::throw_mapped_error("ftruncate");
+      }
+    }
+
+    void create(std::uint64_t comparator_tag, std::size_t initial_capacity)
+    {
+      const std::uint64_t capacity = (initial_capacity == 0) ? 1 : initial_capacity;
+      resize_file(file_bytes(capacity));
+      map(file_bytes(capacity));
+
+      mapped_heap_header *h = header();
+      std::memcpy(h->magic, detail::mapped_heap_magic, sizeof(h->magic));
+      h->version = mapped_heap_header::current_version;
+      h->arity = static_cast<std::uint32_t>(D);
+      h->element_size = sizeof(T);
+      h->element_align = alignof(T);
+      h->comparator_tag = comparator_tag;
+      h->capacity = capacity;
+      h->size = 0;
+      h->in_flight = mapped_heap_header::idle;
+      h->reserved = 0;
+      h->hole = 0;
+      h->journal_size = 0;
+    }
+
+    void attach(std::uint64_t bytes, std::uint64_t comparator_tag)
+    {
+      if (bytes < mapped_heap_header::data_offset)
+      {
+        throw std::runtime_error("heap_utils: mapped_heap: file too small for a header");
+      }
+      map(bytes);
+
+      const mapped_heap_header *h = header();
+      if (std::memcmp(h->magic, detail::mapped_heap_magic, sizeof(h->magic)) != 0)
+      {
+        throw std::runtime_error("heap_utils: mapped_heap: not a mapped_heap file");
+      }
+      if (h->version != mapped_heap_header::current_version)
+      {
+        throw std::runtime_error("heap_utils: mapped_heap: unsupported file version");
+      }
+      if (h->arity != D || h->element_size != sizeof(T) || h->element_align != alignof(T))
+      {
+        throw std::runtime_error("heap_utils: mapped_heap: element type or arity mismatch");
+      }
+      if (h->comparator_tag != comparator_tag)
+      {
+        throw std::runtime_error("heap_utils: mapped_heap: comparator tag mismatch");
+      }
+      if (h->size > h->capacity || file_bytes(h->capacity) > bytes)
+      {
+        throw std::runtime_error("heap_utils: mapped_heap: corrupt header");
+      }
+
+      if (h->in_flight == mapped_heap_header::idle)
+      {
+        return;
+      }
+      if ((h->in_flight != mapped_heap_header::pushing && h->in_flight != mapped_heap_header::popping) ||
+          h->journal_size > h->capacity ||
+          (h->hole >= h->journal_size && !(h->in_flight == mapped_heap_header::popping && h->journal_size == 0)))
+      {
+        throw std::runtime_error("heap_utils: mapped_heap: corrupt journal");
+      }
+
+      // The previous owner died inside push() or pop(): finish that sift.
+      header()->size = h->journal_size;
+      if (h->in_flight == mapped_heap_header::pushing)
+      {
+        sift_up_journaled();
+      }
+      else
+      {
+        sift_down_journaled();
+      }
+    }
+
+    void grow(std::uint64_t capacity)
+    {
+      const std::uint64_t bytes = file_bytes(capacity);
+      resize_file(bytes);
+      map(bytes);
+      header()->capacity = capacity;
+    }
+
+    Compare comp_{};
+    int fd_ = -1;
+    void *map_ = nullptr;
+    std::size_t map_bytes_ = 0;
+  };
+
+} // namespace heap_utils
+
+#endif // HEAP_UTILS_MAPPED_HEAP_HPP
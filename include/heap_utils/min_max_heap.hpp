@@ -0,0 +1,400 @@
+/**
+ * @file min_max_heap.hpp
+ * @brief Double-ended priority queue: O(1) min() and max() in one array.
+ *
+ * A min-max heap (Atkinson et al., 1986) is a binary heap whose levels
+ * alternate between min levels (even depth, root included) and max levels:
+ * every node on a min level is <= all of its descendants, every node on a
+ * max level is >= all of them. The minimum is the root, the maximum one of
+ * its two children.
+ *
+ * This replaces the usual pair of heaps with lazy deletion: one array, no
+ * tombstones, and both ends available in O(1).
+ *
+ * - `min_max_heap<T, Compare>`: push, min, max, pop_min, pop_max.
+ * - `bounded_min_max_heap<T, Compare>`: fixed capacity; when full, push()
+ *   evicts from the configured end (e.g. drop the cheapest entry to admit a
+ *   more expensive one).
+ *
+ * Requirements: C++17+
+ */
+
+#ifndef HEAP_UTILS_MIN_MAX_HEAP_HPP
+#define HEAP_UTILS_MIN_MAX_HEAP_HPP
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include <heap_utils/heap_utils.hpp>
+
+namespace heap_utils
+{
+  /**
+   * @brief Min-max heap.
+   *
+   * `Compare` is a "less than": min() is the smallest element by comp,
+   * max() the largest.
+   *
+   * Complexity: O(1) min / max, O(log n) push / pop_min / pop_max.
+   *
+   * @tparam T Element type.
+   * @tparam Compare Strict weak ordering (default: std::less<>).
+   * @tparam Allocator Allocator of the underlying std::vector.
+   */
+  template <class T, class Compare = std::less<>, class Allocator = std::allocator<T>>
+  class min_max_heap
+  {
+  public:
+    using value_type = T;
+    using size_type = std::size_t;
+    using value_compare = Compare;
+    using allocator_type = Allocator;
+    using container_type = std::vector<T, Allocator>;
+
+    min_max_heap() = default;
+
+    explicit min_max_heap(Compare comp, const Allocator &alloc = Allocator())
+        : comp_(comp), data_(alloc)
+    {
+    }
+
+    explicit min_max_heap(const Allocator &alloc) : data_(alloc) {}
+
+    void push(const T &value)
+    {
+      data_.push_back(value);
+      bubble_up(data_.size() - 1);
+    }
+
+    void push(T &&value)
+    {
+      data_.push_back(std::move(value));
+      bubble_up(data_.size() - 1);
+    }
+
+    template <class... Args>
+    void emplace(Args &&...args)
+    {
+      data_.emplace_back(std::forward<Args>(args)...);
+      bubble_up(data_.size() - 1);
+    }
+
+    /**
+     * @brief Smallest element.
+     * @throws std::runtime_error if the heap is empty.
+     */
+    const T &min() const
+    {
+      if (data_.empty())
+      {
+        throw std::runtime_error("heap_utils: min_max_heap::min() on empty heap");
+      }
+      return data_.front();
+    }
+
+    /**
+     * @brief Largest element.
+     * @throws std::runtime_error if the heap is empty.
+     */
+    const T &max() const
+    {
+      if (data_.empty())
+      {
+        throw std::runtime_error("heap_utils: min_max_heap::max() on empty heap");
+      }
+      return data_[max_index()];
+    }
+
+    /**
+     * @brief Remove the smallest element and return it.
+     * @throws std::runtime_error if the heap is empty.
+     */
+    T pop_min()
+    {
+      if (data_.empty())
+      {
+        throw std::runtime_error("heap_utils: min_max_heap::pop_min() on empty heap");
+      }
+      return remove_at(0);
+    }
+
+    /**
+     * @brief Remove the largest element and return it.
+     * @throws std::runtime_error if the heap is empty.
+     */
+    T pop_max()
+    {
+      if (data_.empty())
+      {
+        throw std::runtime_error("heap_utils: min_max_heap::pop_max() on empty heap");
+      }
+      return remove_at(max_index());
+    }
+
+    bool empty() const noexcept { return data_.empty(); }
+    size_type size() const noexcept { return data_.size(); }
+
+    void reserve(size_type n) { data_.reserve(n); }
+    void clear() noexcept { data_.clear(); }
+
+    /**
+     * @brief Read-only view of the underlying array in min-max heap order.
+     */
+    const container_type &container() const noexcept { return data_; }
+
+    const Compare &value_comp() const noexcept { return comp_; }
+
+    allocator_type get_allocator() const noexcept { return data_.get_allocator(); }
+
+  private:
+    bool less(std::size_t a, std::size_t b) const { return comp_(data_[a], data_[b]); }
+
+    void swap_at(std::size_t a, std::size_t b)
+    {
+      using std::swap;
+      swap(data_[a], data_[b]);
+    }
+
+    static bool on_min_level(std::size_t i) noexcept
+    {
+      bool min_level = true;
+      for (++i; i > 1; i >>= 1)
+      {
+        min_level = !min_level;
+      }
+      return min_level;
+    }
+
+    std::size_t max_index() const
+    {
+      if (data_.size() <= 2)
+      {
+        return data_.size() - 1;
+      }
+      return less(1, 2) ? 2 : 1;
+    }
+
+    T remove_at(std::size_t i)
+    {
+      T out = std::move(data_[i]);
+      if (i + 1 != data_.size())
+      {
+        data_[i] = std::move(data_.back());
+        data_.pop_back();
+        if (on_min_level(i))
+        {
+          trickle_down<false>(i);
+        }
+        else
+        {
+          trickle_down<true>(i);
+        }
+      }
+      else
+      {
+        data_.pop_back();
+      }
+      return out;
+    }
+
+    void bubble_up(std::size_t i)
+    {
+      if (i == 0)
+      {
+        return;
+      }
+      const std::size_t parent = (i - 1) / 2;
+      if (on_min_level(i))
+      {
+        if (less(parent, i))
+        {
+          swap_at(parent, i);
+          bubble_up_level<true>(parent);
+        }
+        else
+        {
+          bubble_up_level<false>(i);
+        }
+      }
+      else if (less(i, parent))
+      {
+        swap_at(parent, i);
+        bubble_up_level<false>(parent);
+      }
+      else
+      {
+        bubble_up_level<true>(i);
+      }
+    }
+
+    /// True if `a` belongs closer to the root than `b` on a max (Max) or min level.
+    template <bool Max>
+    bool before(std::size_t a, std::size_t b) const
+    {
+      return Max ? less(b, a) : less(a, b);
+    }
+
+    /// Move `i` up through its grandparents (same kind of level).
+    template <bool Max>
+    void bubble_up_level(std::size_t i)
+    {
+      while (i >= 3)
+      {
+        const std::size_t grandparent = ((i - 1) / 2 - 1) / 2;
+        if (!before<Max>(i, grandparent))
+        {
+          break;
+        }
+        swap_at(i, grandparent);
+        i = grandparent;
+      }
+    }
+
+    /// Restore the order below `i`, which sits on a max (Max) or min level.
+    template <bool Max>
+    void trickle_down(std::size_t i)
+    {
+      const std::size_t n = data_.size();
+      for (;;)
+      {
+        const std::size_t child = 2 * i + 1;
+        if (child >= n)
+        {
+          return;
+        }
+
+        // Best of the (up to) two children and four grandchildren.
+        std::size_t m = child;
+        if (child + 1 < n && before<Max>(child + 1, m))
+        {
+          m = child + 1;
+        }
+        const std::size_t grandchild = 4 * i + 3;
+        for (std::size_t g = grandchild; g < grandchild + 4 && g < n; ++g)
+        {
+          if (before<Max>(g, m))
+          {
+            m = g;
+          }
+        }
+
+        if (!before<Max>(m, i))
+        {
+          return;
+        }
+        swap_at(m, i);
+        if (m < grandchild)
+        {
+          return;
+        }
+        const std::size_t parent = (m - 1) / 2;
+        if (before<Max>(parent, m))
+        {
+          swap_at(m, parent);
+        }
+        i = m;
+      }
+    }
+
+    Compare comp_{};
+    container_type data_;
+  };
+
+  /**
+   * @brief End of a bounded_min_max_heap that is evicted when it is full.
+   */
+  enum class evict_end
+  {
+    min, ///< keep the `capacity` largest elements
+    max  ///< keep the `capacity` smallest elements
+  };
+
+  /**
+   * @brief Fixed-capacity min-max heap that evicts from one end when full.
+   *
+   * With evict_end::min it retains the largest elements seen so far (and
+   * still offers O(1) access to the largest one), with evict_end::max the
+   * smallest. On ties the element already retained is kept.
+   *
+   * @tparam T Element type.
+   * @tparam Compare Strict weak ordering (default: std::less<>).
+   */
+  template <class T, class Compare = std::less<>>
+  class bounded_min_max_heap
+  {
+  public:
+    using value_type = T;
+    using size_type = std::size_t;
+    using value_compare = Compare;
+
+    explicit bounded_min_max_heap(std::size_t capacity, evict_end end = evict_end::min,
+                                  Compare comp = Compare{})
+        : capacity_(capacity), end_(end), heap_(comp)
+    {
+      // As bounded_top_k: the capacity is a cap, not an expected size.
+      heap_.reserve((capacity < detail::top_k_initial_reserve) ? capacity : detail::top_k_initial_reserve);
+    }
+
+    /**
+     * @brief Insert `value`, evicting from the configured end if the heap is full.
+     *
+     * @return The evicted element (possibly `value` itself, if it would be
+     * evicted right away), or std::nullopt if nothing was evicted.
+     */
+    std::optional<T> push(T value)
+    {
+      if (heap_.size() < capacity_)
+      {
+        heap_.push(std::move(value));
+        return std::nullopt;
+      }
+      if (capacity_ == 0)
+      {
+        return std::optional<T>(std::move(value));
+      }
+      const Compare &comp = heap_.value_comp();
+      if (end_ == evict_end::min ? !comp(heap_.min(), value) : !comp(value, heap_.max()))
+      {
+        return std::optional<T>(std::move(value));
+      }
+      std::optional<T> evicted(end_ == evict_end::min ? heap_.pop_min() : heap_.pop_max());
+      heap_.push(std::move(value));
+      return evicted;
+    }
+
+    /// Smallest element. @throws std::runtime_error if empty.
+    const T &min() const { return heap_.min(); }
+
+    /// Largest element. @throws std::runtime_error if empty.
+    const T &max() const { return heap_.max(); }
+
+    /// @throws std::runtime_error if empty.
+    T pop_min() { return heap_.pop_min(); }
+
+    /// @throws std::runtime_error if empty.
+    T pop_max() { return heap_.pop_max(); }
+
+    bool empty() const noexcept { return heap_.empty(); }
+    bool full() const noexcept { return heap_.size() >= capacity_; }
+    size_type size() const noexcept { return heap_.size(); }
+    size_type capacity() const noexcept { return capacity_; }
+    evict_end evicts() const noexcept { return end_; }
+
+    void clear() noexcept { heap_.clear(); }
+
+    const Compare &value_comp() const noexcept { return heap_.value_comp(); }
+
+  private:
+    std::size_t capacity_;
+    evict_end end_;
+    min_max_heap<T, Compare> heap_;
+  };
+
+} // namespace heap_utils
+
+#endif // HEAP_UTILS_MIN_MAX_HEAP_HPP
@@ -0,0 +1,298 @@
+/**
+ * @file multi_queue.hpp
+ * @brief Concurrent priority queue with relaxed pop semantics (MultiQueue).
+ *
+ * A single heap behind a mutex serializes every producer and consumer. A
+ * MultiQueue keeps m = c * p small heaps (p threads, c queues per thread),
+ * each behind its own lock:
+ *
+ * - push() inserts into a random queue;
+ * - pop() samples two random queues and pops from the one whose top is
+ *   better ("power of two choices").
+ *
+ * Operations on different queues never contend, so throughput scales with
+ * the thread count. The price is that pop() may return an element that is
+ * not the global best.
+ *
+ * Rank error (relaxed mode): if the popped element is the r-th best in the
+ * queue (r = 1 is exact), then with m queues the expected r is O(m) and r is
+ * O(m log m) with high probability (Alistarh, Kopinsky, Li, Nadiradze,
+ * "The Power of Choice in Priority Scheduling", PODC 2017); the measured
+ * mean is below m (about 0.7 m for m = 8). Elements are never lost or
+ * duplicated, so priorities are respected on average but not per call.
+ *
+ * Strict mode (queue_ordering::strict) uses a single queue: every pop()
+ * returns the best element, i.e. the mutex-plus-heap behavior, for the
+ * places where exact order matters.
+ *
+ * Link with Threads::Threads (or -pthread) when using this header.
+ *
+ * Requirements: C++17+
+ */
+
+#ifndef HEAP_UTILS_MULTI_QUEUE_HPP
+#define HEAP_UTILS_MULTI_QUEUE_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <heap_utils/heap_utils.hpp>
+
+namespace heap_utils
+{
+  /**
+   * @brief Ordering guarantee of a concurrent priority queue.
+   */
+  enum class queue_ordering
+  {
+    relaxed, ///< pop() returns a near-best element (bounded rank error)
+    strict   ///< pop() returns the best element (single locked heap)
+  };
+
+  namespace detail
+  {
+    /// Per-thread xorshift generator for queue sampling.
+    inline std::uint64_t sample_random() noexcept
+    {
+      thread_local std::uint64_t state =
+          (static_cast<std::uint64_t>(std::hash<std::thread::id>{}(std::this_thread::get_id())) |
+           1u) *
+          0x9E3779B97F4A7C15ull;
+      state ^= state << 13;
+      state ^= state >> 7;
+      state ^= state << 17;
+      return state;
+    }
+  } // namespace detail
+
+  /**
+   * @brief Relaxed concurrent priority queue (MultiQueue).
+   *
+   * All member functions except the constructor and destructor may be
+   * called concurrently.
+   *
+   * @tparam T Element type.
+   * @tparam Compare Heap comparator (default: max-heap via std::less<>).
+   */
+  template <class T, class Compare = std::less<>>
+  class multi_queue
+  {
+  public:
+    using value_type = T;
+    using size_type = std::size_t;
+    using value_compare = Compare;
+
+    /**
+     * @param ordering Relaxed (m = queues_per_thread * threads queues) or strict (one queue).
+     * @param threads Expected number of concurrent threads (0: hardware_concurrency()).
+     * @param queues_per_thread c; larger values reduce contention but increase the rank error.
+     * @param comp Heap comparator.
+     */
+    explicit multi_queue(queue_ordering ordering = queue_ordering::relaxed, std::size_t threads = 0,
+                         std::size_t queues_per_thread = 2, Compare comp = Compare{})
+        : comp_(comp), count_(queue_count_for(ordering, threads, queues_per_thread)),
+          queues_(new shard[count_])
+    {
+    }
+
+    multi_queue(const multi_queue &) = delete;
+    multi_queue &operator=(const multi_queue &) = delete;
+
+    /**
+     * @brief Insert a value (waits for a queue lock if every attempt is contended).
+     */
+    void push(const T &value) { insert(T(value)); }
+    void push(T &&value) { insert(std::move(value)); }
+
+    /**
+     * @brief Insert a value unless every sampled queue is locked.
+     *
+     * Samples up to queue_count() queues without blocking.
+     *
+     * @return false if no lock could be taken; `value` is left untouched.
+     */
+    bool try_push(const T &value) { return try_insert(value); }
+    bool try_push(T &&value) { return try_insert(std::move(value)); }
+
+    /**
+     * @brief Remove a near-best element (the best one in strict mode).
+     *
+     * @return false if the queue was observed empty.
+     */
+    bool try_pop(T &out)
+    {
+      if (count_ == 1)
+      {
+        return pop_locked(queues_[0], out);
+      }
+
+      for (int attempt = 0; attempt < 8; ++attempt)
+      {
+        shard *a = &queues_[pick()];
+        shard *b = &queues_[pick()];
+        if (a->size.load(std::memory_order_relaxed) == 0)
+        {
+          std::swap(a, b);
+        }
+        if (a->size.load(std::memory_order_relaxed) == 0 || !a->lock.try_lock())
+        {
+          continue;
+        }
+        std::unique_lock<std::mutex> hold_a(a->lock, std::adopt_lock);
+
+        std::unique_lock<std::mutex> hold_b;
+        if (b != a && b->size.load(std::memory_order_relaxed) != 0)
+        {
+          hold_b = std::unique_lock<std::mutex>(b->lock, std::try_to_lock);
+        }
+
+        shard *best = a->data.empty() ? nullptr : a;
+        if (hold_b.owns_lock() && !b->data.empty() &&
+            (best == nullptr || comp_(best->data.front(), b->data.front())))
+        {
+          best = b;
+        }
+        if (best != nullptr)
+        {
+          take(*best, out);
+          return true;
+        }
+      }
+
+      // Mostly empty or heavily contended: scan every queue once.
+      const std::size_t start = pick();
+      for (std::size_t k = 0; k < count_; ++k)
+      {
+        shard &q = queues_[(start + k) % count_];
+        if (q.size.load(std::memory_order_relaxed) != 0 && pop_locked(q, out))
+        {
+          return true;
+        }
+      }
+      return false;
+    }
+
+    /**
+     * @brief Approximate number of elements (exact when no operation is in flight).
+     */
+    size_type size() const noexcept
+    {
+      size_type n = 0;
+      for (std::size_t i = 0; i < count_; ++i)
+      {
+        n += queues_[i].size.load(std::memory_order_relaxed);
+      }
+      return n;
+    }
+
+    bool empty() const noexcept { return size() == 0; }
+
+    /// Number of internal queues (m); 1 in strict mode.
+    size_type queue_count() const noexcept { return count_; }
+
+    queue_ordering ordering() const noexcept
+    {
+      return (count_ == 1) ? queue_ordering::strict : queue_ordering::relaxed;
+    }
+
+    const Compare &value_comp() const noexcept { return comp_; }
+
+  private:
+    struct alignas(64) shard
+    {
+      std::mutex lock;
+      std::vector<T> data;
+      std::atomic<std::size_t> size{0};
+    };
+
+    static std::size_t queue_count_for(queue_ordering ordering, std::size_t threads, std::size_t per_thread)
+    {
+      if (ordering == queue_ordering::strict)
+      {
+        return 1;
+      }
+      if (threads == 0)
+      {
+        const unsigned hw = std::thread::hardware_concurrency();
+        threads = (hw == 0) ? 1 : hw;
+      }
+      const std::size_t m = threads * ((per_thread == 0) ? 1 : per_thread);
+      return (m < 2) ? 2 : m;
+    }
+
+    std::size_t pick() const noexcept
+    {
+      return static_cast<std::size_t>(detail::sample_random() % count_);
+    }
+
+    void put(shard &q, T &&value)
+    {
+      heap_push(q.data, std::move(value), comp_);
+      q.size.store(q.data.size(), std::memory_order_relaxed);
+    }
+
+    void take(shard &q, T &out)
+    {
+      out = heap_pop(q.data, comp_);
+      q.size.store(q.data.size(), std::memory_order_relaxed);
+    }
+
+    bool pop_locked(shard &q, T &out)
+    {
+      std::lock_guard<std::mutex> hold(q.lock);
+      if (q.data.empty())
+      {
+        return false;
+      }
+      take(q, out);
+      return true;
+    }
+
+    void insert(T &&value)
+    {
+      for (std::size_t attempt = 0; attempt < count_; ++attempt)
+      {
+        shard &q = queues_[pick()];
+        if (q.lock.try_lock())
+        {
+          std::lock_guard<std::mutex> hold(q.lock, std::adopt_lock);
+          put(q, std::move(value));
+          return;
+        }
+      }
+      shard &q = queues_[pick()];
+      std::lock_guard<std::mutex> hold(q.lock);
+      put(q, std::move(value));
+    }
+
+    template <class U>
+    bool try_insert(U &&value)
+    {
+      for (std::size_t attempt = 0; attempt < count_; ++attempt)
+      {
+        shard &q = queues_[pick()];
+        if (q.lock.try_lock())
+        {
+          std::lock_guard<std::mutex> hold(q.lock, std::adopt_lock);
+          put(q, T(std::forward<U>(value)));
+          return true;
+        }
+      }
+      return false;
+    }
+
+    Compare comp_;
+    std::size_t count_;
+    std::unique_ptr<shard[]> queues_;
+  };
+
+} // namespace heap_utils
+
+#endif // HEAP_UTILS_MULTI_QUEUE_HPP
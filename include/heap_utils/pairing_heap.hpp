@@ -0,0 +1,447 @@
+/**
+ * @file pairing_heap.hpp
+ * @brief Node-based pairing heap with handles (decrease-key, erase, merge).
+ *
+ * Amortized costs: O(1) push, merge and decrease_key; O(log n) pop and erase.
+ * This makes it a good engine for decrease-key-heavy workloads such as
+ * shortest paths, where array heaps have to re-push and discard stale entries.
+ *
+ * Exposes the same push / top / pop surface as d_ary_heap and binary_heap so
+ * engines can be swapped through a template parameter.
+ *
+ * Nodes are obtained from an allocator (rebound to the node type), so the
+ * heap can draw from the arena / fixed_pool in allocators.hpp or from a
+ * std::pmr resource via std::pmr::polymorphic_allocator.
+ *
+ * Requirements: C++17+
+ */
+
+#ifndef HEAP_UTILS_PAIRING_HEAP_HPP
+#define HEAP_UTILS_PAIRING_HEAP_HPP
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <stdexcept>
+#include <utility>
+
+namespace heap_utils
+{
+  /**
+   * @brief Pairing heap (two-pass variant).
+   *
+   * Comparator semantics match the standard heap algorithms: with std::less<>
+   * the top is the largest element. As in indexed_heap, decrease_key() moves
+   * an element towards the top.
+   *
+   * Handles returned by push() stay valid until the element is popped or
+   * erased, or the heap is cleared or destroyed.
+   *
+   * @tparam T Element type.
+   * @tparam Compare Heap comparator (default: max-heap via std::less<>).
+   * @tparam Allocator Allocator for T, rebound internally to the node type.
+   */
+  template <class T, class Compare = std::less<>, class Allocator = std::allocator<T>>
+  class pairing_heap
+  {
+    struct node
+    {
+      T value;
+      node *child = nullptr;
+      node *sibling = nullptr;
+      node *prev = nullptr; // parent if leftmost child, else previous sibling
+
+      template <class... Args>
+      explicit node(Args &&...args) : value(std::forward<Args>(args)...) {}
+    };
+
+    using node_allocator = typename std::allocator_traits<Allocator>::template rebind_alloc<node>;
+    using node_traits = std::allocator_traits<node_allocator>;
+
+  public:
+    using value_type = T;
+    using size_type = std::size_t;
+    using value_compare = Compare;
+    using allocator_type = Allocator;
+
+    /// Size of one heap node, e.g. to size a dedicated pool.
+    static constexpr std::size_t node_size = sizeof(node);
+
+    /**
+     * @brief Opaque reference to an element inside the heap.
+     */
+    class handle
+    {
+    public:
+      handle() = default;
+
+      const T &operator*() const noexcept { return n_->value; }
+      const T *operator->() const noexcept { return &n_->value; }
+
+      explicit operator bool() const noexcept { return n_ != nullptr; }
+      friend bool operator==(handle a, handle b) noexcept { return a.n_ == b.n_; }
+      friend bool operator!=(handle a, handle b) noexcept { return a.n_ != b.n_; }
+
+    private:
+      friend class pairing_heap;
+      explicit handle(node *n) noexcept : n_(n) {}
+      node *n_ = nullptr;
+    };
+
+    pairing_heap() = default;
+
+    explicit pairing_heap(Compare comp, const Allocator &alloc = Allocator())
+        : comp_(comp), alloc_(alloc)
+    {
+    }
+
+    explicit pairing_heap(const Allocator &alloc) : alloc_(alloc) {}
+
+    pairing_heap(const pairing_heap &) = delete;
+    pairing_heap &operator=(const pairing_heap &) = delete;
+
+    pairing_heap(pairing_heap &&other) noexcept
+        : comp_(std::move(other.comp_)), alloc_(other.alloc_), root_(other.root_), size_(other.size_)
+    {
+      other.root_ = nullptr;
+      other.size_ = 0;
+    }
+
+    /**
+     * @brief Move assignment.
+     *
+     * Steals the nodes when the allocators are interchangeable; otherwise the
+     * elements are moved one by one into nodes from this heap's allocator.
+     */
+    pairing_heap &operator=(pairing_heap &&other)
+    {
+      if (this == &other)
+      {
+        return *this;
+      }
+      clear();
+      comp_ = std::move(other.comp_);
+      if constexpr (node_traits::propagate_on_container_move_assignment::value)
+      {
+        alloc_ = other.alloc_;
+      }
+      merge(other);
+      return *this;
+    }
+
+    ~pairing_heap() { clear(); }
+
+    handle push(const T &value) { return insert(create_node(value)); }
+    handle push(T &&value) { return insert(create_node(std::move(value))); }
+
+    template <class... Args>
+    handle emplace(Args &&...args)
+    {
+      return insert(create_node(std::forward<Args>(args)...));
+    }
+
+    /**
+     * @brief Return the top element.
+     * @throws std::runtime_error if the heap is empty.
+     */
+    const T &top() const
+    {
+      if (root_ == nullptr)
+      {
+        throw std::runtime_error("heap_utils: pairing_heap::top() on empty heap");
+      }
+      return root_->value;
+    }
+
+    /**
+     * @brief Handle to the top element.
+     * @throws std::runtime_error if the heap is empty.
+     */
+    handle top_handle() const
+    {
+      if (root_ == nullptr)
+      {
+        throw std::runtime_error("heap_utils: pairing_heap::top_handle() on empty heap");
+      }
+      return handle(root_);
+    }
+
+    /**
+     * @brief Remove the top element and return it.
+     * @throws std::runtime_error if the heap is empty.
+     */
+    T pop()
+    {
+      if (root_ == nullptr)
+      {
+        throw std::runtime_error("heap_utils: pairing_heap::pop() on empty heap");
+      }
+      node *old = root_;
+      root_ = combine(old->child);
+      --size_;
+      T out = std::move(old->value);
+      destroy_node(old);
+      return out;
+    }
+
+    /**
+     * @brief Give `h` a new value that is not further from the top.
+     *
+     * Amortized O(1).
+     *
+     * @throws std::invalid_argument if `value` would move the element away from the top.
+     */
+    void decrease_key(handle h, const T &value)
+    {
+      if (comp_(value, h.n_->value))
+      {
+        throw std::invalid_argument("heap_utils: pairing_heap::decrease_key() would move the value away from the top");
+      }
+      h.n_->value = value;
+      promote(h.n_);
+    }
+
+    /**
+     * @brief Give `h` an arbitrary new value.
+     *
+     * Equivalent to erase(h) + push(value) when the element moves away from
+     * the top, except that `h` stays valid.
+     */
+    void update(handle h, const T &value)
+    {
+      node *x = h.n_;
+      if (!comp_(value, x->value))
+      {
+        x->value = value;
+        promote(x);
+        return;
+      }
+      if (x == root_)
+      {
+        root_ = nullptr;
+      }
+      else
+      {
+        detach(x);
+      }
+      node *rest = combine(x->child);
+      x->child = nullptr;
+      x->value = value;
+      root_ = meld(root_, meld(rest, x));
+    }
+
+    /**
+     * @brief Remove the element referenced by `h`.
+     */
+    void erase(handle h)
+    {
+      node *x = h.n_;
+      if (x == root_)
+      {
+        (void)pop();
+        return;
+      }
+      detach(x);
+      root_ = meld(root_, combine(x->child));
+      --size_;
+      destroy_node(x);
+    }
+
+    /**
+     * @brief Move all elements of `other` into this heap.
+     *
+     * O(1) when both heaps use equal allocators; handles into `other` then
+     * remain valid and refer to this heap. Otherwise the elements are moved
+     * one by one and handles into `other` are invalidated.
+     */
+    void merge(pairing_heap &other)
+    {
+      if (this == &other)
+      {
+        return;
+      }
+      if (alloc_ == other.alloc_)
+      {
+        root_ = meld(root_, other.root_);
+        size_ += other.size_;
+        other.root_ = nullptr;
+        other.size_ = 0;
+        return;
+      }
+      while (!other.empty())
+      {
+        push(other.pop());
+      }
+    }
+
+    void merge(pairing_heap &&other) { merge(other); }
+
+    bool empty() const noexcept { return root_ == nullptr; }
+    size_type size() const noexcept { return size_; }
+
+    void clear() noexcept
+    {
+      // Iterative teardown: child/sibling chains can be very deep.
+      node *stack = root_;
+      while (stack != nullptr)
+      {
+        node *n = stack;
+        stack = n->sibling;
+        if (n->child != nullptr)
+        {
+          node *c = n->child;
+          while (c->sibling != nullptr)
+          {
+            c = c->sibling;
+          }
+          c->sibling = stack;
+          stack = n->child;
+        }
+        destroy_node(n);
+      }
+      root_ = nullptr;
+      size_ = 0;
+    }
+
+    const Compare &value_comp() const noexcept { return comp_; }
+
+    allocator_type get_allocator() const noexcept { return allocator_type(alloc_); }
+
+  private:
+    template <class... Args>
+    node *create_node(Args &&...args)
+    {
+      node *n = node_traits::allocate(alloc_, 1);
+      try
+      {
+        node_traits::construct(alloc_, n, std::forward<Args>(args)...);
+      }
+      catch (...)
+      {
+        node_traits::deallocate(alloc_, n, 1);
+        throw;
+      }
+      return n;
+    }
+
+    void destroy_node(node *n) noexcept
+    {
+      node_traits::destroy(alloc_, n);
+      node_traits::deallocate(alloc_, n, 1);
+    }
+
+    handle insert(node *n)
+    {
+      root_ = meld(root_, n);
+      ++size_;
+      return handle(n);
+    }
+
+    /// Link two detached roots; returns the new root.
+    node *meld(node *a, node *b)
+    {
+      if (a == nullptr)
+      {
+        return b;
+      }
+      if (b == nullptr)
+      {
+        return a;
+      }
+      if (comp_(a->value, b->value))
+      {
+        std::swap(a, b);
+      }
+      // b becomes the leftmost child of a.
+      b->prev = a;
+      b->sibling = a->child;
+      if (a->child != nullptr)
+      {
+        a->child->prev = b;
+      }
+      a->child = b;
+      return a;
+    }
+
+    /// Unlink `x` (not the root) and its subtree from its parent / siblings.
+    void detach(node *x) noexcept
+    {
+      if (x->prev->child == x)
+      {
+        x->prev->child = x->sibling;
+      }
+      else
+      {
+        x->prev->sibling = x->sibling;
+      }
+      if (x->sibling != nullptr)
+      {
+        x->sibling->prev = x->prev;
+      }
+      x->sibling = nullptr;
+      x->prev = nullptr;
+    }
+
+    void promote(node *x)
+    {
+      if (x == root_)
+      {
+        return;
+      }
+      detach(x);
+      root_ = meld(root_, x);
+    }
+
+    /// Two-pass pairing of a sibling list; returns the resulting root.
+    node *combine(node *first)
+    {
+      if (first == nullptr)
+      {
+        return nullptr;
+      }
+
+      // Pass 1: meld pairs left to right, chaining results in reverse order.
+      node *acc = nullptr;
+      while (first != nullptr)
+      {
+        node *a = first;
+        node *b = a->sibling;
+        a->prev = nullptr;
+        if (b == nullptr)
+        {
+          a->sibling = acc;
+          acc = a;
+          break;
+        }
+        first = b->sibling;
+        a->sibling = nullptr;
+        b->sibling = nullptr;
+        b->prev = nullptr;
+        node *m = meld(a, b);
+        m->sibling = acc;
+        acc = m;
+      }
+
+      // Pass 2: meld right to left.
+      node *result = acc;
+      acc = acc->sibling;
+      result->sibling = nullptr;
+      while (acc != nullptr)
+      {
+        node *next = acc->sibling;
+        acc->sibling = nullptr;
+        result = meld(result, acc);
+        acc = next;
+      }
+      return result;
+    }
+
+    Compare comp_{};
+    node_allocator alloc_{};
+    node *root_ = nullptr;
+    size_type size_ = 0;
+  };
+
+} // namespace heap_utils
+
+#endif // HEAP_UTILS_PAIRING_HEAP_HPP
@@ -0,0 +1,365 @@
+/**
+ * @file parallel.hpp
+ * @brief Multi-threaded heap algorithms (parallel top-k, parallel heapify).
+ *
+ * Work is split into contiguous chunks, one per worker std::thread; results
+ * are merged on the calling thread. Exceptions thrown by the comparator on
+ * a worker are rethrown on the caller.
+ *
+ * Algorithms that mirror a sequential overload take a `parallel_policy` as
+ * first argument, in the style of the std execution policies (which
+ * libstdc++ only implements on top of TBB).
+ *
+ * Link with Threads::Threads (or -pthread) when using this header.
+ *
+ * Requirements: C++17+
+ */
+
+#ifndef HEAP_UTILS_PARALLEL_HPP
+#define HEAP_UTILS_PARALLEL_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <iterator>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <heap_utils/d_ary_heap.hpp>
+#include <heap_utils/heap_utils.hpp>
+
+namespace heap_utils
+{
+  /**
+   * @brief Request multi-threaded execution of an algorithm.
+   *
+   * `threads == 0` uses std::thread::hardware_concurrency().
+   */
+  struct parallel_policy
+  {
+    std::size_t threads = 0;
+  };
+
+  /// Parallel execution on every hardware thread.
+  inline constexpr parallel_policy par{};
+
+  namespace detail
+  {
+    /// Number of workers to use: `requested`, or hardware_concurrency() if 0.
+    inline std::size_t resolve_thread_count(std::size_t requested) noexcept
+    {
+      if (requested != 0)
+      {
+        return requested;
+      }
+      const unsigned hw = std::thread::hardware_concurrency();
+      return (hw == 0) ? 1 : hw;
+    }
+
+    /**
+     * @brief Run `task(chunk_index, begin_offset, end_offset)` over `chunks`
+     * equal slices of [0, n), chunk 0 on the calling thread.
+     *
+     * A failure to create a thread (std::system_error) is not an error:
+     * the remaining chunks run on the calling thread instead.
+     */
+    template <class Task>
+    inline void run_chunks(std::size_t n, std::size_t chunks, Task &task)
+    {
+      std::vector<std::exception_ptr> errors(chunks);
+      std::vector<std::thread> workers;
+      workers.reserve(chunks - 1);
+
+      auto run = [&](std::size_t c) noexcept
+      {
+        try
+        {
+          task(c, n * c / chunks, n * (c + 1) / chunks);
+        }
+        catch (...)
+        {
+          errors[c] = std::current_exception();
+        }
+      };
+
+      // If a thread cannot be started, the calling thread runs the chunks
+      // that did not get one; started workers are always joined.
+      std::size_t spawned = 1;
+      try
+      {
+        for (; spawned < chunks; ++spawned)
+        {
+          workers.emplace_back(run, spawned);
+        }
+      }
+      catch (...)
+      {
+      }
+      for (std::size_t c = spawned; c < chunks; ++c)
+      {
+        run(c);
+      }
+      run(0);
+      for (std::thread &t : workers)
+      {
+        t.join();
+      }
+      for (const std::exception_ptr &e : errors)
+      {
+        if (e)
+        {
+          std::rethrow_exception(e);
+        }
+      }
+    }
+
+    /**
+     * @brief Orders input positions by value, breaking ties by position.
+     *
+     * On equal values the later position compares "less" (worse), so equal
+     * elements are reported in input order.
+     */
+    template <class RandomIt, class Compare>
+    struct position_compare
+    {
+      RandomIt first;
+      Compare comp;
+
+      bool operator()(std::size_t a, std::size_t b) const
+      {
+        const auto &va = first[static_cast<std::ptrdiff_t>(a)];
+        const auto &vb = first[static_cast<std::ptrdiff_t>(b)];
+        if (comp(va, vb))
+        {
+          return true;
+        }
+        if (comp(vb, va))
+        {
+          return false;
+        }
+        return a > b;
+      }
+    };
+
+    /**
+     * @brief Parallel Floyd construction of a D-ary heap.
+     *
+     * The D^L subtrees rooted at level L are independent: each worker owns a
+     * contiguous run of those roots and heapifies their subtrees level by
+     * level from the bottom up (the descendants of a run of nodes at a given
+     * depth are again contiguous). The 1 + D + ... + D^(L-1) nodes above
+     * level L are then sifted down on the calling thread.
+     */
+    template <std::size_t D, class RandomIt, class Compare>
+    inline void parallel_d_ary_heapify(RandomIt first, RandomIt last, Compare comp, std::size_t threads,
+                                       std::size_t min_chunk)
+    {
+      using diff_t = typename std::iterator_traits<RandomIt>::difference_type;
+      using value_t = typename std::iterator_traits<RandomIt>::value_type;
+      constexpr std::size_t d = D;
+
+      const auto n = static_cast<std::size_t>(last - first);
+      std::size_t workers = resolve_thread_count(threads);
+      if (workers > n / min_chunk)
+      {
+        workers = n / min_chunk;
+      }
+
+      // Level L: at least 4 subtrees per worker for load balance.
+      std::size_t roots = 1;
+      std::size_t level_begin = 0;
+      while (roots < 4 * workers)
+      {
+        level_begin += roots;
+        roots *= d;
+      }
+      if (workers < 2 || level_begin + roots > n)
+      {
+        d_ary_heapify<D>(first, last, comp);
+        return;
+      }
+
+      const std::size_t internal_end = (n - 2) / d + 1;
+      auto sift = [&](std::size_t i)
+      {
+        value_t v = std::move(first[static_cast<diff_t>(i)]);
+        d_ary_sift_down<D>(first, static_cast<diff_t>(n), static_cast<diff_t>(i), std::move(v), comp);
+      };
+
+      auto task = [&](std::size_t, std::size_t begin, std::size_t end)
+      {
+        std::vector<std::pair<std::size_t, std::size_t>> levels;
+        std::size_t lo = level_begin + begin;
+        std::size_t hi = level_begin + end;
+        while (lo < internal_end && lo < hi)
+        {
+          levels.emplace_back(lo, (hi < internal_end) ? hi : internal_end);
+          lo = d * lo + 1;
+          hi = d * hi + 1;
+        }
+        for (std::size_t l = levels.size(); l-- > 0;)
+        {
+          for (std::size_t i = levels[l].second; i-- > levels[l].first;)
+          {
+            sift(i);
+          }
+        }
+      };
+      run_chunks(roots, workers, task);
+
+      for (std::size_t i = (level_begin < internal_end) ? level_begin : internal_end; i-- > 0;)
+      {
+        sift(i);
+      }
+    }
+  } // namespace detail
+
+  /**
+   * @brief Minimum number of elements per worker for parallel heapify().
+   */
+  inline constexpr std::size_t parallel_heapify_min_chunk = 64 * 1024;
+
+  /**
+   * @brief Multi-threaded heapify: builds the same kind of heap as std::make_heap.
+   *
+   * The result satisfies is_heap(begin, end, comp); the exact arrangement may
+   * differ from the sequential overload. Ranges shorter than
+   * `parallel_heapify_min_chunk` per worker use fewer threads (or none).
+   *
+   * Complexity: O(n / t + t log n) comparisons on the critical path.
+   */
+  template <class RandomIt, class Compare = std::less<>>
+  inline void heapify(parallel_policy policy, RandomIt begin, RandomIt end, Compare comp = Compare{})
+  {
+    detail::parallel_d_ary_heapify<2>(begin, end, comp, policy.threads, parallel_heapify_min_chunk);
+  }
+
+  /**
+   * @brief Multi-threaded d_ary_heapify().
+   */
+  template <std::size_t D, class RandomIt, class Compare = std::less<>>
+  inline void d_ary_heapify(parallel_policy policy, RandomIt begin, RandomIt end, Compare comp = Compare{})
+  {
+    static_assert(D >= 2, "heap_utils: d-ary heap arity must be at least 2");
+    detail::parallel_d_ary_heapify<D>(begin, end, comp, policy.threads, parallel_heapify_min_chunk);
+  }
+
+  /**
+   * @brief Minimum number of elements per worker for the parallel top_k().
+   *
+   * Below this, thread start-up costs more than the scan it saves.
+   */
+  inline constexpr std::size_t parallel_top_k_min_chunk = 16 * 1024;
+
+  /**
+   * @brief Multi-threaded top_k over a random-access range.
+   *
+   * Each worker streams its chunk through a bounded heap of k positions
+   * (no element copies while scanning); the per-chunk winners are then
+   * merged on the calling thread.
+   *
+   * Ordering: best first, as in top_k(). Equal elements are returned in
+   * input order, so the result is deterministic and independent of the
+   * thread count.
+   *
+   * Complexity: O((n / t) log k) per worker, O(t k log(t k)) for the merge.
+   *
+   * @param policy Number of workers (0: std::thread::hardware_concurrency()).
+   * @param first Beginning of the input range.
+   * @param last End of the input range.
+   * @param k Number of elements to extract.
+   * @param comp Heap comparator (same semantics as std::make_heap).
+   * @return Vector of extracted elements (best first).
+   */
+  template <class RandomIt, class Compare = std::less<>>
+  inline std::vector<typename std::iterator_traits<RandomIt>::value_type>
+  top_k(parallel_policy policy, RandomIt first, RandomIt last, std::size_t k, Compare comp = Compare{})
+  {
+    using T = typename std::iterator_traits<RandomIt>::value_type;
+    using pos_compare = detail::position_compare<RandomIt, Compare>;
+
+    const auto n = static_cast<std::size_t>(last - first);
+    if (k == 0 || n == 0)
+    {
+      return {};
+    }
+    if (k > n)
+    {
+      k = n;
+    }
+
+    const std::size_t min_chunk = (k > parallel_top_k_min_chunk) ? k : parallel_top_k_min_chunk;
+    std::size_t chunks = detail::resolve_thread_count(policy.threads);
+    if (chunks > n / min_chunk)
+    {
+      chunks = (n / min_chunk == 0) ? 1 : n / min_chunk;
+    }
+
+    const pos_compare pcomp{first, comp};
+
+    std::vector<std::vector<std::size_t>> winners(chunks);
+    auto task = [&](std::size_t c, std::size_t begin, std::size_t end)
+    {
+      bounded_top_k<std::size_t, pos_compare> acc(k, pcomp);
+      for (std::size_t i = begin; i < end; ++i)
+      {
+        acc.push(i);
+      }
+      winners[c] = acc.take_sorted();
+    };
+    detail::run_chunks(n, chunks, task);
+
+    std::vector<std::size_t> candidates;
+    for (const auto &w : winners)
+    {
+      candidates.insert(candidates.end(), w.begin(), w.end());
+    }
+    const detail::reverse_compare<pos_compare> better{pcomp};
+    std::partial_sort(candidates.begin(), candidates.begin() + static_cast<std::ptrdiff_t>(k),
+                      candidates.end(), better);
+
+    std::vector<T> out;
+    out.reserve(k);
+    for (std::size_t i = 0; i < k; ++i)
+    {
+      out.push_back(first[static_cast<std::ptrdiff_t>(candidates[i])]);
+    }
+    return out;
+  }
+
+  /**
+   * @brief Multi-threaded top_k over a vector (not copied).
+   */
+  template <class T, class Alloc, class Compare = std::less<>>
+  inline std::vector<T> top_k(parallel_policy policy, const std::vector<T, Alloc> &data, std::size_t k,
+                              Compare comp = Compare{})
+  {
+    return top_k(policy, data.begin(), data.end(), k, comp);
+  }
+
+  /**
+   * @brief top_k(parallel_policy{threads}, first, last, k, comp).
+   */
+  template <class RandomIt, class Compare = std::less<>>
+  inline std::vector<typename std::iterator_traits<RandomIt>::value_type>
+  parallel_top_k(RandomIt first, RandomIt last, std::size_t k, Compare comp = Compare{},
+                 std::size_t threads = 0)
+  {
+    return top_k(parallel_policy{threads}, first, last, k, comp);
+  }
+
+  /**
+   * @brief top_k(parallel_policy{threads}, data, k, comp).
+   */
+  template <class T, class Alloc, class Compare = std::less<>>
+  inline std::vector<T> parallel_top_k(const std::vector<T, Alloc> &data, std::size_t k,
+                                       Compare comp = Compare{}, std::size_t threads = 0)
+  {
+    return top_k(parallel_policy{threads}, data.begin(), data.end(), k, comp);
+  }
+
+} // namespace heap_utils
+
+#endif // HEAP_UTILS_PARALLEL_HPP
@@ -0,0 +1,490 @@
+/**
+ * @file priority_cache.hpp
+ * @brief Bounded key-value cache that evicts the lowest-scored entry (LFU, cost, expiry).
+ *
+ * The usual ad-hoc version is a hash map plus a vector heap of { score, key }
+ * fed with heap_push(): every score change pushes a new entry and the stale
+ * ones are skipped when they reach the top, so the heap grows with the
+ * number of updates rather than the number of entries. `priority_cache`
+ * instead keeps one indexed_heap entry per cached key and re-prioritizes it
+ * in place:
+ *
+ * - find() / contains() are a single hash lookup, O(1) on average;
+ * - touch() / update_score() move the entry in the heap, O(log n);
+ * - inserting into a full cache evicts the entry at the top of the heap
+ *   (the lowest score with the default comparator), O(log n).
+ *
+ * Memory is one map node plus one heap entry per cached key, whatever the
+ * update rate.
+ *
+ * `sharded_priority_cache` splits the key space over independently locked
+ * priority_cache shards for concurrent use; eviction then picks the lowest
+ * score of the key's shard, an approximation of the global order. Link with
+ * Threads::Threads (or -pthread) when using it.
+ *
+ * Requirements: C++17+
+ */
+
+#ifndef HEAP_UTILS_PRIORITY_CACHE_HPP
+#define HEAP_UTILS_PRIORITY_CACHE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <heap_utils/indexed_heap.hpp>
+
+namespace heap_utils
+{
+  /**
+   * @brief Bounded cache with score-ordered eviction.
+   *
+   * Not thread-safe; see sharded_priority_cache.
+   *
+   * @tparam Key Key type (hashable).
+   * @tparam Value Cached value.
+   * @tparam Score Eviction priority (e.g. access count, cost, expiry time).
+   * @tparam Hash Key hash.
+   * @tparam KeyEqual Key equality.
+   * @tparam Compare Score comparator of the eviction heap: the entry on top
+   *   is evicted first (default: lowest score via std::greater<>, as in
+   *   indexed_heap).
+   */
+  template <class Key, class Value, class Score = std::uint64_t, class Hash = std::hash<Key>,
+            class KeyEqual = std::equal_to<Key>, class Compare = std::greater<>>
+  class priority_cache
+  {
+  public:
+    using key_type = Key;
+    using mapped_type = Value;
+    using score_type = Score;
+    using size_type = std::size_t;
+    using entry_type = std::pair<Key, Value>;
+
+    /**
+     * @param capacity Maximum number of cached entries (at least 1).
+     * @param comp Score comparator.
+     * @param hash Key hash.
+     * @param eq Key equality.
+     * @throws std::invalid_argument if `capacity` is 0.
+     */
+    explicit priority_cache(size_type capacity, Compare comp = Compare{}, Hash hash = Hash{},
+                            KeyEqual eq = KeyEqual{})
+        : index_(0, hash, eq), scores_(capacity, comp), capacity_(capacity)
+    {
+      if (capacity == 0)
+      {
+        throw std::invalid_argument("heap_utils: priority_cache capacity must be at least 1");
+      }
+      index_.reserve(capacity);
+      slots_.reserve(capacity);
+      free_.reserve(capacity); // release() never allocates
+    }
+
+    // Slots point into the map's nodes.
+    priority_cache(const priority_cache &) = delete;
+    priority_cache &operator=(const priority_cache &) = delete;
+
+    /**
+     * @brief Value cached under `key`, or nullptr. Does not change its score.
+     */
+    Value *find(const Key &key)
+    {
+      const auto it = index_.find(key);
+      return (it == index_.end()) ? nullptr : &it->second.value;
+    }
+
+    const Value *find(const Key &key) const
+    {
+      const auto it = index_.find(key);
+      return (it == index_.end()) ? nullptr : &it->second.value;
+    }
+
+    bool contains(const Key &key) const { return index_.find(key) != index_.end(); }
+
+    /**
+     * @brief Look up `key` and add `delta` to its score (an LFU hit).
+     * @return The cached value, or nullptr if `key` is not cached.
+     */
+    Value *touch(const Key &key, const Score &delta = Score{1})
+    {
+      const auto it = index_.find(key);
+      if (it == index_.end())
+      {
+        return nullptr;
+      }
+      const id_type id = it->second.id;
+      scores_.update(id, scores_.key(id) + delta);
+      return &it->second.value;
+    }
+
+    /**
+     * @brief Set the score of `key`.
+     * @return false if `key` is not cached.
+     */
+    bool update_score(const Key &key, const Score &score)
+    {
+      const auto it = index_.find(key);
+      if (it == index_.end())
+      {
+        return false;
+      }
+      scores_.update(it->second.id, score);
+      return true;
+    }
+
+    /**
+     * @brief Current score of `key`.
+     * @throws std::out_of_range if `key` is not cached.
+     */
+    const Score &score(const Key &key) const
+    {
+      const auto it = index_.find(key);
+      if (it == index_.end())
+      {
+        throw std::out_of_range("heap_utils: priority_cache::score() on a key that is not cached");
+      }
+      return scores_.key(it->second.id);
+    }
+
+    /**
+     * @brief Cache `value` under `key` with `score`, replacing any cached value.
+     *
+     * Inserting a new key into a full cache evicts the entry that evict()
+     * would return; the new entry takes over its heap slot. If allocating
+     * the new entry throws, the cache is unchanged and nothing is evicted.
+     *
+     * @return The evicted entry, if any.
+     */
+    std::optional<entry_type> insert_or_assign(Key key, Value value, const Score &score)
+    {
+      const auto it = index_.find(key);
+      if (it != index_.end())
+      {
+        it->second.value = std::move(value);
+        scores_.update(it->second.id, score);
+        return std::nullopt;
+      }
+
+      // The node first: everything after it is undone on throw.
+      const auto ins = index_.emplace(std::move(key), node{std::move(value), npos}).first;
+      if (index_.size() > capacity_)
+      {
+        const id_type id = scores_.top();
+        typename map_type::node_type handle;
+        try
+        {
+          handle = index_.extract(slots_[id]->first);
+        }
+        catch (...)
+        {
+          index_.erase(ins);
+          throw;
+        }
+        ins->second.id = id;
+        slots_[id] = &*ins;
+        scores_.update(id, score);
+        return entry_type(std::move(handle.key()), std::move(handle.mapped().value));
+      }
+
+      const bool recycled = !free_.empty();
+      const id_type id = recycled ? free_.back() : slots_.size();
+      try
+      {
+        if (!recycled)
+        {
+          slots_.push_back(nullptr);
+        }
+        scores_.push(id, score);
+      }
+      catch (...)
+      {
+        if (!recycled && slots_.size() > id)
+        {
+          slots_.pop_back();
+        }
+        index_.erase(ins);
+        throw;
+      }
+      if (recycled)
+      {
+        free_.pop_back();
+      }
+      ins->second.id = id;
+      slots_[id] = &*ins;
+      return std::nullopt;
+    }
+
+    /**
+     * @brief Remove `key` from the cache.
+     * @return false if `key` was not cached.
+     */
+    bool erase(const Key &key)
+    {
+      const auto it = index_.find(key);
+      if (it == index_.end())
+      {
+        return false;
+      }
+      const id_type id = it->second.id;
+      scores_.erase(id);
+      release(id);
+      index_.erase(it);
+      return true;
+    }
+
+    /**
+     * @brief Key of the entry evict() would remove next.
+     * @throws std::runtime_error if the cache is empty.
+     */
+    const Key &victim() const
+    {
+      if (scores_.empty())
+      {
+        throw std::runtime_error("heap_utils: priority_cache::victim() on empty cache");
+      }
+      return slots_[scores_.top()]->first;
+    }
+
+    /**
+     * @brief Remove and return the lowest-scored entry (the top of the eviction heap).
+     * @return std::nullopt if the cache is empty.
+     */
+    std::optional<entry_type> evict()
+    {
+      if (scores_.empty())
+      {
+        return std::nullopt;
+      }
+      const id_type id = scores_.pop();
+      auto handle = index_.extract(slots_[id]->first);
+      release(id);
+      return entry_type(std::move(handle.key()), std::move(handle.mapped().value));
+    }
+
+    bool empty() const noexcept { return index_.empty(); }
+    size_type size() const noexcept { return index_.size(); }
+    size_type capacity() const noexcept { return capacity_; }
+
+    void clear() noexcept
+    {
+      scores_.clear();
+      index_.clear();
+      slots_.clear();
+      free_.clear();
+    }
+
+  private:
+    using id_type = std::size_t;
+
+    static constexpr id_type npos = static_cast<id_type>(-1);
+
+    struct node
+    {
+      Value value;
+      id_type id;
+    };
+
+    using map_type = std::unordered_map<Key, node, Hash, KeyEqual>;
+
+    void release(id_type id)
+    {
+      slots_[id] = nullptr;
+      free_.push_back(id);
+    }
+
+    map_type index_;
+    std::vector<typename map_type::value_type *> slots_; // heap id -> map node
+    std::vector<id_type> free_;
+    indexed_heap<Score, Compare> scores_;
+    size_type capacity_;
+  };
+
+  /**
+   * @brief priority_cache split into independently locked shards.
+   *
+   * A key always maps to the same shard (by its hash); each shard holds
+   * ceil(capacity / shards) entries and evicts its own lowest-scored entry,
+   * so operations on different shards never contend. Lookups return copies
+   * of the value; visit() runs a callback on the value under the shard lock
+   * instead.
+   *
+   * All member functions except the constructor and destructor may be
+   * called concurrently. size() is exact only while no other thread
+   * modifies the cache.
+   */
+  template <class Key, class Value, class Score = std::uint64_t, class Hash = std::hash<Key>,
+            class KeyEqual = std::equal_to<Key>, class Compare = std::greater<>>
+  class sharded_priority_cache
+  {
+  public:
+    using cache_type = priority_cache<Key, Value, Score, Hash, KeyEqual, Compare>;
+    using key_type = Key;
+    using mapped_type = Value;
+    using score_type = Score;
+    using size_type = std::size_t;
+    using entry_type = typename cache_type::entry_type;
+
+    /**
+     * @param capacity Total capacity (at least 1), split evenly over the shards.
+     * @param shards Number of shards (0: 4 * hardware_concurrency()); at most `capacity`.
+     * @param comp Score comparator.
+     * @param hash Key hash, used for routing and copied into every shard.
+     * @param eq Key equality, copied into every shard.
+     * @throws std::invalid_argument if `capacity` is 0.
+     */
+    explicit sharded_priority_cache(size_type capacity, size_type shards = 0, Compare comp = Compare{},
+                                    Hash hash = Hash{}, KeyEqual eq = KeyEqual{})
+        : hash_(hash)
+    {
+      if (capacity == 0)
+      {
+        throw std::invalid_argument("heap_utils: priority_cache capacity must be at least 1");
+      }
+      if (shards == 0)
+      {
+        const unsigned hw = std::thread::hardware_concurrency();
+        shards = 4 * static_cast<size_type>((hw == 0) ? 1 : hw);
+      }
+      shards = (shards < capacity) ? shards : capacity;
+
+      const size_type per_shard = (capacity + shards - 1) / shards;
+      shards_.reserve(shards);
+      for (size_type i = 0; i < shards; ++i)
+      {
+        shards_.push_back(std::make_unique<shard>(per_shard, comp, hash, eq));
+      }
+    }
+
+    /**
+     * @brief Copy of the value cached under `key`. Does not change its score.
+     */
+    std::optional<Value> get(const Key &key) const
+    {
+      const shard &s = shard_for(key);
+      std::lock_guard<std::mutex> hold(s.lock);
+      const Value *v = s.cache.find(key);
+      return v ? std::optional<Value>(*v) : std::nullopt;
+    }
+
+    /**
+     * @brief Add `delta` to the score of `key` and return a copy of its value.
+     */
+    std::optional<Value> touch(const Key &key, const Score &delta = Score{1})
+    {
+      shard &s = shard_for(key);
+      std::lock_guard<std::mutex> hold(s.lock);
+      const Value *v = s.cache.touch(key, delta);
+      return v ? std::optional<Value>(*v) : std::nullopt;
+    }
+
+    /**
+     * @brief Call `f(value)` on the value cached under `key`, holding its shard lock.
+     * @return false if `key` is not cached (`f` is not called).
+     */
+    template <class F>
+    bool visit(const Key &key, F &&f)
+    {
+      shard &s = shard_for(key);
+      std::lock_guard<std::mutex> hold(s.lock);
+      Value *v = s.cache.find(key);
+      if (!v)
+      {
+        return false;
+      }
+      std::forward<F>(f)(*v);
+      return true;
+    }
+
+    bool contains(const Key &key) const
+    {
+      const shard &s = shard_for(key);
+      std::lock_guard<std::mutex> hold(s.lock);
+      return s.cache.contains(key);
+    }
+
+    /**
+     * @brief See priority_cache::insert_or_assign(); evicts within the key's shard.
+     */
+    std::optional<entry_type> insert_or_assign(Key key, Value value, const Score &score)
+    {
+      shard &s = shard_for(key);
+      std::lock_guard<std::mutex> hold(s.lock);
+      return s.cache.insert_or_assign(std::move(key), std::move(value), score);
+    }
+
+    bool update_score(const Key &key, const Score &score)
+    {
+      shard &s = shard_for(key);
+      std::lock_guard<std::mutex> hold(s.lock);
+      return s.cache.update_score(key, score);
+    }
+
+    bool erase(const Key &key)
+    {
+      shard &s = shard_for(key);
+      std::lock_guard<std::mutex> hold(s.lock);
+      return s.cache.erase(key);
+    }
+
+    size_type size() const
+    {
+      size_type n = 0;
+      for (const auto &s : shards_)
+      {
+        std::lock_guard<std::mutex> hold(s->lock);
+        n += s->cache.size();
+      }
+      return n;
+    }
+
+    bool empty() const { return size() == 0; }
+
+    /// Sum of the shard capacities (capacity rounded up to a multiple of shard_count()).
+    size_type capacity() const noexcept { return shards_.size() * shards_.front()->cache.capacity(); }
+
+    size_type shard_count() const noexcept { return shards_.size(); }
+
+    void clear()
+    {
+      for (const auto &s : shards_)
+      {
+        std::lock_guard<std::mutex> hold(s->lock);
+        s->cache.clear();
+      }
+    }
+
+  private:
+    struct alignas(64) shard
+    {
+      shard(size_type capacity, const Compare &comp, const Hash &hash, const KeyEqual &eq)
+          : cache(capacity, comp, hash, eq)
+      {
+      }
+
+      mutable std::mutex lock;
+      cache_type cache;
+    };
+
+    // Fibonacci mixing, so a weak hash (identity for integers) still spreads over the shards.
+    shard &shard_for(const Key &key) const
+    {
+      const std::uint64_t h = static_cast<std::uint64_t>(hash_(key)) * 0x9E3779B97F4A7C15ull;
+      return *shards_[static_cast<size_type>((h >> 32) % shards_.size())];
+    }
+
+    Hash hash_;
+    std::vector<std::unique_ptr<shard>> shards_;
+  };
+
+} // namespace heap_utils
+
+#endif // HEAP_UTILS_PRIORITY_CACHE_HPP
@@ -0,0 +1,310 @@
+/**
+ * @file quantile.hpp
+ * @brief Streaming quantile / median trackers built from two heaps.
+ *
+ * Samples are split between a "lower" max-heap holding the r + 1 smallest
+ * samples and an "upper" min-heap holding the rest, where r is the rank of
+ * the tracked quantile. The answer is the top of the lower heap, so each
+ * update costs O(log n) and each query O(1), instead of re-sorting a window.
+ *
+ * - `running_quantile<T>` / `running_median<T>`: every sample ever pushed
+ *   (two std::vector heaps driven by heap_push / heap_pop).
+ * - `sliding_quantile<T>` / `sliding_median<T>`: the last `window` samples.
+ *   Both heaps are indexed_heaps keyed by ring slot, so the expiring sample
+ *   is erased in O(log n) wherever it sits.
+ *
+ * Rank: for n samples and quantile q in [0, 1] the reported sample is the
+ * one at 0-based rank floor(q * (n - 1)) in `Compare` order ("lower"
+ * nearest-rank; the lower median for even n).
+ *
+ * Requirements: C++17+
+ */
+
+#ifndef HEAP_UTILS_QUANTILE_HPP
+#define HEAP_UTILS_QUANTILE_HPP
+
+#include <cstddef>
+#include <functional>
+#include <stdexcept>
+#include <vector>
+
+#include <heap_utils/heap_utils.hpp>
+#include <heap_utils/indexed_heap.hpp>
+
+namespace heap_utils
+{
+  namespace detail
+  {
+    /// Number of samples in the lower heap for `n` samples: floor(q (n - 1)) + 1.
+    inline std::size_t quantile_lower_size(double q, std::size_t n) noexcept
+    {
+      if (n == 0)
+      {
+        return 0;
+      }
+      // Small bias so that e.g. 0.57 * 100 does not round down to rank 56.
+      return static_cast<std::size_t>(q * static_cast<double>(n - 1) + 1e-9) + 1;
+    }
+
+    inline double checked_quantile(double q)
+    {
+      if (!(q >= 0.0 && q <= 1.0))
+      {
+        throw std::invalid_argument("heap_utils: quantile must be in [0, 1]");
+      }
+      return q;
+    }
+  } // namespace detail
+
+  /**
+   * @brief Running quantile over every sample pushed so far.
+   *
+   * @tparam T Sample type.
+   * @tparam Compare Strict weak ordering of samples (default: std::less<>).
+   */
+  template <class T, class Compare = std::less<>>
+  class running_quantile
+  {
+  public:
+    using value_type = T;
+    using size_type = std::size_t;
+
+    /**
+     * @param q Quantile in [0, 1] (0.5: median, 0.9: p90).
+     * @throws std::invalid_argument if q is outside [0, 1].
+     */
+    explicit running_quantile(double q, Compare comp = Compare{})
+        : q_(detail::checked_quantile(q)), lower_comp_(comp), upper_comp_{comp}
+    {
+    }
+
+    /**
+     * @brief Add a sample. O(log n).
+     */
+    void push(const T &value)
+    {
+      if (lower_.empty() || !lower_comp_(lower_.front(), value))
+      {
+        heap_push(lower_, value, lower_comp_);
+      }
+      else
+      {
+        heap_push(upper_, value, upper_comp_);
+      }
+      rebalance();
+    }
+
+    /**
+     * @brief Current quantile. O(1).
+     * @throws std::runtime_error if no sample has been pushed.
+     */
+    const T &value() const
+    {
+      if (lower_.empty())
+      {
+        throw std::runtime_error("heap_utils: running_quantile::value() on empty tracker");
+      }
+      return lower_.front();
+    }
+
+    double quantile() const noexcept { return q_; }
+    bool empty() const noexcept { return lower_.empty(); }
+    size_type size() const noexcept { return lower_.size() + upper_.size(); }
+
+    void clear() noexcept
+    {
+      lower_.clear();
+      upper_.clear();
+    }
+
+  protected:
+    /// Smallest sample above value() (requires size() > lower size).
+    const T &next_above() const { return upper_.front(); }
+    bool has_above() const noexcept { return !upper_.empty(); }
+
+  private:
+    void rebalance()
+    {
+      const std::size_t want = detail::quantile_lower_size(q_, size());
+      while (lower_.size() > want)
+      {
+        heap_push(upper_, heap_pop(lower_, lower_comp_), upper_comp_);
+      }
+      while (lower_.size() < want)
+      {
+        heap_push(lower_, heap_pop(upper_, upper_comp_), lower_comp_);
+      }
+    }
+
+    double q_;
+    Compare lower_comp_;                        // max-heap: largest of the lower part on top
+    detail::reverse_compare<Compare> upper_comp_; // min-heap: smallest of the upper part on top
+    std::vector<T> lower_;
+    std::vector<T> upper_;
+  };
+
+  /**
+   * @brief Running median over every sample pushed so far.
+   */
+  template <class T, class Compare = std::less<>>
+  class running_median : public running_quantile<T, Compare>
+  {
+    using base = running_quantile<T, Compare>;
+
+  public:
+    explicit running_median(Compare comp = Compare{}) : base(0.5, comp) {}
+
+    /// Lower median (same as value()). @throws std::runtime_error if empty.
+    const T &low() const { return base::value(); }
+
+    /// Upper median (equal to low() for odd counts). @throws std::runtime_error if empty.
+    const T &high() const
+    {
+      return (base::size() % 2 == 0 && base::has_above()) ? base::next_above() : base::value();
+    }
+  };
+
+  /**
+   * @brief Quantile over the last `window` samples.
+   *
+   * Each push() beyond the window expires the oldest sample. Samples live in
+   * two indexed_heaps keyed by their ring slot, so expiry is an O(log n)
+   * erase rather than a lazy deletion.
+   *
+   * @tparam T Sample type.
+   * @tparam Compare Strict weak ordering of samples (default: std::less<>).
+   */
+  template <class T, class Compare = std::less<>>
+  class sliding_quantile
+  {
+  public:
+    using value_type = T;
+    using size_type = std::size_t;
+
+    /**
+     * @param q Quantile in [0, 1].
+     * @param window Number of most recent samples tracked (at least 1).
+     * @throws std::invalid_argument if q is outside [0, 1] or window is 0.
+     */
+    sliding_quantile(double q, std::size_t window, Compare comp = Compare{})
+        : q_(detail::checked_quantile(q)), window_(window), comp_(comp), lower_(window, comp),
+          upper_(window, detail::reverse_compare<Compare>{comp})
+    {
+      if (window == 0)
+      {
+        throw std::invalid_argument("heap_utils: sliding_quantile window must be at least 1");
+      }
+      lower_.reserve(window);
+      upper_.reserve(window);
+    }
+
+    /**
+     * @brief Add a sample, expiring the oldest one if the window is full. O(log window).
+     */
+    void push(const T &value)
+    {
+      const std::size_t slot = next_;
+      next_ = (next_ + 1 == window_) ? 0 : next_ + 1;
+      if (!lower_.erase(slot))
+      {
+        upper_.erase(slot);
+      }
+
+      // After an expiry the lower heap may be empty while the upper one is not.
+      const bool goes_low = lower_.empty() ? (upper_.empty() || !comp_(upper_.top_key(), value))
+                                           : !comp_(lower_.top_key(), value);
+      if (goes_low)
+      {
+        lower_.push(slot, value);
+      }
+      else
+      {
+        upper_.push(slot, value);
+      }
+      rebalance();
+    }
+
+    /**
+     * @brief Current quantile of the window. O(1).
+     * @throws std::runtime_error if no sample has been pushed.
+     */
+    const T &value() const
+    {
+      if (lower_.empty())
+      {
+        throw std::runtime_error("heap_utils: sliding_quantile::value() on empty tracker");
+      }
+      return lower_.top_key();
+    }
+
+    double quantile() const noexcept { return q_; }
+    size_type window() const noexcept { return window_; }
+    bool empty() const noexcept { return lower_.empty(); }
+    size_type size() const noexcept { return lower_.size() + upper_.size(); }
+
+    void clear() noexcept
+    {
+      lower_.clear();
+      upper_.clear();
+      next_ = 0;
+    }
+
+  protected:
+    const T &next_above() const { return upper_.top_key(); }
+    bool has_above() const noexcept { return !upper_.empty(); }
+
+  private:
+    template <class From, class To>
+    static void move_top(From &from, To &to)
+    {
+      const std::size_t id = from.top();
+      const T key = from.top_key();
+      from.pop();
+      to.push(id, key);
+    }
+
+    void rebalance()
+    {
+      const std::size_t want = detail::quantile_lower_size(q_, size());
+      while (lower_.size() > want)
+      {
+        move_top(lower_, upper_);
+      }
+      while (lower_.size() < want)
+      {
+        move_top(upper_, lower_);
+      }
+    }
+
+    double q_;
+    std::size_t window_;
+    std::size_t next_ = 0;
+    Compare comp_;
+    indexed_heap<T, Compare> lower_;
+    indexed_heap<T, detail::reverse_compare<Compare>> upper_;
+  };
+
+  /**
+   * @brief Median over the last `window` samples.
+   */
+  template <class T, class Compare = std::less<>>
+  class sliding_median : public sliding_quantile<T, Compare>
+  {
+    using base = sliding_quantile<T, Compare>;
+
+  public:
+    explicit sliding_median(std::size_t window, Compare comp = Compare{}) : base(0.5, window, comp) {}
+
+    /// Lower median (same as value()). @throws std::runtime_error if empty.
+    const T &low() const { return base::value(); }
+
+    /// Upper median (equal to low() for odd counts). @throws std::runtime_error if empty.
+    const T &high() const
+    {
+      return (base::size() % 2 == 0 && base::has_above()) ? base::next_above() : base::value();
+    }
+  };
+
+} // namespace heap_utils
+
+#endif // HEAP_UTILS_QUANTILE_HPP
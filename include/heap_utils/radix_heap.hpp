@@ -0,0 +1,247 @@
+/**
+ * @file radix_heap.hpp
+ * @brief Monotone radix heap for unsigned integer keys.
+ *
+ * A radix heap is a min-heap that requires keys to be pushed in monotone
+ * order: no pushed key may be smaller than the last key returned by top() or
+ * pop(). This matches Dijkstra-style workloads with non-negative integer
+ * edge weights. Elements are bucketed by the highest bit in which their key
+ * differs from the last minimum, giving O(1) push and amortized O(log C)
+ * pop, where C is the key range, with purely sequential memory access.
+ *
+ * Exposes the same push / top / pop surface as the other heap engines.
+ *
+ * Requirements: C++17+
+ */
+
+#ifndef HEAP_UTILS_RADIX_HEAP_HPP
+#define HEAP_UTILS_RADIX_HEAP_HPP
+
+#include <array>
+#include <cstddef>
+#include <limits>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace heap_utils
+{
+  namespace detail
+  {
+    /// Number of significant bits in x (0 for x == 0).
+    template <class U>
+    inline std::size_t radix_bit_width(U x) noexcept
+    {
+      if (x == 0)
+      {
+        return 0;
+      }
+#if defined(__GNUC__) || defined(__clang__)
+      if constexpr (sizeof(U) <= sizeof(unsigned))
+      {
+        return static_cast<std::size_t>(std::numeric_limits<unsigned>::digits -
+                                        __builtin_clz(static_cast<unsigned>(x)));
+      }
+      else
+      {
+        return static_cast<std::size_t>(std::numeric_limits<unsigned long long>::digits -
+                                        __builtin_clzll(static_cast<unsigned long long>(x)));
+      }
+#else
+      std::size_t b = 0;
+      while (x != 0)
+      {
+        x = static_cast<U>(x >> 1);
+        ++b;
+      }
+      return b;
+#endif
+    }
+  } // namespace detail
+
+  /**
+   * @brief Key extractor returning the element itself.
+   */
+  struct radix_identity
+  {
+    template <class T>
+    const T &operator()(const T &value) const noexcept
+    {
+      return value;
+    }
+  };
+
+  /**
+   * @brief Key extractor returning `.first` (for std::pair<Key, Value> elements).
+   */
+  struct radix_first
+  {
+    template <class P>
+    const auto &operator()(const P &value) const noexcept
+    {
+      return value.first;
+    }
+  };
+
+  /**
+   * @brief Monotone min-heap over elements with an unsigned integer key.
+   *
+   * @tparam T Element type.
+   * @tparam KeyOf Callable returning the element's unsigned integer key.
+   */
+  template <class T, class KeyOf = radix_identity>
+  class radix_heap
+  {
+    using key_t = std::decay_t<decltype(std::declval<const KeyOf &>()(std::declval<const T &>()))>;
+    static_assert(std::is_integral_v<key_t> && std::is_unsigned_v<key_t>,
+                  "heap_utils: radix_heap requires an unsigned integer key");
+
+    static constexpr std::size_t bucket_count = std::numeric_limits<key_t>::digits + 1;
+
+  public:
+    using value_type = T;
+    using key_type = key_t;
+    using size_type = std::size_t;
+
+    radix_heap() = default;
+
+    explicit radix_heap(KeyOf key_of) : key_of_(key_of) {}
+
+    /**
+     * @brief Insert a value.
+     * @throws std::invalid_argument if its key is below the last extracted minimum.
+     */
+    void push(const T &value)
+    {
+      const key_t k = checked_key(value);
+      buckets_[bucket_of(k)].push_back(value);
+      ++size_;
+    }
+
+    void push(T &&value)
+    {
+      const key_t k = checked_key(value);
+      buckets_[bucket_of(k)].push_back(std::move(value));
+      ++size_;
+    }
+
+    /**
+     * @brief Return the element with the smallest key.
+     *
+     * May redistribute buckets, which raises the monotone lower bound to the
+     * current minimum.
+     *
+     * @throws std::runtime_error if the heap is empty.
+     */
+    const T &top() const
+    {
+      if (size_ == 0)
+      {
+        throw std::runtime_error("heap_utils: radix_heap::top() on empty heap");
+      }
+      refill();
+      return buckets_[0].back();
+    }
+
+    /**
+     * @brief Key of the element returned by top().
+     * @throws std::runtime_error if the heap is empty.
+     */
+    key_t top_key() const
+    {
+      return key_of_(top());
+    }
+
+    /**
+     * @brief Remove the element with the smallest key and return it.
+     * @throws std::runtime_error if the heap is empty.
+     */
+    T pop()
+    {
+      if (size_ == 0)
+      {
+        throw std::runtime_error("heap_utils: radix_heap::pop() on empty heap");
+      }
+      refill();
+      T out = std::move(buckets_[0].back());
+      buckets_[0].pop_back();
+      --size_;
+      return out;
+    }
+
+    /**
+     * @brief Current monotone lower bound for pushed keys.
+     */
+    key_t last_key() const noexcept { return last_; }
+
+    bool empty() const noexcept { return size_ == 0; }
+    size_type size() const noexcept { return size_; }
+
+    void clear() noexcept
+    {
+      for (auto &b : buckets_)
+      {
+        b.clear();
+      }
+      size_ = 0;
+      last_ = 0;
+    }
+
+  private:
+    key_t checked_key(const T &value) const
+    {
+      const key_t k = key_of_(value);
+      if (k < last_)
+      {
+        throw std::invalid_argument("heap_utils: radix_heap::push() key below the last extracted minimum");
+      }
+      return k;
+    }
+
+    /// 0 if k == last_, else 1 + index of the highest bit where k and last_ differ.
+    std::size_t bucket_of(key_t k) const noexcept
+    {
+      return detail::radix_bit_width(static_cast<key_t>(k ^ last_));
+    }
+
+    /// Ensure bucket 0 holds the current minimum (requires size_ > 0).
+    void refill() const
+    {
+      if (!buckets_[0].empty())
+      {
+        return;
+      }
+
+      std::size_t i = 1;
+      while (buckets_[i].empty())
+      {
+        ++i;
+      }
+
+      std::vector<T> &src = buckets_[i];
+      key_t m = key_of_(src.front());
+      for (const T &v : src)
+      {
+        const key_t k = key_of_(v);
+        m = (k < m) ? k : m;
+      }
+      last_ = m;
+
+      // Every element of bucket i lands in a strictly lower bucket.
+      for (T &v : src)
+      {
+        buckets_[bucket_of(key_of_(v))].push_back(std::move(v));
+      }
+      src.clear();
+    }
+
+    KeyOf key_of_{};
+    mutable std::array<std::vector<T>, bucket_count> buckets_{};
+    mutable key_t last_ = 0;
+    size_type size_ = 0;
+  };
+
+} // namespace heap_utils
+
+#endif // HEAP_UTILS_RADIX_HEAP_HPP
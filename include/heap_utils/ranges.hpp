@@ -0,0 +1,227 @@
+/**
+ * @file ranges.hpp
+ * @brief C++20 range overloads of the heap helpers, with projections.
+ *
+ * `heap_utils::ranges` mirrors the helpers of heap_utils.hpp for ranges and
+ * takes a projection like the std::ranges algorithms: ordering by a member
+ * or a derived score no longer needs a hand-written comparator.
+ *
+ * @code
+ * heap_utils::ranges::heapify(orders, std::ranges::less{}, &order::price);
+ * auto best = heap_utils::ranges::top_k(docs, 10, std::ranges::less{}, score);
+ * @endcode
+ *
+ * A projection inside a heap algorithm is evaluated on both sides of every
+ * comparison, so an expensive score is recomputed O(log n) times per
+ * element. top_k() can instead decorate each element with its key: the
+ * projection runs exactly once per input element and the bounded heap
+ * compares the cached keys (see key_cache). The keys only live for the
+ * duration of the call.
+ *
+ * Comparator semantics match the rest of the library: with
+ * std::ranges::less the top is the largest projected key (max-heap).
+ *
+ * Requirements: C++20 with <ranges> (__cpp_lib_ranges).
+ */
+
+#ifndef HEAP_UTILS_RANGES_HPP
+#define HEAP_UTILS_RANGES_HPP
+
+#include <heap_utils/heap_utils.hpp>
+
+#if !defined(__cpp_lib_ranges)
+#error "heap_utils: ranges.hpp requires C++20 ranges (__cpp_lib_ranges)"
+#endif
+
+#include <algorithm>
+#include <concepts>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <ranges>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace heap_utils::ranges
+{
+  /**
+   * @brief Whether top_k() caches projected keys.
+   */
+  enum class key_cache
+  {
+    /// Decorate unless the projection is std::identity or a data member pointer.
+    automatic,
+    /// Project inside every comparison (no extra memory).
+    none,
+    /// Project each element once and keep the key next to it.
+    decorated
+  };
+
+  namespace detail
+  {
+    /// `comp(proj(a), proj(b))` as a plain binary comparator.
+    template <class Comp, class Proj>
+    struct projected_compare
+    {
+      Comp comp;
+      Proj proj;
+
+      template <class A, class B>
+      constexpr bool operator()(const A &a, const B &b) const
+      {
+        return std::invoke(comp, std::invoke(proj, a), std::invoke(proj, b));
+      }
+    };
+
+    template <class Key, class T>
+    struct decorated
+    {
+      Key key;
+      T value;
+    };
+
+    /// Orders decorated elements by their cached key.
+    template <class Comp>
+    struct key_compare
+    {
+      Comp comp;
+
+      template <class Key, class T>
+      constexpr bool operator()(const decorated<Key, T> &a, const decorated<Key, T> &b) const
+      {
+        return std::invoke(comp, a.key, b.key);
+      }
+    };
+
+    template <class Proj>
+    inline constexpr bool cheap_projection_v =
+        std::is_same_v<Proj, std::identity> || std::is_member_object_pointer_v<Proj>;
+  } // namespace detail
+
+  /**
+   * @brief Build a heap over `r` ordered by `comp` on the projected keys.
+   * @return Iterator to the end of `r`.
+   */
+  template <std::ranges::random_access_range R, class Comp = std::ranges::less, class Proj = std::identity>
+    requires std::sortable<std::ranges::iterator_t<R>, Comp, Proj>
+  constexpr std::ranges::borrowed_iterator_t<R> heapify(R &&r, Comp comp = {}, Proj proj = {})
+  {
+    return std::ranges::make_heap(r, comp, proj);
+  }
+
+  /**
+   * @brief Check the heap property of `r` on the projected keys.
+   */
+  template <std::ranges::random_access_range R, class Comp = std::ranges::less, class Proj = std::identity>
+    requires std::indirect_strict_weak_order<Comp, std::projected<std::ranges::iterator_t<R>, Proj>>
+  constexpr bool is_heap(R &&r, Comp comp = {}, Proj proj = {})
+  {
+    return std::ranges::is_heap(r, comp, proj);
+  }
+
+  /**
+   * @brief Append `value` to the heap container `data` and restore the heap.
+   */
+  template <class Container, class Comp = std::ranges::less, class Proj = std::identity>
+    requires heap_utils::detail::is_heap_container_v<Container> &&
+             std::sortable<std::ranges::iterator_t<Container>, Comp, Proj>
+  constexpr void heap_push(Container &data, typename Container::value_type value, Comp comp = {}, Proj proj = {})
+  {
+    data.push_back(std::move(value));
+    std::ranges::push_heap(data, comp, proj);
+  }
+
+  /**
+   * @brief Remove the top element of the heap container `data` and return it.
+   * @throws std::runtime_error if the heap is empty.
+   */
+  template <class Container, class Comp = std::ranges::less, class Proj = std::identity>
+    requires heap_utils::detail::is_heap_container_v<Container> &&
+             std::sortable<std::ranges::iterator_t<Container>, Comp, Proj>
+  constexpr typename Container::value_type heap_pop(Container &data, Comp comp = {}, Proj proj = {})
+  {
+    if (std::ranges::empty(data))
+    {
+      throw std::runtime_error("heap_utils: ranges::heap_pop() on empty heap");
+    }
+    std::ranges::pop_heap(data, comp, proj);
+    typename Container::value_type out = std::move(data.back());
+    data.pop_back();
+    return out;
+  }
+
+  /**
+   * @brief The k elements of `r` with the best projected keys, best first.
+   *
+   * Same result as heap_utils::top_k() with the comparator
+   * `comp(proj(a), proj(b))`. Streams `r` once through a k-sized bounded
+   * heap, so single-pass input ranges work.
+   *
+   * With key_cache::decorated, `proj` is invoked exactly once per element:
+   * the key is compared against the worst retained key first, and only
+   * elements that make the cut are copied into the heap next to their key.
+   * Without it, each comparison projects both sides.
+   *
+   * Complexity: O(n log k) comparisons, O(k) memory.
+   *
+   * @param k Number of elements to extract.
+   * @param comp Ordering of the keys (same semantics as std::ranges::make_heap).
+   * @param proj Key of an element.
+   * @param cache Whether keys are computed once and cached (see key_cache).
+   */
+  template <std::ranges::input_range R, class Comp = std::ranges::less, class Proj = std::identity>
+    requires std::indirect_strict_weak_order<Comp, std::projected<std::ranges::iterator_t<R>, Proj>>
+  HEAP_UTILS_CONSTEXPR_VECTOR std::vector<std::ranges::range_value_t<R>>
+  top_k(R &&r, std::size_t k, Comp comp = {}, Proj proj = {}, key_cache cache = key_cache::automatic)
+  {
+    using T = std::ranges::range_value_t<R>;
+
+    if (k == 0)
+    {
+      return {};
+    }
+    if constexpr (std::ranges::sized_range<R>)
+    {
+      const auto n = static_cast<std::size_t>(std::ranges::size(r));
+      k = (k < n) ? k : n;
+    }
+
+    if (cache == key_cache::none || (cache == key_cache::automatic && detail::cheap_projection_v<Proj>))
+    {
+      bounded_top_k<T, detail::projected_compare<Comp, Proj>> acc(k, {comp, proj});
+      for (auto &&x : r)
+      {
+        acc.push(std::forward<decltype(x)>(x));
+      }
+      return acc.take_sorted();
+    }
+
+    using key_t = std::remove_cvref_t<std::indirect_result_t<Proj &, std::ranges::iterator_t<R>>>;
+    using item_t = detail::decorated<key_t, T>;
+
+    bounded_top_k<item_t, detail::key_compare<Comp>> acc(k, {comp});
+    for (auto &&x : r)
+    {
+      key_t key = std::invoke(proj, x);
+      if (acc.full() && !std::invoke(comp, acc.worst().key, key))
+      {
+        continue;
+      }
+      acc.push(item_t{std::move(key), T(std::forward<decltype(x)>(x))});
+    }
+
+    std::vector<item_t> items = acc.take_sorted();
+    std::vector<T> out;
+    out.reserve(items.size());
+    for (item_t &item : items)
+    {
+      out.push_back(std::move(item.value));
+    }
+    return out;
+  }
+
+} // namespace heap_utils::ranges
+
+#endif // HEAP_UTILS_RANGES_HPP
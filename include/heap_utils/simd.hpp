@@ -0,0 +1,449 @@
+/**
+ * @file simd.hpp
+ * @brief Vectorized "best of D children" kernels for d-ary heaps.
+ *
+ * The hot loop of a d-ary sift-down picks the best of D contiguous children.
+ * For arithmetic keys ordered by std::less / std::greater this is a
+ * horizontal max / min followed by a first-match search, which maps directly
+ * to SSE4.1 / AVX2 on x86 and to NEON on AArch64.
+ *
+ * Kernels are selected at compile time from the target ISA (e.g. build with
+ * -mavx2 or -march=native); everything else falls back to the scalar loop in
+ * d_ary_heap.hpp. Define HEAP_UTILS_NO_SIMD to force the scalar path.
+ *
+ * Ties resolve to the first best child, exactly like the scalar loop, so both
+ * paths produce identical heaps.
+ *
+ * Requirements: C++17+
+ */
+
+#ifndef HEAP_UTILS_SIMD_HPP
+#define HEAP_UTILS_SIMD_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <type_traits>
+#include <vector>
+
+#if !defined(HEAP_UTILS_NO_SIMD)
+#if defined(__AVX2__) || defined(__AVX__) || defined(__SSE4_1__)
+#include <immintrin.h>
+#define HEAP_UTILS_SIMD_X86 1
+#elif defined(__aarch64__) && defined(__ARM_NEON)
+#include <arm_neon.h>
+#define HEAP_UTILS_SIMD_NEON 1
+#endif
+#endif
+
+namespace heap_utils
+{
+  namespace detail
+  {
+    /// Which end of the order the best child sits at, for a standard comparator.
+    enum class simd_order
+    {
+      none,
+      max, // std::less: max-heap, best child is the largest
+      min  // std::greater: min-heap, best child is the smallest
+    };
+
+    template <class Compare, class T>
+    struct simd_order_of : std::integral_constant<simd_order, simd_order::none>
+    {
+    };
+
+    template <class T>
+    struct simd_order_of<std::less<>, T> : std::integral_constant<simd_order, simd_order::max>
+    {
+    };
+
+    template <class T>
+    struct simd_order_of<std::less<T>, T> : std::integral_constant<simd_order, simd_order::max>
+    {
+    };
+
+    template <class T>
+    struct simd_order_of<std::greater<>, T> : std::integral_constant<simd_order, simd_order::min>
+    {
+    };
+
+    template <class T>
+    struct simd_order_of<std::greater<T>, T> : std::integral_constant<simd_order, simd_order::min>
+    {
+    };
+
+    /**
+     * @brief Kernel returning the index of the best of D values at `p`.
+     *
+     * `best(p)` returns -1 when no lane matched (unordered floats such as NaN),
+     * in which case the caller falls back to the scalar loop.
+     */
+    template <class T, std::size_t D, simd_order Order>
+    struct simd_child_select
+    {
+      static constexpr bool enabled = false;
+    };
+
+    inline int simd_first_lane(unsigned mask) noexcept
+    {
+      if (mask == 0)
+      {
+        return -1;
+      }
+#if defined(__GNUC__) || defined(__clang__)
+      return __builtin_ctz(mask);
+#else
+      int i = 0;
+      while ((mask & 1u) == 0)
+      {
+        mask >>= 1;
+        ++i;
+      }
+      return i;
+#endif
+    }
+
+#if defined(HEAP_UTILS_SIMD_X86)
+
+#if defined(__SSE4_1__)
+    template <simd_order Order>
+    struct simd_child_select<std::int32_t, 4, Order>
+    {
+      static constexpr bool enabled = Order != simd_order::none;
+
+      static int best(const std::int32_t *p) noexcept
+      {
+        const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p));
+        __m128i t = reduce(v, _mm_shuffle_epi32(v, _MM_SHUFFLE(1, 0, 3, 2)));
+        t = reduce(t, _mm_shuffle_epi32(t, _MM_SHUFFLE(2, 3, 0, 1)));
+        const __m128i eq = _mm_cmpeq_epi32(v, t);
+        return simd_first_lane(static_cast<unsigned>(_mm_movemask_ps(_mm_castsi128_ps(eq))));
+      }
+
+    private:
+      static __m128i reduce(__m128i a, __m128i b) noexcept
+      {
+        return (Order == simd_order::max) ? _mm_max_epi32(a, b) : _mm_min_epi32(a, b);
+      }
+    };
+
+    template <simd_order Order>
+    struct simd_child_select<std::uint32_t, 4, Order>
+    {
+      static constexpr bool enabled = Order != simd_order::none;
+
+      static int best(const std::uint32_t *p) noexcept
+      {
+        const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p));
+        __m128i t = reduce(v, _mm_shuffle_epi32(v, _MM_SHUFFLE(1, 0, 3, 2)));
+        t = reduce(t, _mm_shuffle_epi32(t, _MM_SHUFFLE(2, 3, 0, 1)));
+        const __m128i eq = _mm_cmpeq_epi32(v, t);
+        return simd_first_lane(static_cast<unsigned>(_mm_movemask_ps(_mm_castsi128_ps(eq))));
+      }
+
+    private:
+      static __m128i reduce(__m128i a, __m128i b) noexcept
+      {
+        return (Order == simd_order::max) ? _mm_max_epu32(a, b) : _mm_min_epu32(a, b);
+      }
+    };
+
+    template <simd_order Order>
+    struct simd_child_select<float, 4, Order>
+    {
+      static constexpr bool enabled = Order != simd_order::none;
+
+      static int best(const float *p) noexcept
+      {
+        const __m128 v = _mm_loadu_ps(p);
+        __m128 t = reduce(v, _mm_shuffle_ps(v, v, _MM_SHUFFLE(1, 0, 3, 2)));
+        t = reduce(t, _mm_shuffle_ps(t, t, _MM_SHUFFLE(2, 3, 0, 1)));
+        return simd_first_lane(static_cast<unsigned>(_mm_movemask_ps(_mm_cmpeq_ps(v, t))));
+      }
+
+    private:
+      static __m128 reduce(__m128 a, __m128 b) noexcept
+      {
+        return (Order == simd_order::max) ? _mm_max_ps(a, b) : _mm_min_ps(a, b);
+      }
+    };
+#endif // __SSE4_1__
+
+#if defined(__AVX__)
+    template <simd_order Order>
+    struct simd_child_select<float, 8, Order>
+    {
+      static constexpr bool enabled = Order != simd_order::none;
+
+      static int best(const float *p) noexcept
+      {
+        const __m256 v = _mm256_loadu_ps(p);
+        __m256 t = reduce(v, _mm256_permute2f128_ps(v, v, 1));
+        t = reduce(t, _mm256_shuffle_ps(t, t, _MM_SHUFFLE(1, 0, 3, 2)));
+        t = reduce(t, _mm256_shuffle_ps(t, t, _MM_SHUFFLE(2, 3, 0, 1)));
+        const __m256 eq = _mm256_cmp_ps(v, t, _CMP_EQ_OQ);
+        return simd_first_lane(static_cast<unsigned>(_mm256_movemask_ps(eq)));
+      }
+
+    private:
+      static __m256 reduce(__m256 a, __m256 b) noexcept
+      {
+        return (Order == simd_order::max) ? _mm256_max_ps(a, b) : _mm256_min_ps(a, b);
+      }
+    };
+
+    template <simd_order Order>
+    struct simd_child_select<double, 4, Order>
+    {
+      static constexpr bool enabled = Order != simd_order::none;
+
+      static int best(const double *p) noexcept
+      {
+        const __m256d v = _mm256_loadu_pd(p);
+        __m256d t = reduce(v, _mm256_permute2f128_pd(v, v, 1));
+        t = reduce(t, _mm256_shuffle_pd(t, t, 0x5));
+        const __m256d eq = _mm256_cmp_pd(v, t, _CMP_EQ_OQ);
+        return simd_first_lane(static_cast<unsigned>(_mm256_movemask_pd(eq)));
+      }
+
+    private:
+      static __m256d reduce(__m256d a, __m256d b) noexcept
+      {
+        return (Order == simd_order::max) ? _mm256_max_pd(a, b) : _mm256_min_pd(a, b);
+      }
+    };
+#endif // __AVX__
+
+#if defined(__AVX2__)
+    template <class T, simd_order Order>
+    struct simd_child_select_i32x8
+    {
+      static constexpr bool enabled = Order != simd_order::none;
+
+      static int best(const T *p) noexcept
+      {
+        const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p));
+        __m256i t = reduce(v, _mm256_permute2x128_si256(v, v, 1));
+        t = reduce(t, _mm256_shuffle_epi32(t, _MM_SHUFFLE(1, 0, 3, 2)));
+        t = reduce(t, _mm256_shuffle_epi32(t, _MM_SHUFFLE(2, 3, 0, 1)));
+        const __m256i eq = _mm256_cmpeq_epi32(v, t);
+        return simd_first_lane(static_cast<unsigned>(_mm256_movemask_ps(_mm256_castsi256_ps(eq))));
+      }
+
+    private:
+      static __m256i reduce(__m256i a, __m256i b) noexcept
+      {
+        if constexpr (std::is_signed_v<T>)
+        {
+          return (Order == simd_order::max) ? _mm256_max_epi32(a, b) : _mm256_min_epi32(a, b);
+        }
+        else
+        {
+          return (Order == simd_order::max) ? _mm256_max_epu32(a, b) : _mm256_min_epu32(a, b);
+        }
+      }
+    };
+
+    template <simd_order Order>
+    struct simd_child_select<std::int32_t, 8, Order> : simd_child_select_i32x8<std::int32_t, Order>
+    {
+    };
+
+    template <simd_order Order>
+    struct simd_child_select<std::uint32_t, 8, Order> : simd_child_select_i32x8<std::uint32_t, Order>
+    {
+    };
+
+    // AVX2 has no 64-bit min/max: use compare + blend. Unsigned keys are
+    // biased by the sign bit so the signed compare orders them correctly.
+    template <class T, simd_order Order>
+    struct simd_child_select_i64x4
+    {
+      static constexpr bool enabled = Order != simd_order::none;
+
+      static int best(const T *p) noexcept
+      {
+        __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p));
+        if constexpr (std::is_unsigned_v<T>)
+        {
+          v = _mm256_xor_si256(v, _mm256_set1_epi64x(static_cast<long long>(0x8000000000000000ull)));
+        }
+        __m256i t = reduce(v, _mm256_permute4x64_epi64(v, _MM_SHUFFLE(1, 0, 3, 2)));
+        t = reduce(t, _mm256_permute4x64_epi64(t, _MM_SHUFFLE(2, 3, 0, 1)));
+        const __m256i eq = _mm256_cmpeq_epi64(v, t);
+        return simd_first_lane(static_cast<unsigned>(_mm256_movemask_pd(_mm256_castsi256_pd(eq))));
+      }
+
+    private:
+      static __m256i reduce(__m256i a, __m256i b) noexcept
+      {
+        // max: take b where b > a; min: take b where a > b.
+        const __m256i take_b = (Order == simd_order::max) ? _mm256_cmpgt_epi64(b, a)
+                                                          : _mm256_cmpgt_epi64(a, b);
+        return _mm256_blendv_epi8(a, b, take_b);
+      }
+    };
+
+    template <simd_order Order>
+    struct simd_child_select<std::int64_t, 4, Order> : simd_child_select_i64x4<std::int64_t, Order>
+    {
+    };
+
+    template <simd_order Order>
+    struct simd_child_select<std::uint64_t, 4, Order> : simd_child_select_i64x4<std::uint64_t, Order>
+    {
+    };
+#endif // __AVX2__
+
+#elif defined(HEAP_UTILS_SIMD_NEON)
+
+    // NEON has native horizontal min/max; the matching lane is then found
+    // with a short scalar scan over data that is already in L1.
+    template <class T, std::size_t D>
+    inline int simd_find_lane(const T *p, T best) noexcept
+    {
+      for (std::size_t i = 0; i < D; ++i)
+      {
+        if (p[i] == best)
+        {
+          return static_cast<int>(i);
+        }
+      }
+      return -1;
+    }
+
+    template <simd_order Order>
+    struct simd_child_select<std::int32_t, 4, Order>
+    {
+      static constexpr bool enabled = Order != simd_order::none;
+
+      static int best(const std::int32_t *p) noexcept
+      {
+        const int32x4_t v = vld1q_s32(p);
+        const std::int32_t b = (Order == simd_order::max) ? vmaxvq_s32(v) : vminvq_s32(v);
+        return simd_find_lane<std::int32_t, 4>(p, b);
+      }
+    };
+
+    template <simd_order Order>
+    struct simd_child_select<std::int32_t, 8, Order>
+    {
+      static constexpr bool enabled = Order != simd_order::none;
+
+      static int best(const std::int32_t *p) noexcept
+      {
+        const int32x4_t a = vld1q_s32(p);
+        const int32x4_t c = vld1q_s32(p + 4);
+        const std::int32_t b = (Order == simd_order::max) ? vmaxvq_s32(vmaxq_s32(a, c))
+                                                          : vminvq_s32(vminq_s32(a, c));
+        return simd_find_lane<std::int32_t, 8>(p, b);
+      }
+    };
+
+    template <simd_order Order>
+    struct simd_child_select<std::uint32_t, 4, Order>
+    {
+      static constexpr bool enabled = Order != simd_order::none;
+
+      static int best(const std::uint32_t *p) noexcept
+      {
+        const uint32x4_t v = vld1q_u32(p);
+        const std::uint32_t b = (Order == simd_order::max) ? vmaxvq_u32(v) : vminvq_u32(v);
+        return simd_find_lane<std::uint32_t, 4>(p, b);
+      }
+    };
+
+    template <simd_order Order>
+    struct simd_child_select<std::uint32_t, 8, Order>
+    {
+      static constexpr bool enabled = Order != simd_order::none;
+
+      static int best(const std::uint32_t *p) noexcept
+      {
+        const uint32x4_t a = vld1q_u32(p);
+        const uint32x4_t c = vld1q_u32(p + 4);
+        const std::uint32_t b = (Order == simd_order::max) ? vmaxvq_u32(vmaxq_u32(a, c))
+                                                           : vminvq_u32(vminq_u32(a, c));
+        return simd_find_lane<std::uint32_t, 8>(p, b);
+      }
+    };
+
+    template <simd_order Order>
+    struct simd_child_select<float, 4, Order>
+    {
+      static constexpr bool enabled = Order != simd_order::none;
+
+      static int best(const float *p) noexcept
+      {
+        const float32x4_t v = vld1q_f32(p);
+        const float b = (Order == simd_order::max) ? vmaxvq_f32(v) : vminvq_f32(v);
+        return simd_find_lane<float, 4>(p, b);
+      }
+    };
+
+    template <simd_order Order>
+    struct simd_child_select<float, 8, Order>
+    {
+      static constexpr bool enabled = Order != simd_order::none;
+
+      static int best(const float *p) noexcept
+      {
+        const float32x4_t a = vld1q_f32(p);
+        const float32x4_t c = vld1q_f32(p + 4);
+        const float b = (Order == simd_order::max) ? vmaxvq_f32(vmaxq_f32(a, c))
+                                                   : vminvq_f32(vminq_f32(a, c));
+        return simd_find_lane<float, 8>(p, b);
+      }
+    };
+
+    template <simd_order Order>
+    struct simd_child_select<double, 4, Order>
+    {
+      static constexpr bool enabled = Order != simd_order::none;
+
+      static int best(const double *p) noexcept
+      {
+        const float64x2_t a = vld1q_f64(p);
+        const float64x2_t c = vld1q_f64(p + 2);
+        const double b = (Order == simd_order::max) ? vmaxvq_f64(vmaxq_f64(a, c))
+                                                    : vminvq_f64(vminq_f64(a, c));
+        return simd_find_lane<double, 4>(p, b);
+      }
+    };
+
+#endif
+
+    /**
+     * @brief True if `It` is known to address contiguous storage of `T`.
+     */
+    template <class It, class T>
+    struct is_contiguous_iterator_of
+        : std::bool_constant<std::is_same_v<It, T *> ||
+                             std::is_same_v<It, const T *> ||
+                             std::is_same_v<It, typename std::vector<T>::iterator> ||
+                             std::is_same_v<It, typename std::vector<T>::const_iterator>>
+    {
+    };
+
+    /**
+     * @brief Whether d_ary_best_child may use a vector kernel for (It, Compare, D).
+     */
+    template <class It, class Compare, std::size_t D>
+    struct use_simd_child_select
+    {
+      using value_t = typename std::iterator_traits<It>::value_type;
+      static constexpr simd_order order = simd_order_of<Compare, value_t>::value;
+
+      static constexpr bool value =
+          std::is_arithmetic_v<value_t> &&
+          !std::is_same_v<value_t, bool> &&
+          is_contiguous_iterator_of<It, value_t>::value &&
+          simd_child_select<value_t, D, order>::enabled;
+    };
+
+  } // namespace detail
+} // namespace heap_utils
+
+#endif // HEAP_UTILS_SIMD_HPP
@@ -0,0 +1,249 @@
+/**
+ * @file static_heap.hpp
+ * @brief Fixed-capacity, allocation-free heaps for hot paths.
+ *
+ * - `static_vector<T, N>`: inline array + size, usable with heap_push /
+ *   heap_pop / heapify like any other heap container.
+ * - `static_heap<T, N, Compare>`: priority queue over a static_vector.
+ * - `static_top_k<T, K, Compare>`: compile-time-bounded version of
+ *   bounded_top_k (e.g. top-10 per request) that never touches the allocator.
+ *
+ * Storage is a std::array<T, N>, so T must be default-constructible; slots
+ * past size() hold default-constructed or moved-from values.
+ *
+ * Requirements: C++17+
+ */
+
+#ifndef HEAP_UTILS_STATIC_HEAP_HPP
+#define HEAP_UTILS_STATIC_HEAP_HPP
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <functional>
+#include <stdexcept>
+#include <utility>
+
+#include <heap_utils/heap_utils.hpp>
+
+namespace heap_utils
+{
+  /**
+   * @brief Fixed-capacity vector with inline storage.
+   *
+   * @tparam T Element type (default-constructible).
+   * @tparam N Capacity.
+   */
+  template <class T, std::size_t N>
+  class static_vector
+  {
+  public:
+    using value_type = T;
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+    using reference = T &;
+    using const_reference = const T &;
+    using iterator = T *;
+    using const_iterator = const T *;
+
+    static_vector() = default;
+
+    /**
+     * @throws std::length_error if the vector is full.
+     */
+    void push_back(const T &value)
+    {
+      check_room();
+      data_[size_++] = value;
+    }
+
+    void push_back(T &&value)
+    {
+      check_room();
+      data_[size_++] = std::move(value);
+    }
+
+    void pop_back() noexcept { --size_; }
+
+    T &back() noexcept { return data_[size_ - 1]; }
+    const T &back() const noexcept { return data_[size_ - 1]; }
+    T &front() noexcept { return data_[0]; }
+    const T &front() const noexcept { return data_[0]; }
+
+    T &operator[](size_type i) noexcept { return data_[i]; }
+    const T &operator[](size_type i) const noexcept { return data_[i]; }
+
+    iterator begin() noexcept { return data_.data(); }
+    iterator end() noexcept { return data_.data() + size_; }
+    const_iterator begin() const noexcept { return data_.data(); }
+    const_iterator end() const noexcept { return data_.data() + size_; }
+
+    T *data() noexcept { return data_.data(); }
+    const T *data() const noexcept { return data_.data(); }
+
+    bool empty() const noexcept { return size_ == 0; }
+    bool full() const noexcept { return size_ == N; }
+    size_type size() const noexcept { return size_; }
+    static constexpr size_type capacity() noexcept { return N; }
+
+    void clear() noexcept { size_ = 0; }
+
+  private:
+    void check_room() const
+    {
+      if (size_ == N)
+      {
+        throw std::length_error("heap_utils: static_vector capacity exceeded");
+      }
+    }
+
+    std::array<T, N> data_{};
+    size_type size_ = 0;
+  };
+
+  /**
+   * @brief Fixed-capacity priority queue with inline storage.
+   *
+   * @tparam T Element type (default-constructible).
+   * @tparam N Capacity.
+   * @tparam Compare Heap comparator (default: max-heap via std::less<>).
+   */
+  template <class T, std::size_t N, class Compare = std::less<>>
+  class static_heap
+  {
+  public:
+    using value_type = T;
+    using size_type = std::size_t;
+    using value_compare = Compare;
+
+    static_heap() = default;
+
+    explicit static_heap(Compare comp) : comp_(comp) {}
+
+    /**
+     * @throws std::length_error if the heap is full.
+     */
+    void push(const T &value) { heap_push(data_, value, comp_); }
+    void push(T &&value) { heap_push(data_, std::move(value), comp_); }
+
+    /**
+     * @brief Push unless full.
+     * @return false if the heap was full and `value` was not inserted.
+     */
+    bool try_push(const T &value)
+    {
+      if (data_.full())
+      {
+        return false;
+      }
+      heap_push(data_, value, comp_);
+      return true;
+    }
+
+    /**
+     * @brief Return the top element.
+     * @throws std::runtime_error if the heap is empty.
+     */
+    const T &top() const { return heap_top(data_); }
+
+    /**
+     * @brief Remove the top element and return it.
+     * @throws std::runtime_error if the heap is empty.
+     */
+    T pop() { return heap_pop(data_, comp_); }
+
+    bool empty() const noexcept { return data_.empty(); }
+    bool full() const noexcept { return data_.full(); }
+    size_type size() const noexcept { return data_.size(); }
+    static constexpr size_type capacity() noexcept { return N; }
+
+    void clear() noexcept { data_.clear(); }
+
+    /**
+     * @brief Read-only view of the underlying storage in heap order.
+     */
+    const static_vector<T, N> &container() const noexcept { return data_; }
+
+    const Compare &value_comp() const noexcept { return comp_; }
+
+  private:
+    Compare comp_{};
+    static_vector<T, N> data_;
+  };
+
+  /**
+   * @brief Keep the K "best" elements seen so far without allocating.
+   *
+   * Same semantics as bounded_top_k with a compile-time K.
+   *
+   * @tparam T Element type (default-constructible).
+   * @tparam K Number of elements to keep.
+   * @tparam Compare Heap comparator (same semantics as top_k()).
+   */
+  template <class T, std::size_t K, class Compare = std::less<>>
+  class static_top_k
+  {
+  public:
+    static_top_k() = default;
+
+    explicit static_top_k(Compare comp) : comp_{comp} {}
+
+    /**
+     * @brief Offer a value.
+     * @return true if the value was retained.
+     */
+    template <class U>
+    bool push(U &&value)
+    {
+      if (!heap_.full())
+      {
+        heap_push(heap_, std::forward<U>(value), comp_);
+        return true;
+      }
+      if (K == 0 || !comp_.comp(heap_.front(), value))
+      {
+        return false;
+      }
+      detail::replace_top(heap_.begin(), static_cast<std::ptrdiff_t>(heap_.size()), std::forward<U>(value), comp_);
+      return true;
+    }
+
+    /**
+     * @brief Return the worst retained element (the next one to be evicted).
+     * @throws std::runtime_error if nothing has been retained yet.
+     */
+    const T &worst() const
+    {
+      if (heap_.empty())
+      {
+        throw std::runtime_error("heap_utils: static_top_k::worst() on empty accumulator");
+      }
+      return heap_.front();
+    }
+
+    std::size_t size() const noexcept { return heap_.size(); }
+    static constexpr std::size_t capacity() noexcept { return K; }
+    bool empty() const noexcept { return heap_.empty(); }
+    bool full() const noexcept { return heap_.full(); }
+
+    void clear() noexcept { heap_.clear(); }
+
+    /**
+     * @brief Return the retained elements, best first, and reset.
+     */
+    static_vector<T, K> take_sorted()
+    {
+      std::sort_heap(heap_.begin(), heap_.end(), comp_);
+      static_vector<T, K> out = std::move(heap_);
+      heap_.clear();
+      return out;
+    }
+
+  private:
+    detail::reverse_compare<Compare> comp_{};
+    static_vector<T, K> heap_;
+  };
+
+} // namespace heap_utils
+
+#endif // HEAP_UTILS_STATIC_HEAP_HPP
@@ -0,0 +1,333 @@
+/**
+ * @file timer_queue.hpp
+ * @brief Timer queue for millions of timeouts: hashed timing wheel + indexed heap.
+ *
+ * A heap of deadlines pays O(log n) for every schedule, and a keep-alive
+ * reset is a cancel plus a schedule. Most timeouts of a server are short and
+ * are reset or cancelled long before they fire, so `timer_queue` keeps them
+ * in a hashed timing wheel instead:
+ *
+ * - the wheel has S slots (a power of two) of `resolution` ticks each and
+ *   covers the S slots from the current one; a timer due inside that window
+ *   is linked into slot `(deadline / resolution) % S` of an intrusive
+ *   doubly-linked list, so schedule, reschedule and cancel are O(1);
+ * - a timer due beyond the window goes to an indexed d-ary heap
+ *   (indexed_heap) and is moved into the wheel once the window reaches it.
+ *
+ * pop_expired(now, out) walks the slots from the current one up to `now`,
+ * writing the ids of every timer with `deadline <= now`. Slots are visited
+ * in time order; timers that share a slot come out in no particular order.
+ *
+ * Timers are identified by dense integer ids (e.g. connection numbers), as
+ * in indexed_heap; per-id state grows to the largest id seen. Time is an
+ * unsigned tick count chosen by the caller (e.g. milliseconds).
+ *
+ * Not thread-safe.
+ *
+ * Requirements: C++17+
+ */
+
+#ifndef HEAP_UTILS_TIMER_QUEUE_HPP
+#define HEAP_UTILS_TIMER_QUEUE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+#include <heap_utils/indexed_heap.hpp>
+
+namespace heap_utils
+{
+  /**
+   * @brief Timing wheel for near deadlines, indexed heap for far ones.
+   *
+   * @tparam Tick Unsigned integer time type.
+   * @tparam D Arity of the far heap.
+   */
+  template <class Tick = std::uint64_t, std::size_t D = 4>
+  class timer_queue
+  {
+    static_assert(std::is_integral_v<Tick> && std::is_unsigned_v<Tick>,
+                  "heap_utils: timer_queue requires an unsigned integer Tick");
+
+  public:
+    using tick_type = Tick;
+    using id_type = std::size_t;
+    using size_type = std::size_t;
+
+    /**
+     * @param slots Number of wheel slots, a power of two; the wheel covers
+     *   `slots * resolution` ticks ahead of the current time.
+     * @param resolution Ticks per slot (at least 1).
+     * @param start Initial current time.
+     * @throws std::invalid_argument on a bad slot count or resolution.
+     */
+    explicit timer_queue(size_type slots = 4096, Tick resolution = 1, Tick start = 0)
+        : heads_(slots, npos), mask_(slots - 1), resolution_(resolution),
+          current_(start / (resolution ? resolution : 1))
+    {
+      if (slots == 0 || (slots & (slots - 1)) != 0)
+      {
+        throw std::invalid_argument("heap_utils: timer_queue slot count must be a power of two");
+      }
+      if (resolution == 0)
+      {
+        throw std::invalid_argument("heap_utils: timer_queue resolution must be at least 1");
+      }
+    }
+
+    /**
+     * @brief Arm timer `id` to expire at `deadline`, replacing any pending deadline.
+     *
+     * O(1) when the deadline falls inside the wheel (and the timer was not
+     * in the far heap); O(log n) otherwise. A deadline that is already
+     * past is returned by the next pop_expired().
+     *
+     * @throws std::length_error if `id` is npos.
+     */
+    void schedule(id_type id, Tick deadline)
+    {
+      if (id >= npos)
+      {
+        // npos ends the slot lists, and id + 1 below would wrap to zero.
+        throw std::length_error("heap_utils: timer_queue::schedule() id out of range");
+      }
+      if (id >= timers_.size())
+      {
+        timers_.resize(id + 1);
+      }
+      timer &t = timers_[id];
+      if (t.where == location::wheel)
+      {
+        unlink(id);
+      }
+      t.deadline = deadline;
+
+      const Tick slot = deadline / resolution_;
+      if (slot - (slot < current_ ? slot : current_) <= mask_)
+      {
+        if (t.where == location::far)
+        {
+          far_.erase(id);
+        }
+        link(id);
+      }
+      else
+      {
+        far_.push_or_update(id, deadline);
+        t.where = location::far;
+      }
+    }
+
+    /**
+     * @brief Disarm timer `id`.
+     * @return false if `id` was not pending.
+     */
+    bool cancel(id_type id)
+    {
+      if (!contains(id))
+      {
+        return false;
+      }
+      timer &t = timers_[id];
+      if (t.where == location::wheel)
+      {
+        unlink(id);
+      }
+      else
+      {
+        far_.erase(id);
+      }
+      t.where = location::none;
+      return true;
+    }
+
+    /**
+     * @brief True if timer `id` is pending.
+     */
+    bool contains(id_type id) const noexcept
+    {
+      return id < timers_.size() && timers_[id].where != location::none;
+    }
+
+    /**
+     * @brief Pending deadline of timer `id`.
+     * @throws std::out_of_range if `id` is not pending.
+     */
+    Tick deadline(id_type id) const
+    {
+      if (!contains(id))
+      {
+        throw std::out_of_range("heap_utils: timer_queue::deadline() on a timer that is not pending");
+      }
+      return timers_[id].deadline;
+    }
+
+    /**
+     * @brief Remove every timer with `deadline <= now` and write its id to `out`.
+     *
+     * Advances the current time to `now` (time never moves backwards: an
+     * earlier `now` only expires what is due by then). The work is one step
+     * per slot passed, plus O(1) per expired timer and O(log n) per far
+     * timer drawn into the wheel; an empty wheel jumps straight to the next
+     * far deadline.
+     *
+     * @return Output iterator past the last written id.
+     */
+    template <class OutputIt>
+    OutputIt pop_expired(Tick now, OutputIt out)
+    {
+      const Tick now_slot = now / resolution_;
+      while (current_ <= now_slot)
+      {
+        if (wheel_size_ == 0)
+        {
+          // Nothing near: skip the empty slots up to the next far deadline.
+          const Tick next = far_.empty() ? now_slot : far_.top_key() / resolution_;
+          current_ = (next < now_slot) ? (next > current_ ? next : current_) : now_slot;
+        }
+        refill();
+
+        id_type id = heads_[static_cast<size_type>(current_ & mask_)];
+        while (id != npos)
+        {
+          const id_type next = timers_[id].next;
+          if (timers_[id].deadline <= now)
+          {
+            unlink(id);
+            timers_[id].where = location::none;
+            *out = id;
+            ++out;
+          }
+          id = next;
+        }
+
+        if (current_ == now_slot)
+        {
+          break;
+        }
+        ++current_;
+      }
+      return out;
+    }
+
+    bool empty() const noexcept { return wheel_size_ == 0 && far_.empty(); }
+    size_type size() const noexcept { return wheel_size_ + far_.size(); }
+
+    /// Timers currently held in the wheel (the rest wait in the far heap).
+    size_type wheel_size() const noexcept { return wheel_size_; }
+
+    size_type slot_count() const noexcept { return heads_.size(); }
+    Tick resolution() const noexcept { return resolution_; }
+
+    /**
+     * @brief Pre-size per-timer state for ids in [0, n).
+     */
+    void reserve(size_type n)
+    {
+      if (n > timers_.size())
+      {
+        timers_.resize(n);
+      }
+      far_.reserve(n);
+    }
+
+    void clear() noexcept
+    {
+      for (timer &t : timers_)
+      {
+        t.where = location::none;
+      }
+      for (id_type &h : heads_)
+      {
+        h = npos;
+      }
+      far_.clear();
+      wheel_size_ = 0;
+    }
+
+  private:
+    static constexpr id_type npos = std::numeric_limits<id_type>::max();
+
+    enum class location : unsigned char
+    {
+      none,
+      wheel,
+      far
+    };
+
+    struct timer
+    {
+      Tick deadline = 0;
+      id_type prev = npos;
+      id_type next = npos;
+      location where = location::none;
+    };
+
+    /// Wheel slot of a timer due at `deadline`; overdue timers go to the current slot.
+    size_type slot_of(Tick deadline) const noexcept
+    {
+      const Tick slot = deadline / resolution_;
+      return static_cast<size_type>(((slot < current_) ? current_ : slot) & mask_);
+    }
+
+    void link(id_type id)
+    {
+      timer &t = timers_[id];
+      id_type &head = heads_[slot_of(t.deadline)];
+      t.where = location::wheel;
+      t.prev = npos;
+      t.next = head;
+      if (head != npos)
+      {
+        timers_[head].prev = id;
+      }
+      head = id;
+      ++wheel_size_;
+    }
+
+    /// Valid while the timer is in the wheel: the current slot never passes a pending timer.
+    void unlink(id_type id)
+    {
+      timer &t = timers_[id];
+      if (t.prev != npos)
+      {
+        timers_[t.prev].next = t.next;
+      }
+      else
+      {
+        heads_[slot_of(t.deadline)] = t.next;
+      }
+      if (t.next != npos)
+      {
+        timers_[t.next].prev = t.prev;
+      }
+      --wheel_size_;
+    }
+
+    /// Move far timers that the window [current_, current_ + S) now reaches into the wheel.
+    void refill()
+    {
+      while (!far_.empty() && far_.top_key() / resolution_ - current_ <= mask_)
+      {
+        const id_type id = far_.pop();
+        link(id);
+      }
+    }
+
+    std::vector<timer> timers_;
+    std::vector<id_type> heads_;
+    indexed_heap<Tick, std::greater<>, D> far_;
+    Tick mask_;
+    Tick resolution_;
+    Tick current_;
+    size_type wheel_size_ = 0;
+  };
+
+} // namespace heap_utils
+
+#endif // HEAP_UTILS_TIMER_QUEUE_HPP
@@ -0,0 +1,229 @@
+/**
+ * @file work_stealing.hpp
+ * @brief Sharded priority scheduler: one heap per worker plus batch stealing.
+ *
+ * Each worker owns a local heap driven by heap_push / heap_pop. Its lock is
+ * only contended while a thief is stealing, so the owner's fast path is an
+ * uncontended lock plus an O(log n) sift on data that stays in the worker's
+ * cache (and NUMA node).
+ *
+ * A worker whose heap is empty steals from a victim: of two random
+ * candidates it takes the fuller one, removes its best `steal_batch`
+ * elements (at most half of them) with heap_pop_n, keeps the best one and
+ * pushes the rest into its own heap with heap_push_range.
+ *
+ * Ordering is per worker: try_pop() returns the best element of the
+ * caller's heap, not the global best. Use multi_queue for a bounded global
+ * rank error, or a strict multi_queue for exact order.
+ *
+ * Link with Threads::Threads (or -pthread) when using this header.
+ *
+ * Requirements: C++17+
+ */
+
+#ifndef HEAP_UTILS_WORK_STEALING_HPP
+#define HEAP_UTILS_WORK_STEALING_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+#include <heap_utils/heap_utils.hpp>
+#include <heap_utils/multi_queue.hpp>
+
+namespace heap_utils
+{
+  /**
+   * @brief Per-worker priority heaps with work stealing.
+   *
+   * push() may be called from any thread. try_pop(w) must only be called by
+   * the thread acting as worker `w` (one caller per worker index).
+   *
+   * @tparam T Task type.
+   * @tparam Compare Heap comparator (default: max-heap via std::less<>).
+   */
+  template <class T, class Compare = std::less<>>
+  class work_stealing_scheduler
+  {
+  public:
+    using value_type = T;
+    using size_type = std::size_t;
+    using value_compare = Compare;
+
+    /**
+     * @param workers Number of worker heaps (at least 1).
+     * @param comp Heap comparator.
+     * @param steal_batch Maximum number of elements taken per steal.
+     */
+    explicit work_stealing_scheduler(std::size_t workers, Compare comp = Compare{},
+                                     std::size_t steal_batch = 32)
+        : comp_(comp), count_((workers == 0) ? 1 : workers),
+          batch_((steal_batch == 0) ? 1 : steal_batch), shards_(new shard[count_])
+    {
+    }
+
+    work_stealing_scheduler(const work_stealing_scheduler &) = delete;
+    work_stealing_scheduler &operator=(const work_stealing_scheduler &) = delete;
+
+    /**
+     * @brief Push a task onto worker `w`'s heap (any thread).
+     */
+    void push(std::size_t w, const T &value) { put(shards_[w], T(value)); }
+    void push(std::size_t w, T &&value) { put(shards_[w], std::move(value)); }
+
+    /**
+     * @brief Pop the best task of worker `w`'s heap, stealing a batch if it is empty.
+     *
+     * @return false if the local heap was empty and nothing could be stolen.
+     */
+    bool try_pop(std::size_t w, T &out)
+    {
+      shard &own = shards_[w];
+      if (own.size.load(std::memory_order_relaxed) != 0)
+      {
+        std::lock_guard<std::mutex> hold(own.lock);
+        if (!own.data.empty())
+        {
+          take(own, out);
+          return true;
+        }
+      }
+      return steal(w, out);
+    }
+
+    /**
+     * @brief Approximate number of queued tasks (exact when no operation is in flight).
+     */
+    size_type size() const noexcept
+    {
+      size_type n = 0;
+      for (std::size_t i = 0; i < count_; ++i)
+      {
+        n += shards_[i].size.load(std::memory_order_relaxed);
+      }
+      return n;
+    }
+
+    bool empty() const noexcept { return size() == 0; }
+
+    /// Approximate number of tasks queued on worker `w`.
+    size_type size(std::size_t w) const noexcept { return shards_[w].size.load(std::memory_order_relaxed); }
+
+    size_type worker_count() const noexcept { return count_; }
+    size_type steal_batch() const noexcept { return batch_; }
+
+    /// Number of successful steals so far (all workers).
+    size_type steal_count() const noexcept { return steals_.load(std::memory_order_relaxed); }
+
+    const Compare &value_comp() const noexcept { return comp_; }
+
+  private:
+    struct alignas(64) shard
+    {
+      std::mutex lock;
+      std::vector<T> data;
+      std::atomic<std::size_t> size{0};
+      std::vector<T> loot; // owner-only scratch buffer for steals
+    };
+
+    void put(shard &q, T &&value)
+    {
+      std::lock_guard<std::mutex> hold(q.lock);
+      heap_push(q.data, std::move(value), comp_);
+      q.size.store(q.data.size(), std::memory_order_relaxed);
+    }
+
+    void take(shard &q, T &out)
+    {
+      out = heap_pop(q.data, comp_);
+      q.size.store(q.data.size(), std::memory_order_relaxed);
+    }
+
+    std::size_t pick_victim(std::size_t thief) const noexcept
+    {
+      const std::size_t a = static_cast<std::size_t>(detail::sample_random() % count_);
+      const std::size_t b = static_cast<std::size_t>(detail::sample_random() % count_);
+      if (a == thief)
+      {
+        return b;
+      }
+      if (b == thief)
+      {
+        return a;
+      }
+      return (shards_[a].size.load(std::memory_order_relaxed) >= shards_[b].size.load(std::memory_order_relaxed))
+                 ? a
+                 : b;
+    }
+
+    /// Move up to batch_ best tasks of `victim` into `thief`'s heap; the best one goes to `out`.
+    bool steal_from(std::size_t thief, std::size_t victim, T &out)
+    {
+      shard &v = shards_[victim];
+      shard &own = shards_[thief];
+      {
+        std::lock_guard<std::mutex> hold(v.lock);
+        const std::size_t n = v.data.size();
+        if (n == 0)
+        {
+          return false;
+        }
+        const std::size_t half = (n + 1) / 2;
+        heap_pop_n(v.data, (half < batch_) ? half : batch_, std::back_inserter(own.loot), comp_);
+        v.size.store(v.data.size(), std::memory_order_relaxed);
+      }
+
+      out = std::move(own.loot.front());
+      if (own.loot.size() > 1)
+      {
+        std::lock_guard<std::mutex> hold(own.lock);
+        heap_push_range(own.data, std::make_move_iterator(own.loot.begin() + 1),
+                        std::make_move_iterator(own.loot.end()), comp_);
+        own.size.store(own.data.size(), std::memory_order_relaxed);
+      }
+      own.loot.clear();
+      steals_.fetch_add(1, std::memory_order_relaxed);
+      return true;
+    }
+
+    bool steal(std::size_t thief, T &out)
+    {
+      if (count_ == 1)
+      {
+        return false;
+      }
+      for (std::size_t attempt = 0; attempt < count_; ++attempt)
+      {
+        const std::size_t victim = pick_victim(thief);
+        if (victim != thief && shards_[victim].size.load(std::memory_order_relaxed) != 0 &&
+            steal_from(thief, victim, out))
+        {
+          return true;
+        }
+      }
+      for (std::size_t k = 1; k < count_; ++k)
+      {
+        const std::size_t victim = (thief + k) % count_;
+        if (shards_[victim].size.load(std::memory_order_relaxed) != 0 && steal_from(thief, victim, out))
+        {
+          return true;
+        }
+      }
+      return false;
+    }
+
+    Compare comp_;
+    std::size_t count_;
+    std::size_t batch_;
+    std::unique_ptr<shard[]> shards_;
+    std::atomic<std::size_t> steals_{0};
+  };
+
+} // namespace heap_utils
+
+#endif // HEAP_UTILS_WORK_STEALING_HPP
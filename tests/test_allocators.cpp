@@ -0,0 +1,181 @@
+#include <heap_utils/allocators.hpp>
+#include <heap_utils/d_ary_heap.hpp>
+#include <heap_utils/heap_utils.hpp>
+#include <heap_utils/pairing_heap.hpp>
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <memory_resource>
+#include <string>
+#include <vector>
+
+template <class Heap>
+static void fill_and_drain(Heap &h)
+{
+  for (int i = 0; i < 5000; ++i)
+  {
+    h.push((i * 7919) % 1009);
+  }
+  int prev = 1 << 30;
+  while (!h.empty())
+  {
+    const int x = h.pop();
+    assert(x <= prev);
+    prev = x;
+  }
+}
+
+static void test_pairing_heap_with_pool()
+{
+  heap_utils::fixed_pool pool(256);
+  heap_utils::pairing_heap<int, std::less<>, heap_utils::pool_allocator<int>> h{
+      heap_utils::pool_allocator<int>(pool)};
+
+  fill_and_drain(h);
+  assert(pool.block_size() >= heap_utils::pairing_heap<int>::node_size);
+
+  // Blocks are recycled: a second round reuses the same chunks.
+  fill_and_drain(h);
+}
+
+static void test_pairing_heap_with_arena()
+{
+  heap_utils::arena a(4096);
+  {
+    heap_utils::pairing_heap<std::string, std::greater<>, heap_utils::arena_allocator<std::string>> h{
+        heap_utils::arena_allocator<std::string>(a)};
+    h.push("pear");
+    h.push("apple");
+    h.push("fig");
+    auto handle = h.push("zucchini");
+    h.decrease_key(handle, "aardvark");
+    assert(h.pop() == "aardvark");
+    assert(h.pop() == "apple");
+    assert(h.size() == 2);
+  }
+  assert(a.bytes_reserved() > 0);
+  a.release();
+  assert(a.bytes_reserved() == 0);
+}
+
+static void test_pmr_heaps()
+{
+  heap_utils::fixed_pool pool;
+  std::pmr::polymorphic_allocator<int> alloc(&pool);
+
+  heap_utils::pairing_heap<int, std::less<>, std::pmr::polymorphic_allocator<int>> ph(alloc);
+  fill_and_drain(ph);
+
+  heap_utils::pairing_heap<int, std::less<>, std::pmr::polymorphic_allocator<int>> other(alloc);
+  ph.push(1);
+  other.push(2);
+  ph.merge(other);
+  assert(other.empty());
+  assert(ph.pop() == 2);
+
+  heap_utils::arena vec_arena;
+  std::pmr::polymorphic_allocator<int> vec_alloc(&vec_arena);
+
+  heap_utils::d_ary_heap<int, 4, std::less<>, std::pmr::polymorphic_allocator<int>> dh(vec_alloc);
+  fill_and_drain(dh);
+  assert(dh.get_allocator().resource() == &vec_arena);
+
+  heap_utils::binary_heap<int, std::less<>, std::pmr::polymorphic_allocator<int>> bh(vec_alloc);
+  fill_and_drain(bh);
+
+  std::pmr::vector<int> v(&vec_arena);
+  heap_utils::heap_push(v, 3);
+  heap_utils::heap_push(v, 9);
+  heap_utils::heap_push(v, 5);
+  assert(heap_utils::heap_top(v) == 9);
+  assert(heap_utils::heap_pop(v) == 9);
+  heap_utils::d_ary_heap_push<4>(v, 1);
+  assert(heap_utils::d_ary_heap_pop<4>(v) == 5);
+}
+
+static void test_merge_with_unequal_allocators()
+{
+  heap_utils::fixed_pool p1;
+  heap_utils::fixed_pool p2;
+  using alloc_t = heap_utils::pool_allocator<int>;
+  heap_utils::pairing_heap<int, std::less<>, alloc_t> a{alloc_t(p1)};
+  heap_utils::pairing_heap<int, std::less<>, alloc_t> b{alloc_t(p2)};
+
+  a.push(1);
+  b.push(3);
+  b.push(2);
+  a.merge(b);
+  assert(b.empty());
+  assert(a.size() == 3);
+  assert(a.pop() == 3);
+  assert(a.pop() == 2);
+  assert(a.pop() == 1);
+}
+
+static void test_vector_merge_with_unequal_allocators()
+{
+  // No swap: `a` stays on its own resource, and the batch from `b` is large
+  // enough to take the rebuild path.
+  heap_utils::arena ra;
+  heap_utils::arena rb;
+  using alloc_t = std::pmr::polymorphic_allocator<int>;
+  for (std::size_t nb : {std::size_t{5}, std::size_t{500}})
+  {
+    std::vector<int, alloc_t> a{alloc_t(&ra)};
+    std::vector<int, alloc_t> b{alloc_t(&rb)};
+    for (int i = 0; i < 10; ++i)
+    {
+      a.push_back((i * 7) % 13);
+    }
+    for (std::size_t i = 0; i < nb; ++i)
+    {
+      b.push_back(static_cast<int>((i * 31) % 211));
+    }
+    std::vector<int> all(a.begin(), a.end());
+    all.insert(all.end(), b.begin(), b.end());
+    heap_utils::heapify(a.begin(), a.end());
+    heap_utils::heapify(b.begin(), b.end());
+    assert(heap_utils::heap_push_range_should_rebuild(a.size(), b.size()) == (nb == 500));
+
+    heap_utils::heap_merge(a, std::move(b));
+    assert(b.empty() && a.get_allocator().resource() == &ra);
+    assert(a.size() == all.size() && heap_utils::is_heap(a.begin(), a.end()));
+    std::sort(all.begin(), all.end());
+    std::vector<int> got(a.begin(), a.end());
+    std::sort(got.begin(), got.end());
+    assert(got == all);
+  }
+}
+
+static void test_aligned_allocator()
+{
+  using alloc_t = heap_utils::aligned_allocator<int, 4096>;
+  std::vector<int, alloc_t> v(3000);
+  assert(reinterpret_cast<std::uintptr_t>(v.data()) % 4096 == 0);
+
+  heap_utils::d_ary_heap<int, 4, std::less<>, alloc_t> h;
+  fill_and_drain(h);
+  assert(reinterpret_cast<std::uintptr_t>(h.container().data()) % 4096 == 0);
+
+  // Rebinding keeps the alignment.
+  std::allocator_traits<alloc_t>::rebind_alloc<double> d;
+  double *p = d.allocate(10);
+  assert(reinterpret_cast<std::uintptr_t>(p) % 4096 == 0);
+  d.deallocate(p, 10);
+  assert(alloc_t{} == d);
+}
+
+int main()
+{
+  test_pairing_heap_with_pool();
+  test_pairing_heap_with_arena();
+  test_pmr_heaps();
+  test_merge_with_unequal_allocators();
+  test_vector_merge_with_unequal_allocators();
+  test_aligned_allocator();
+  return 0;
+}
@@ -1,6 +1,13 @@
 #include <heap_utils/heap_utils.hpp>
 
+#include <algorithm>
+#include <array>
 #include <cassert>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <iterator>
+#include <list>
 #include <stdexcept>
 #include <vector>
 
@@ -64,6 +71,250 @@ static void test_top_k_largest_and_smallest()
   assert(all.back() == 1);
 }
 
+static void test_bounded_top_k_streaming()
+{
+  std::vector<int> data{7, 1, 9, 2, 8, 3, 6, 4, 5};
+
+  const auto top3 = heap_utils::top_k(data.begin(), data.end(), 3);
+  assert((top3 == heap_utils::largest_k(data, 3)));
+
+  const auto small4 = heap_utils::top_k(data.begin(), data.end(), 4, std::greater<>{});
+  assert((small4 == heap_utils::smallest_k(data, 4)));
+
+  // Single-pass style iteration over a non-random-access range.
+  std::list<int> lst(data.begin(), data.end());
+  const auto all = heap_utils::top_k(lst.begin(), lst.end(), 100);
+  assert((all == heap_utils::largest_k(data, 100)));
+
+  assert(heap_utils::top_k(data.begin(), data.end(), 0).empty());
+  assert(heap_utils::top_k(data.end(), data.end(), 3).empty());
+
+  heap_utils::bounded_top_k<int> acc(2);
+  assert(acc.empty());
+  assert(acc.push(5));
+  assert(acc.push(1));
+  assert(acc.full());
+  assert(acc.worst() == 1);
+  assert(!acc.push(0));
+  assert(acc.push(7));
+  assert(acc.worst() == 5);
+  assert((acc.take_sorted() == std::vector<int>{7, 5}));
+  assert(acc.empty());
+
+  heap_utils::bounded_top_k<int> none(0);
+  assert(!none.push(1));
+  assert(none.take_sorted().empty());
+
+  // k far beyond the input: nothing may be allocated up front.
+  const std::list<int> three{2, 9, 4};
+  assert((heap_utils::top_k(three.begin(), three.end(), SIZE_MAX) == std::vector<int>{9, 4, 2}));
+  assert((heap_utils::top_k(three.begin(), three.end(), std::size_t{1} << 40, std::greater<>{}) ==
+          std::vector<int>{2, 4, 9}));
+  assert((heap_utils::top_k(data.begin(), data.end(), SIZE_MAX).size() == data.size()));
+
+  heap_utils::bounded_top_k<int> unbounded(SIZE_MAX);
+  for (int x : data)
+  {
+    assert(unbounded.push(x));
+  }
+  assert(!unbounded.full());
+  unbounded.reserve(16);
+  assert((unbounded.take_sorted() == heap_utils::largest_k(data, data.size())));
+}
+
+static void test_top_k_strategies_agree()
+{
+  std::vector<int> data;
+  for (int i = 0; i < 500; ++i)
+  {
+    data.push_back((i * 7919) % 263);
+  }
+
+  using heap_utils::top_k_strategy;
+  for (std::size_t k : {std::size_t{1}, std::size_t{5}, std::size_t{50}, std::size_t{499}, std::size_t{1000}})
+  {
+    const auto expected = heap_utils::top_k(data, k, std::less<>{}, top_k_strategy::heap_pop);
+    assert(expected.size() == std::min(k, data.size()));
+    assert((heap_utils::top_k(data, k, std::less<>{}, top_k_strategy::bounded_heap) == expected));
+    assert((heap_utils::top_k(data, k, std::less<>{}, top_k_strategy::selection) == expected));
+    assert((heap_utils::top_k(data, k, std::less<>{}, top_k_strategy::automatic) == expected));
+    assert((heap_utils::top_k(data, k) == expected));
+
+    const auto asc = heap_utils::top_k(data, k, std::greater<>{}, top_k_strategy::heap_pop);
+    assert((heap_utils::top_k_select(data, k, std::greater<>{}) == asc));
+  }
+
+  assert(heap_utils::choose_top_k_strategy(1000000, 10, sizeof(int)) == top_k_strategy::bounded_heap);
+  assert(heap_utils::choose_top_k_strategy(1000000, 100000, sizeof(int)) == top_k_strategy::selection);
+  assert(heap_utils::choose_top_k_strategy(10, 10, sizeof(int)) == top_k_strategy::selection);
+}
+
+static void test_binary_heap_engine()
+{
+  heap_utils::binary_heap<int, std::greater<>> h(std::vector<int>{5, 3, 8});
+  h.push(1);
+  assert(h.size() == 4);
+  assert(h.top() == 1);
+  assert(heap_utils::is_heap(h.container().begin(), h.container().end(), std::greater<>{}));
+  assert(h.pop() == 1);
+  assert(h.pop() == 3);
+  assert(h.pop() == 5);
+  assert(h.pop() == 8);
+  assert(h.empty());
+}
+
+static void test_generic_containers()
+{
+  std::deque<int> dq;
+  heap_utils::heap_push(dq, 3);
+  heap_utils::heap_push(dq, 8);
+  heap_utils::heap_push(dq, 5);
+  assert(heap_utils::heap_top(dq) == 8);
+  assert(heap_utils::heap_pop(dq) == 8);
+  assert(heap_utils::heap_pop(dq) == 5);
+
+  std::vector<long> wide;
+  heap_utils::heap_push(wide, 1); // value converts to the container's value_type
+  heap_utils::heap_push(wide, 2);
+  assert(heap_utils::heap_top(wide) == 2L);
+
+  int raw[] = {9, 4, 7};
+  heap_utils::heapify(std::begin(raw), std::end(raw));
+  assert(heap_utils::heap_top(raw) == 9);
+}
+
+static void test_batch_push_and_bulk_pop()
+{
+  std::vector<int> batch;
+  for (int i = 0; i < 300; ++i)
+  {
+    batch.push_back((i * 131) % 97);
+  }
+
+  // Small heap + large batch: rebuild path.
+  std::vector<int> h{50, 20};
+  heap_utils::heapify(h.begin(), h.end());
+  heap_utils::heap_push_range(h, batch.begin(), batch.end());
+  assert(h.size() == 302);
+  assert(heap_utils::is_heap(h.begin(), h.end()));
+
+  // Large heap + small batch from a single-pass range: sift-up path.
+  std::list<int> extra{1000, -5, 42};
+  heap_utils::heap_push_range(h, extra.begin(), extra.end());
+  assert(h.size() == 305);
+  assert(heap_utils::is_heap(h.begin(), h.end()));
+  assert(heap_utils::heap_top(h) == 1000);
+
+  std::vector<int> reference = h;
+  std::sort(reference.begin(), reference.end(), std::greater<>{});
+
+  std::vector<int> out;
+  heap_utils::heap_pop_n(h, 10, std::back_inserter(out));
+  assert((out == std::vector<int>(reference.begin(), reference.begin() + 10)));
+  assert(h.size() == 295);
+  assert(heap_utils::is_heap(h.begin(), h.end()));
+
+  heap_utils::heap_pop_n(h, 1000, std::back_inserter(out));
+  assert(out == reference);
+  assert(h.empty());
+
+  std::vector<int> mh;
+  heap_utils::heap_push_range(mh, batch.begin(), batch.end(), std::greater<>{});
+  int smallest[3];
+  heap_utils::heap_pop_n(mh, 3, smallest, std::greater<>{});
+  assert(smallest[0] == 0 && smallest[1] <= smallest[2]);
+}
+
+static void test_replace_top_and_pushpop()
+{
+  std::vector<int> h = {5, 1, 8, 3, 9, 2, 7};
+  heap_utils::heapify(h.begin(), h.end());
+  std::vector<int> ref = h;
+
+  for (int x : {4, 10, 0, 6, 6, 11})
+  {
+    const int got = heap_utils::heap_replace_top(h, x);
+    const int want = heap_utils::heap_pop(ref);
+    heap_utils::heap_push(ref, x);
+    assert(got == want);
+    assert(heap_utils::is_heap(h.begin(), h.end()));
+    assert(h.size() == ref.size());
+  }
+  std::sort(h.begin(), h.end());
+  std::sort(ref.begin(), ref.end());
+  assert(h == ref);
+
+  // pushpop: a value at least as good as the top comes straight back.
+  std::vector<int> m = {1, 4, 2, 8};
+  heap_utils::heapify(m.begin(), m.end(), std::greater<>{});
+  assert(heap_utils::heap_pushpop(m, 0, std::greater<>{}) == 0);
+  assert(heap_utils::heap_pushpop(m, 1, std::greater<>{}) == 1);
+  assert(heap_utils::heap_pushpop(m, 5, std::greater<>{}) == 1);
+  assert(heap_utils::is_heap(m.begin(), m.end(), std::greater<>{}));
+  assert(heap_utils::heap_top(m) == 2);
+  assert(m.size() == 4);
+
+  std::vector<int> empty;
+  assert(heap_utils::heap_pushpop(empty, 3) == 3);
+  assert(empty.empty());
+
+  int raw[] = {9, 4, 7, 1};
+  assert(heap_utils::heap_replace_top(raw, 3) == 9);
+  assert(heap_utils::is_heap(std::begin(raw), std::end(raw)));
+  assert(raw[0] == 7);
+
+  bool threw = false;
+  try
+  {
+    (void)heap_utils::heap_replace_top(empty, 1);
+  }
+  catch (const std::runtime_error &)
+  {
+    threw = true;
+  }
+  assert(threw);
+}
+
+static void test_heap_merge()
+{
+  // Every size ratio, including each side empty and the rebuild path.
+  for (std::size_t na : {0u, 1u, 10u, 300u})
+  {
+    for (std::size_t nb : {0u, 1u, 10u, 300u})
+    {
+      std::vector<int> a;
+      std::vector<int> b;
+      for (std::size_t i = 0; i < na; ++i)
+      {
+        a.push_back(static_cast<int>((i * 37) % 101));
+      }
+      for (std::size_t i = 0; i < nb; ++i)
+      {
+        b.push_back(static_cast<int>((i * 53) % 97));
+      }
+      std::vector<int> all = a;
+      all.insert(all.end(), b.begin(), b.end());
+      heap_utils::heapify(a.begin(), a.end(), std::greater<>{});
+      heap_utils::heapify(b.begin(), b.end(), std::greater<>{});
+
+      heap_utils::heap_merge(a, std::move(b), std::greater<>{});
+      assert(b.empty());
+      assert(a.size() == na + nb);
+      assert(heap_utils::is_heap(a.begin(), a.end(), std::greater<>{}));
+      std::sort(a.begin(), a.end());
+      std::sort(all.begin(), all.end());
+      assert(a == all);
+    }
+  }
+
+  heap_utils::binary_heap<int> x(std::vector<int>{3, 9, 1});
+  heap_utils::binary_heap<int> y(std::vector<int>{7, 12, 5, 4});
+  x.merge(std::move(y));
+  assert(y.empty());
+  assert(x.size() == 7);
+  assert(x.pop() == 12 && x.pop() == 9 && x.pop() == 7);
+}
+
 static void test_errors_on_empty()
 {
   std::vector<int> h;
@@ -91,11 +342,158 @@ static void test_errors_on_empty()
   assert(threw);
 }
 
+namespace
+{
+  struct scored
+  {
+    int score;
+    int id;
+  };
+
+  struct by_score
+  {
+    bool operator()(const scored &a, const scored &b) const { return a.score < b.score; }
+  };
+
+  std::vector<int> ids(const std::vector<scored> &v)
+  {
+    std::vector<int> out;
+    for (const scored &s : v)
+    {
+      out.push_back(s.id);
+    }
+    return out;
+  }
+} // namespace
+
+static void test_stable_top_k_and_ties()
+{
+  std::vector<scored> data;
+  const int scores[] = {5, 9, 7, 9, 5, 7, 7, 3, 7, 9, 1, 7};
+  for (int i = 0; i < 12; ++i)
+  {
+    data.push_back(scored{scores[i], i});
+  }
+
+  // Three 9s, then the earliest of the five 7s.
+  assert((ids(heap_utils::top_k_stable(data, 4, by_score{})) == std::vector<int>{1, 3, 9, 2}));
+  assert((ids(heap_utils::top_k_stable(data, 3, by_score{})) == std::vector<int>{1, 3, 9}));
+  assert((ids(heap_utils::top_k_stable(data, 20, by_score{})) ==
+          std::vector<int>{1, 3, 9, 2, 5, 6, 8, 11, 0, 4, 7, 10}));
+
+  // Everything tied with the 4th: all the 7s, in input order.
+  assert((ids(heap_utils::top_k_with_ties(data, 4, by_score{})) == std::vector<int>{1, 3, 9, 2, 5, 6, 8, 11}));
+  assert((ids(heap_utils::top_k_with_ties(data, 3, by_score{})) == std::vector<int>{1, 3, 9}));
+  assert((ids(heap_utils::top_k_with_ties(data, 2, by_score{})) == std::vector<int>{1, 3, 9}));
+
+  // Min-order on plain ints, heavy duplication.
+  std::vector<int> dups(100000, 4);
+  dups[500] = 2;
+  dups[70000] = 1;
+  assert((heap_utils::top_k_stable(dups, 3, std::greater<>{}) == std::vector<int>{1, 2, 4}));
+  const std::vector<int> tied = heap_utils::top_k_with_ties(dups, 3, std::greater<>{});
+  assert(tied.size() == dups.size() && tied[0] == 1 && tied[1] == 2 && tied.back() == 4);
+
+  // Single-pass-style input with k far beyond its size.
+  const std::list<scored> few(data.begin(), data.begin() + 4);
+  assert((ids(heap_utils::top_k_stable(few.begin(), few.end(), SIZE_MAX, by_score{})) ==
+          std::vector<int>{1, 3, 2, 0}));
+  assert((ids(heap_utils::top_k_with_ties(few.begin(), few.end(), std::size_t{1} << 40, by_score{})) ==
+          std::vector<int>{1, 3, 2, 0}));
+
+  // Ties accumulated early are dropped once better elements raise the bar.
+  std::list<int> stream{1, 1, 1, 1, 5, 6};
+  assert((heap_utils::top_k_with_ties(stream.begin(), stream.end(), 2) == std::vector<int>{6, 5}));
+
+  assert(heap_utils::top_k_stable(data, 0, by_score{}).empty());
+  assert(heap_utils::top_k_with_ties(std::vector<int>{}, 3).empty());
+}
+
+static void test_fixed_size_top_k()
+{
+  const std::array<int, 10> data{5, 1, 9, 3, 9, 7, 2, 8, 6, 4};
+  const std::vector<int> v(data.begin(), data.end());
+
+  const std::array<int, 4> best = heap_utils::top_k<4>(data);
+  assert((std::vector<int>(best.begin(), best.end()) == heap_utils::top_k(v, 4)));
+
+  const std::array<int, 3> low = heap_utils::top_k<3>(data, std::greater<>{});
+  assert((low == std::array<int, 3>{1, 2, 3}));
+
+  const std::array<int, 10> all = heap_utils::top_k<10>(data);
+  assert(std::is_sorted(all.begin(), all.end(), std::greater<>{}));
+  assert(heap_utils::top_k<0>(data).empty());
+}
+
+#if defined(HEAP_UTILS_HAS_CONSTEXPR_ALGORITHMS)
+// A static priority table built by the compiler.
+struct task
+{
+  int priority;
+  int id;
+};
+
+struct by_priority
+{
+  constexpr bool operator()(const task &a, const task &b) const { return a.priority < b.priority; }
+};
+
+constexpr std::array<task, 6> tasks{{{3, 0}, {8, 1}, {1, 2}, {6, 3}, {8, 4}, {2, 5}}};
+constexpr auto urgent = heap_utils::top_k<3>(tasks, by_priority{});
+static_assert(urgent[0].priority == 8 && urgent[1].priority == 8 && urgent[2].id == 3);
+
+constexpr std::array<int, 5> make_heap_table()
+{
+  std::array<int, 5> a{4, 9, 1, 7, 3};
+  heap_utils::heapify(a.begin(), a.end());
+  return a;
+}
+constexpr std::array<int, 5> heap_table = make_heap_table();
+static_assert(heap_table[0] == 9);
+static_assert(heap_utils::is_heap(heap_table.begin(), heap_table.end()));
+
+constexpr int replace_and_pushpop()
+{
+  std::array<int, 5> a = make_heap_table();
+  const int old = heap_utils::heap_replace_top(a, 2);
+  return old * 100 + heap_utils::heap_pushpop(a, 5) * 10 + a[0];
+}
+static_assert(replace_and_pushpop() == 975);
+#endif
+
+#if defined(HEAP_UTILS_HAS_CONSTEXPR_VECTOR)
+constexpr int drain_sum()
+{
+  std::vector<int> h;
+  for (int x : {5, 1, 9, 3, 7})
+  {
+    heap_utils::heap_push(h, x);
+  }
+  int acc = 0;
+  while (!h.empty())
+  {
+    acc = acc * 10 + heap_utils::heap_pop(h);
+  }
+  return acc;
+}
+static_assert(drain_sum() == 97531);
+static_assert(heap_utils::top_k(std::vector<int>{4, 9, 1, 7}, 2)[1] == 7);
+#endif
+
 int main()
 {
   test_heapify_and_basic_push_pop_max_heap();
   test_min_heap_with_greater();
   test_top_k_largest_and_smallest();
+  test_bounded_top_k_streaming();
+  test_top_k_strategies_agree();
+  test_binary_heap_engine();
+  test_generic_containers();
+  test_batch_push_and_bulk_pop();
+  test_replace_top_and_pushpop();
+  test_heap_merge();
   test_errors_on_empty();
+  test_fixed_size_top_k();
+  test_stable_top_k_and_ties();
   return 0;
 }
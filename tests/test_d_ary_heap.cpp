@@ -0,0 +1,219 @@
+#include <heap_utils/d_ary_heap.hpp>
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <functional>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+template <std::size_t D>
+static void check_free_functions()
+{
+  std::vector<int> h;
+  for (int i = 0; i < 200; ++i)
+  {
+    heap_utils::d_ary_heap_push<D>(h, (i * 37) % 101);
+    assert(heap_utils::d_ary_is_heap<D>(h.begin(), h.end()));
+  }
+
+  std::vector<int> popped;
+  while (!h.empty())
+  {
+    popped.push_back(heap_utils::d_ary_heap_pop<D>(h));
+    assert(heap_utils::d_ary_is_heap<D>(h.begin(), h.end()));
+  }
+  assert(std::is_sorted(popped.begin(), popped.end(), std::greater<>{}));
+
+  std::vector<int> v{5, 3, 8, 1, 9, 2, 7, 4, 6, 0};
+  heap_utils::d_ary_heapify<D>(v.begin(), v.end(), std::greater<>{});
+  assert(heap_utils::d_ary_is_heap<D>(v.begin(), v.end(), std::greater<>{}));
+  assert(v.front() == 0);
+}
+
+static void test_free_functions_all_arities()
+{
+  check_free_functions<2>();
+  check_free_functions<3>();
+  check_free_functions<4>();
+  check_free_functions<8>();
+}
+
+static void test_container_push_pop_top()
+{
+  heap_utils::d_ary_heap<int, 4, std::greater<>> h;
+  assert(h.empty());
+
+  for (int x : {7, 2, 9, 1, 5})
+  {
+    h.push(x);
+  }
+  h.emplace(3);
+  assert(h.size() == 6);
+  assert(h.top() == 1);
+
+  std::vector<int> order;
+  while (!h.empty())
+  {
+    order.push_back(h.pop());
+  }
+  assert((order == std::vector<int>{1, 2, 3, 5, 7, 9}));
+}
+
+static void test_container_heapify_with_strings()
+{
+  heap_utils::d_ary_heap<std::string, 8> h(std::vector<std::string>{"pear", "apple", "zucchini", "kiwi"});
+  assert(h.top() == "zucchini");
+
+  h.heapify({"b", "c", "a"});
+  assert(h.size() == 3);
+  assert(h.pop() == "c");
+  assert(h.pop() == "b");
+  assert(h.pop() == "a");
+
+  const auto raw = h.release();
+  assert(raw.empty());
+}
+
+template <class T, std::size_t D, class Compare>
+static void check_arithmetic_keys()
+{
+  // Many duplicates so ties inside a child group are exercised.
+  std::vector<T> v;
+  for (int i = 0; i < 1000; ++i)
+  {
+    v.push_back(static_cast<T>((i * 7919) % 61));
+  }
+  v.push_back(static_cast<T>(-1)); // wraps for unsigned keys
+
+  heap_utils::d_ary_heap<T, D, Compare> h(v);
+  assert(heap_utils::d_ary_is_heap<D>(h.container().begin(), h.container().end(), Compare{}));
+
+  std::vector<T> expected = v;
+  std::sort(expected.begin(), expected.end(), [](const T &a, const T &b)
+            { return Compare{}(b, a); });
+
+  std::vector<T> popped;
+  while (!h.empty())
+  {
+    popped.push_back(h.pop());
+  }
+  assert(popped == expected);
+}
+
+template <class T>
+static void check_arithmetic_keys_all()
+{
+  check_arithmetic_keys<T, 4, std::less<>>();
+  check_arithmetic_keys<T, 4, std::greater<>>();
+  check_arithmetic_keys<T, 8, std::less<T>>();
+  check_arithmetic_keys<T, 8, std::greater<T>>();
+}
+
+static void test_arithmetic_keys_match_sorted_order()
+{
+  check_arithmetic_keys_all<std::int32_t>();
+  check_arithmetic_keys_all<std::uint32_t>();
+  check_arithmetic_keys_all<std::int64_t>();
+  check_arithmetic_keys_all<std::uint64_t>();
+  check_arithmetic_keys_all<float>();
+  check_arithmetic_keys_all<double>();
+}
+
+template <std::size_t D>
+static void check_merge(std::size_t na, std::size_t nb)
+{
+  std::vector<int> a;
+  std::vector<int> b;
+  for (std::size_t i = 0; i < na; ++i)
+  {
+    a.push_back(static_cast<int>((i * 37) % 101));
+  }
+  for (std::size_t i = 0; i < nb; ++i)
+  {
+    b.push_back(static_cast<int>((i * 53) % 97));
+  }
+  std::vector<int> all = a;
+  all.insert(all.end(), b.begin(), b.end());
+  heap_utils::d_ary_heapify<D>(a.begin(), a.end());
+  heap_utils::d_ary_heapify<D>(b.begin(), b.end());
+
+  heap_utils::d_ary_heap_merge<D>(a, std::move(b));
+  assert(b.empty());
+  assert(heap_utils::d_ary_is_heap<D>(a.begin(), a.end()));
+  std::sort(a.begin(), a.end());
+  std::sort(all.begin(), all.end());
+  assert(a == all);
+}
+
+static void test_merge()
+{
+  for (std::size_t na : {0u, 5u, 40u, 500u})
+  {
+    for (std::size_t nb : {0u, 5u, 40u, 500u})
+    {
+      check_merge<2>(na, nb);
+      check_merge<4>(na, nb);
+      check_merge<8>(na, nb);
+    }
+  }
+
+  heap_utils::d_ary_heap<int, 4, std::greater<>> x(std::vector<int>{6, 2, 8});
+  heap_utils::d_ary_heap<int, 4, std::greater<>> y(std::vector<int>{5, 1}, std::greater<>{});
+  x.merge(std::move(y));
+  assert(y.empty());
+  assert(x.size() == 5);
+  assert(x.pop() == 1 && x.pop() == 2 && x.pop() == 5);
+}
+
+static void test_errors_on_empty()
+{
+  heap_utils::d_ary_heap<int> h;
+
+  bool threw = false;
+  try
+  {
+    (void)h.top();
+  }
+  catch (const std::runtime_error &)
+  {
+    threw = true;
+  }
+  assert(threw);
+
+  // Member and free function name themselves in the message.
+  threw = false;
+  try
+  {
+    (void)h.pop();
+  }
+  catch (const std::runtime_error &e)
+  {
+    threw = std::string(e.what()) == "heap_utils: d_ary_heap::pop() on empty heap";
+  }
+  assert(threw);
+
+  threw = false;
+  try
+  {
+    std::vector<int> v;
+    (void)heap_utils::d_ary_heap_pop<4>(v);
+  }
+  catch (const std::runtime_error &e)
+  {
+    threw = std::string(e.what()) == "heap_utils: d_ary_heap_pop() on empty heap";
+  }
+  assert(threw);
+}
+
+int main()
+{
+  test_free_functions_all_arities();
+  test_container_push_pop_top();
+  test_container_heapify_with_strings();
+  test_arithmetic_keys_match_sorted_order();
+  test_merge();
+  test_errors_on_empty();
+  return 0;
+}
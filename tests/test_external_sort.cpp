@@ -0,0 +1,218 @@
+#include <heap_utils/external_sort.hpp>
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <functional>
+#include <iterator>
+#include <new>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace
+{
+  // Largest single allocation while `track_allocations` is set: bounds what
+  // external_top_k's in-memory path reserves.
+  bool track_allocations = false;
+  std::size_t largest_allocation = 0;
+} // namespace
+
+void *operator new(std::size_t size)
+{
+  if (track_allocations && size > largest_allocation)
+  {
+    largest_allocation = size;
+  }
+  if (void *p = std::malloc(size ? size : 1))
+  {
+    return p;
+  }
+  throw std::bad_alloc();
+}
+
+// GCC pairs the inlined free() with the new-expression, not with our operator new.
+#if defined(__GNUC__) && !defined(__clang__) && __GNUC__ >= 11
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+void operator delete(void *p) noexcept
+{
+  std::free(p);
+}
+
+void operator delete(void *p, std::size_t) noexcept
+{
+  std::free(p);
+}
+#if defined(__GNUC__) && !defined(__clang__) && __GNUC__ >= 11
+#pragma GCC diagnostic pop
+#endif
+
+namespace
+{
+  std::vector<std::uint32_t> random_input(std::size_t n, std::uint32_t range)
+  {
+    std::mt19937 rng(11);
+    std::vector<std::uint32_t> v(n);
+    for (auto &x : v)
+    {
+      x = static_cast<std::uint32_t>(rng() % range);
+    }
+    return v;
+  }
+
+  std::filesystem::path scratch_dir()
+  {
+    const auto dir = std::filesystem::temp_directory_path() / "heap_utils_external_test";
+    std::filesystem::remove_all(dir);
+    std::filesystem::create_directories(dir);
+    return dir;
+  }
+
+  bool dir_empty(const std::filesystem::path &dir)
+  {
+    return std::filesystem::directory_iterator(dir) == std::filesystem::directory_iterator();
+  }
+} // namespace
+
+static void test_spilling_sort_matches_std_sort()
+{
+  const auto dir = scratch_dir();
+  const std::vector<std::uint32_t> input = random_input(200000, 1000000);
+  std::vector<std::uint32_t> want = input;
+  std::sort(want.begin(), want.end());
+
+  // 256 KiB: a 16K-entry selection heap, about 6 runs, fan-in 4 -> one extra pass.
+  heap_utils::external_sorter<std::uint32_t> sorter(256 * 1024, {}, dir);
+  sorter.push(input.begin(), input.end());
+  std::vector<std::uint32_t> got;
+  sorter.finish(std::back_inserter(got));
+
+  assert(got == want);
+  assert(sorter.spilled_runs() > 4);
+  assert(sorter.merge_passes() >= 1);
+  assert(dir_empty(dir));
+  std::filesystem::remove_all(dir);
+}
+
+static void test_replacement_selection_runs()
+{
+  // Sorted input never breaks a run.
+  std::vector<std::uint32_t> sorted(50000);
+  for (std::size_t i = 0; i < sorted.size(); ++i)
+  {
+    sorted[i] = static_cast<std::uint32_t>(i);
+  }
+  heap_utils::external_sorter<std::uint32_t> a(4096);
+  a.push(sorted.begin(), sorted.end());
+  std::vector<std::uint32_t> out;
+  a.finish(std::back_inserter(out));
+  assert(out == sorted);
+  assert(a.spilled_runs() == 1);
+
+  // Random input: runs average about twice the heap size.
+  const std::vector<std::uint32_t> input = random_input(100000, 1u << 30);
+  heap_utils::external_sorter<std::uint32_t> b(16 * 1024);
+  b.push(input.begin(), input.end());
+  out.clear();
+  b.finish(std::back_inserter(out));
+  assert(std::is_sorted(out.begin(), out.end()));
+  const std::size_t heap_runs = input.size() / b.heap_capacity();
+  assert(b.spilled_runs() < heap_runs * 3 / 4);
+
+  // Input within budget: no file at all.
+  heap_utils::external_sorter<std::uint32_t, std::greater<>> c(1 << 20);
+  c.push(input.begin(), input.begin() + 1000);
+  out.clear();
+  c.finish(std::back_inserter(out));
+  assert(c.spilled_runs() == 0);
+  assert(out.size() == 1000 && std::is_sorted(out.begin(), out.end(), std::greater<>{}));
+}
+
+static void test_tiny_budget_and_limit()
+{
+  const std::vector<std::uint32_t> input = random_input(3000, 50);
+  std::vector<std::uint32_t> want = input;
+  std::sort(want.begin(), want.end());
+
+  std::vector<std::uint32_t> got;
+  heap_utils::external_sort(input.begin(), input.end(), std::back_inserter(got), 1);
+  assert(got == want);
+
+  heap_utils::external_sorter<std::uint32_t> s(1024);
+  s.push(input.begin(), input.end());
+  got.clear();
+  s.finish(std::back_inserter(got), 10);
+  assert((got == std::vector<std::uint32_t>(want.begin(), want.begin() + 10)));
+
+  // The selection heap allocates exactly the budgeted size, once.
+  heap_utils::external_sorter<std::uint32_t> sized(600 * 16);
+  const std::size_t budgeted = sized.heap_capacity();
+  assert(budgeted > 1 && sized.heap_allocated() == 0);
+  sized.push(input.begin(), input.begin() + static_cast<std::ptrdiff_t>(budgeted - 1));
+  assert(sized.heap_allocated() == budgeted);
+  sized.push(input.begin(), input.end());
+  assert(sized.heap_allocated() == budgeted);
+}
+
+static void test_external_top_k()
+{
+  const std::vector<std::uint32_t> input = random_input(100000, 1u << 30);
+
+  // k fits: bounded heap, best first.
+  std::vector<std::uint32_t> small;
+  heap_utils::external_top_k(input.begin(), input.end(), 100, std::back_inserter(small), 1 << 20);
+  assert(small == heap_utils::top_k(input, 100));
+
+  // k does not fit: spilled sort, first k only.
+  std::vector<std::uint32_t> large;
+  heap_utils::external_top_k(input.begin(), input.end(), 20000, std::back_inserter(large), 16 * 1024,
+                             std::greater<>{});
+  assert(large == heap_utils::top_k(input, 20000, std::greater<>{}));
+
+  std::vector<std::uint32_t> none;
+  heap_utils::external_top_k(input.begin(), input.end(), 0, std::back_inserter(none), 1024);
+  assert(none.empty());
+
+  // In-memory path: exactly k elements, never the doubled 2048 that
+  // growing from the initial reservation would reach.
+  const std::size_t k = 1500;
+  std::vector<std::uint32_t> fitted(k);
+  track_allocations = true;
+  largest_allocation = 0;
+  heap_utils::external_top_k(input.begin(), input.end(), k, fitted.begin(), k * sizeof(std::uint32_t));
+  track_allocations = false;
+  assert(largest_allocation == k * sizeof(std::uint32_t));
+  assert(fitted == heap_utils::top_k(input, k));
+}
+
+static void test_binary_file_reader()
+{
+  const std::vector<std::uint32_t> input = random_input(10000, 1000);
+  std::FILE *f = std::tmpfile();
+  assert(f != nullptr);
+  assert(std::fwrite(input.data(), sizeof(std::uint32_t), input.size(), f) == input.size());
+  std::rewind(f);
+
+  heap_utils::binary_file_reader<std::uint32_t> reader(f, 1000);
+  std::vector<std::uint32_t> top;
+  heap_utils::external_top_k(reader.begin(), reader.end(), 5, std::back_inserter(top), 1024);
+  assert(top == heap_utils::top_k(input, 5));
+  assert(reader.done());
+  std::fclose(f);
+}
+
+int main()
+{
+  test_spilling_sort_matches_std_sort();
+  test_replacement_selection_runs();
+  test_tiny_budget_and_limit();
+  test_external_top_k();
+  test_binary_file_reader();
+  return 0;
+}
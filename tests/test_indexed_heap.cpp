@@ -0,0 +1,207 @@
+#include <heap_utils/indexed_heap.hpp>
+
+#include <cassert>
+#include <cstddef>
+#include <functional>
+#include <map>
+#include <stdexcept>
+#include <vector>
+
+static void test_push_pop_min_order()
+{
+  heap_utils::indexed_heap<int> h;
+  assert(h.empty());
+
+  h.push(3, 30);
+  h.push(0, 50);
+  h.push(7, 10);
+  h.push(1, 40);
+  assert(h.size() == 4);
+  assert(h.contains(7));
+  assert(!h.contains(2));
+  assert(!h.contains(100));
+  assert(h.top() == 7);
+  assert(h.top_key() == 10);
+  assert(h.key(1) == 40);
+
+  std::vector<std::size_t> order;
+  while (!h.empty())
+  {
+    order.push_back(h.pop());
+  }
+  assert((order == std::vector<std::size_t>{7, 3, 1, 0}));
+  assert(!h.contains(7));
+}
+
+static void test_decrease_increase_erase()
+{
+  heap_utils::indexed_heap<int> h(8);
+  for (std::size_t id = 0; id < 8; ++id)
+  {
+    h.push(id, static_cast<int>(100 + id));
+  }
+
+  h.decrease_key(5, 1);
+  assert(h.top() == 5);
+
+  h.increase_key(5, 200);
+  assert(h.top() == 0);
+
+  h.update(6, 0);
+  assert(h.top() == 6);
+  h.update(6, 300);
+  assert(h.top() == 0);
+
+  assert(h.erase(0));
+  assert(!h.erase(0));
+  assert(h.top() == 1);
+  assert(h.size() == 7);
+
+  h.push_or_update(0, 50);
+  h.push_or_update(2, 40);
+  assert(h.top() == 2);
+
+  bool threw = false;
+  try
+  {
+    h.decrease_key(3, 1000);
+  }
+  catch (const std::invalid_argument &)
+  {
+    threw = true;
+  }
+  assert(threw);
+
+  threw = false;
+  try
+  {
+    h.increase_key(3, 0);
+  }
+  catch (const std::invalid_argument &)
+  {
+    threw = true;
+  }
+  assert(threw);
+
+  threw = false;
+  try
+  {
+    h.update(42, 0);
+  }
+  catch (const std::out_of_range &)
+  {
+    threw = true;
+  }
+  assert(threw);
+}
+
+static void test_matches_reference_under_random_updates()
+{
+  heap_utils::indexed_heap<unsigned, std::less<>, 3> h;
+  std::map<std::size_t, unsigned> ref;
+
+  unsigned state = 12345;
+  auto next = [&state]()
+  {
+    state = state * 1103515245u + 12345u;
+    return (state >> 8) & 0xffffu;
+  };
+
+  for (int step = 0; step < 5000; ++step)
+  {
+    const std::size_t id = next() % 64;
+    const unsigned key = next() % 1000;
+    switch (next() % 4)
+    {
+    case 0:
+    case 1:
+      h.push_or_update(id, key);
+      ref[id] = key;
+      break;
+    case 2:
+      assert(h.erase(id) == (ref.erase(id) == 1));
+      break;
+    default:
+      if (!ref.empty())
+      {
+        unsigned best = 0;
+        for (const auto &kv : ref)
+        {
+          best = (kv.second > best) ? kv.second : best;
+        }
+        assert(h.top_key() == best);
+        const std::size_t top = h.pop();
+        assert(ref.at(top) == best);
+        ref.erase(top);
+      }
+      break;
+    }
+    assert(h.size() == ref.size());
+  }
+}
+
+static void test_errors_on_empty()
+{
+  heap_utils::indexed_heap<int> h;
+
+  bool threw = false;
+  try
+  {
+    (void)h.top();
+  }
+  catch (const std::runtime_error &)
+  {
+    threw = true;
+  }
+  assert(threw);
+
+  threw = false;
+  try
+  {
+    (void)h.pop();
+  }
+  catch (const std::runtime_error &)
+  {
+    threw = true;
+  }
+  assert(threw);
+}
+
+static void test_npos_id_rejected()
+{
+  using heap = heap_utils::indexed_heap<int>;
+  heap h;
+  h.push(3, 30);
+
+  for (int round = 0; round < 2; ++round)
+  {
+    bool threw = false;
+    try
+    {
+      if (round == 0)
+      {
+        h.push(heap::npos, 1);
+      }
+      else
+      {
+        h.push_or_update(heap::npos, 1);
+      }
+    }
+    catch (const std::length_error &)
+    {
+      threw = true;
+    }
+    assert(threw && h.size() == 1 && !h.contains(heap::npos));
+  }
+  assert(h.top() == 3 && h.key(3) == 30);
+}
+
+int main()
+{
+  test_push_pop_min_order();
+  test_decrease_increase_erase();
+  test_matches_reference_under_random_updates();
+  test_errors_on_empty();
+  test_npos_id_rejected();
+  return 0;
+}
@@ -0,0 +1,259 @@
+#include <heap_utils/d_ary_heap.hpp>
+#include <heap_utils/heap_utils.hpp>
+#include <heap_utils/instrumentation.hpp>
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <numeric>
+#include <random>
+#include <vector>
+
+using counted_heap = heap_utils::d_ary_heap<int, 2, std::less<>, std::allocator<int>,
+                                            heap_utils::counting_instrumentation>;
+
+static std::size_t floor_log2(std::size_t n)
+{
+  std::size_t l = 0;
+  while (n > 1)
+  {
+    n >>= 1;
+    ++l;
+  }
+  return l;
+}
+
+static std::uint64_t histogram_total(const heap_utils::heap_stats &s)
+{
+  return std::accumulate(s.sift_depth.begin(), s.sift_depth.end(), std::uint64_t{0});
+}
+
+static void test_ascending_pushes()
+{
+  // Every ascending push into a max-heap climbs to the root.
+  counted_heap h;
+  const std::size_t n = 1000;
+  std::uint64_t levels = 0;
+  for (std::size_t i = 1; i <= n; ++i)
+  {
+    h.push(static_cast<int>(i));
+    levels += floor_log2(i);
+  }
+
+  const heap_utils::heap_stats &s = h.instrumentation().stats();
+  assert(s.pushes == n);
+  assert(s.pops == 0);
+  assert(s.high_water_mark == n);
+  assert(s.comparisons == levels); // the root is reached without comparing
+  // Per sift: take the value out, one move per level, final placement.
+  assert(s.moves == levels + 2 * (n - 1));
+  assert(histogram_total(s) == n - 1); // a push into an empty heap does not sift
+  assert(s.sift_depth[floor_log2(n)] == n - 511);
+  assert(s.sift_depth[1] == 2);
+}
+
+static void test_matches_plain_heap()
+{
+  std::mt19937 rng(3);
+  counted_heap counted;
+  heap_utils::d_ary_heap<int, 2> plain;
+  for (int i = 0; i < 5000; ++i)
+  {
+    const int x = static_cast<int>(rng() % 1000);
+    counted.push(x);
+    plain.push(x);
+    if (i % 3 == 0)
+    {
+      assert(counted.pop() == plain.pop());
+    }
+  }
+  while (!plain.empty())
+  {
+    assert(counted.pop() == plain.pop());
+  }
+
+  const heap_utils::heap_stats &s = counted.instrumentation().stats();
+  assert(s.pushes == 5000);
+  assert(s.pops == 5000);
+  assert(s.high_water_mark > 3000 && s.high_water_mark < 5000);
+  assert(s.comparisons > 0 && s.moves > s.comparisons / 4);
+
+  counted.instrumentation().reset_stats();
+  assert(counted.instrumentation().stats().comparisons == 0);
+  assert(counted.instrumentation().stats().high_water_mark == 0);
+}
+
+static void test_heapify_and_merge()
+{
+  std::vector<int> data(4096);
+  std::iota(data.begin(), data.end(), 0);
+  counted_heap h(data);
+  const heap_utils::heap_stats &s = h.instrumentation().stats();
+  assert(s.high_water_mark == 4096);
+  assert(s.pushes == 0);
+  assert(histogram_total(s) == 2048); // one sift per internal node
+  assert(s.comparisons < 2 * 4096);   // Floyd: linear
+
+  counted_heap other(std::vector<int>{5000, 1, 2});
+  h.merge(std::move(other));
+  assert(h.size() == 4099);
+  assert(h.instrumentation().stats().high_water_mark == 4099);
+  assert(h.top() == 5000);
+}
+
+static void test_instrumented_compare_on_free_functions()
+{
+  std::vector<int> data(10000);
+  std::mt19937 rng(5);
+  for (int &x : data)
+  {
+    x = static_cast<int>(rng());
+  }
+
+  heap_utils::counting_instrumentation probe;
+  const std::vector<int> best =
+      heap_utils::top_k(data, 10, heap_utils::instrumented_compare<std::less<>>{{}, &probe});
+  assert(best == heap_utils::top_k(data, 10));
+  assert(probe.stats().comparisons >= data.size() - 10);
+
+  heap_utils::counting_instrumentation pop_probe;
+  std::vector<int> h = data;
+  heap_utils::heapify(h.begin(), h.end());
+  auto comp = heap_utils::instrumented_compare<std::less<>>{{}, &pop_probe};
+  (void)heap_utils::heap_pop(h, comp);
+  assert(pop_probe.stats().comparisons > 0);
+  assert(pop_probe.stats().comparisons <= 2 * floor_log2(data.size()) + 2);
+
+  // A disabled policy needs no probe object at all.
+  auto plain = heap_utils::instrumented_compare<std::less<>, heap_utils::no_instrumentation>{};
+  assert(plain(1, 2) && !plain(2, 1));
+}
+
+static void test_binary_heap_and_bounded_top_k()
+{
+  using counted_binary = heap_utils::binary_heap<int, std::less<>, std::allocator<int>,
+                                                 heap_utils::counting_instrumentation>;
+  counted_binary h;
+  heap_utils::binary_heap<int> plain;
+  const std::size_t n = 1023;
+  for (std::size_t i = 1; i <= n; ++i)
+  {
+    h.push(static_cast<int>(i));
+    plain.push(static_cast<int>(i));
+  }
+  // Ascending input: push i sifts to the root, floor(log2(i)) levels.
+  const heap_utils::heap_stats &s = h.instrumentation().stats();
+  assert(s.pushes == n && s.high_water_mark == n);
+  for (std::size_t d = 0; d < 10; ++d)
+  {
+    assert(s.sift_depth[d] == (std::size_t{1} << d));
+  }
+  assert(h.container() == plain.container());
+
+  while (!h.empty())
+  {
+    assert(h.pop() == plain.pop());
+  }
+  assert(s.pops == n);
+  assert(histogram_total(s) == 2 * n - 1); // the last pop needs no sift
+  assert(s.moves > 2 * n && s.comparisons > n);
+
+  counted_binary built(std::vector<int>{4, 8, 1, 9, 3});
+  assert(built.top() == 9 && built.instrumentation().stats().high_water_mark == 5);
+
+  std::vector<int> data(10000);
+  std::mt19937 rng(22);
+  for (int &x : data)
+  {
+    x = static_cast<int>(rng());
+  }
+  heap_utils::bounded_top_k<int, std::less<>, heap_utils::counting_instrumentation> acc(10);
+  std::uint64_t retained = 0;
+  for (int x : data)
+  {
+    retained += acc.push(x) ? 1 : 0;
+  }
+  const heap_utils::heap_stats &t = acc.instrumentation().stats();
+  assert(t.pushes == retained && t.pops == retained - 10);
+  assert(t.high_water_mark == 10);
+  assert(histogram_total(t) == retained);
+  assert(t.comparisons >= data.size() - 10);
+  assert(acc.take_sorted() == heap_utils::top_k(data, 10));
+}
+
+static void test_counts_match_instrumented_compare()
+{
+  // The policy must count the code that runs without it: same comparator
+  // calls as instrumented_compare on the uninstrumented types.
+  using probed = heap_utils::instrumented_compare<std::less<>, heap_utils::counting_instrumentation>;
+  std::vector<int> data(20000);
+  std::mt19937 rng(220);
+  for (int &x : data)
+  {
+    x = static_cast<int>(rng() % 5000); // plenty of ties
+  }
+
+  for (std::size_t k : {1u, 10u, 100u, 3000u})
+  {
+    heap_utils::bounded_top_k<int, std::less<>, heap_utils::counting_instrumentation> acc(k);
+    heap_utils::counting_instrumentation probe;
+    heap_utils::bounded_top_k<int, probed> plain(k, probed{{}, &probe});
+    for (int x : data)
+    {
+      assert(acc.push(x) == plain.push(x));
+      assert(acc.instrumentation().stats().comparisons == probe.stats().comparisons);
+    }
+    assert(acc.take_sorted() == plain.take_sorted());
+    assert(acc.instrumentation().stats().comparisons == probe.stats().comparisons);
+  }
+
+  using counted_binary = heap_utils::binary_heap<int, std::less<>, std::allocator<int>,
+                                                 heap_utils::counting_instrumentation>;
+  counted_binary h;
+  heap_utils::counting_instrumentation probe;
+  heap_utils::binary_heap<int, probed> plain(probed{{}, &probe});
+  for (int x : data)
+  {
+    h.push(x);
+    plain.push(x);
+  }
+  assert(h.instrumentation().stats().comparisons == probe.stats().comparisons);
+  while (!h.empty())
+  {
+    assert(h.pop() == plain.pop());
+  }
+  assert(h.instrumentation().stats().comparisons == probe.stats().comparisons);
+}
+
+static void test_stats_aggregate()
+{
+  heap_utils::heap_stats a;
+  a.comparisons = 10;
+  a.high_water_mark = 7;
+  a.sift_depth[3] = 2;
+  heap_utils::heap_stats b;
+  b.comparisons = 5;
+  b.moves = 4;
+  b.high_water_mark = 9;
+  b.sift_depth[3] = 1;
+  a += b;
+  assert(a.comparisons == 15 && a.moves == 4);
+  assert(a.high_water_mark == 9);
+  assert(a.sift_depth[3] == 3);
+  a.reset();
+  assert(a.comparisons == 0 && a.sift_depth[3] == 0);
+}
+
+int main()
+{
+  test_ascending_pushes();
+  test_matches_plain_heap();
+  test_heapify_and_merge();
+  test_instrumented_compare_on_free_functions();
+  test_binary_heap_and_bounded_top_k();
+  test_counts_match_instrumented_compare();
+  test_stats_aggregate();
+  return 0;
+}
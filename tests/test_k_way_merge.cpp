@@ -0,0 +1,215 @@
+#include <heap_utils/instrumentation.hpp>
+#include <heap_utils/k_way_merge.hpp>
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+struct tagged
+{
+  int key;
+  std::size_t run;
+};
+
+struct by_key
+{
+  bool operator()(const tagged &a, const tagged &b) const { return a.key < b.key; }
+};
+
+static void test_matches_stable_sort()
+{
+  std::mt19937 rng(2);
+  for (std::size_t k : {0u, 1u, 2u, 3u, 7u, 8u, 9u, 64u, 301u})
+  {
+    std::vector<std::vector<tagged>> runs(k);
+    std::vector<tagged> all;
+    for (std::size_t r = 0; r < k; ++r)
+    {
+      const std::size_t len = rng() % 40;
+      for (std::size_t i = 0; i < len; ++i)
+      {
+        runs[r].push_back({static_cast<int>(rng() % 50), r});
+      }
+      std::sort(runs[r].begin(), runs[r].end(), by_key{});
+      all.insert(all.end(), runs[r].begin(), runs[r].end());
+    }
+    std::stable_sort(all.begin(), all.end(), by_key{});
+
+    std::vector<tagged> merged;
+    heap_utils::k_way_merge(runs, std::back_inserter(merged), by_key{});
+    assert(merged.size() == all.size());
+    for (std::size_t i = 0; i < all.size(); ++i)
+    {
+      assert(merged[i].key == all[i].key);
+      assert(merged[i].run == all[i].run);
+    }
+  }
+}
+
+static void test_descending_and_iterator_pairs()
+{
+  std::vector<int> a = {9, 5, 1};
+  std::vector<int> b = {8, 8, 2};
+  std::vector<int> c = {};
+  std::vector<int> d = {10, 0};
+  using it = std::vector<int>::const_iterator;
+  std::vector<std::pair<it, it>> runs = {{a.cbegin(), a.cend()}, {b.cbegin(), b.cend()},
+                                         {c.cbegin(), c.cend()}, {d.cbegin(), d.cend()}};
+
+  std::vector<int> out;
+  heap_utils::k_way_merge(runs, std::back_inserter(out), std::greater<>{});
+  assert((out == std::vector<int>{10, 9, 8, 8, 5, 2, 1, 0}));
+}
+
+static void test_streamed_input_iterators()
+{
+  std::vector<std::istringstream> streams;
+  for (const char *text : {"1 4 9 12", "2 3 10", "", "0 5 6 7 8 11", "13"})
+  {
+    streams.emplace_back(text);
+  }
+  // Ten runs to exercise the loser tree as well.
+  for (int i = 0; i < 5; ++i)
+  {
+    streams.emplace_back("20 30");
+  }
+
+  using it = std::istream_iterator<int>;
+  std::vector<std::pair<it, it>> runs;
+  for (auto &s : streams)
+  {
+    runs.emplace_back(it(s), it());
+  }
+
+  std::vector<int> out;
+  heap_utils::k_way_merge(runs, std::back_inserter(out));
+  std::vector<int> expected = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13};
+  for (int i = 0; i < 5; ++i)
+  {
+    expected.push_back(20);
+  }
+  for (int i = 0; i < 5; ++i)
+  {
+    expected.push_back(30);
+  }
+  assert(out == expected);
+}
+
+static void test_loser_tree_incremental()
+{
+  std::vector<int> a = {1, 3, 5};
+  std::vector<int> b = {2, 4};
+  using it = std::vector<int>::const_iterator;
+  heap_utils::loser_tree<it> tree({{a.cbegin(), a.cend()}, {b.cbegin(), b.cend()}});
+  assert(tree.run_count() == 2);
+
+  std::vector<int> out;
+  std::vector<std::size_t> from;
+  while (!tree.empty())
+  {
+    out.push_back(tree.top());
+    from.push_back(tree.top_run());
+    tree.advance();
+  }
+  assert((out == std::vector<int>{1, 2, 3, 4, 5}));
+  assert((from == std::vector<std::size_t>{0, 1, 0, 1, 0}));
+
+  bool threw = false;
+  try
+  {
+    (void)tree.top();
+  }
+  catch (const std::runtime_error &)
+  {
+    threw = true;
+  }
+  assert(threw);
+
+  heap_utils::loser_tree<it> none({});
+  assert(none.empty());
+}
+
+static std::size_t ceil_log2(std::size_t k)
+{
+  std::size_t levels = 0;
+  while ((std::size_t{1} << levels) < k)
+  {
+    ++levels;
+  }
+  return levels;
+}
+
+static void test_comparisons_per_element()
+{
+  // Heavy ties: the case that used to cost a second comparison per match.
+  using counted = heap_utils::instrumented_compare<by_key, heap_utils::counting_instrumentation>;
+  std::mt19937 rng(15);
+  for (std::size_t k : {2u, 5u, 7u, 8u, 37u, 64u, 300u})
+  {
+    std::vector<std::vector<tagged>> runs(k);
+    std::size_t n = 0;
+    for (std::size_t r = 0; r < k; ++r)
+    {
+      runs[r].assign(50, tagged{0, r});
+      for (tagged &t : runs[r])
+      {
+        t.key = static_cast<int>(rng() % 3);
+      }
+      std::sort(runs[r].begin(), runs[r].end(), by_key{});
+      n += runs[r].size();
+    }
+
+    if (k >= heap_utils::k_way_merge_heap_threshold)
+    {
+      // Loser tree: one comparison per level of the replayed path.
+      std::vector<std::pair<std::vector<tagged>::const_iterator, std::vector<tagged>::const_iterator>> bounds;
+      for (const auto &run : runs)
+      {
+        bounds.emplace_back(run.begin(), run.end());
+      }
+      heap_utils::counting_instrumentation probe;
+      heap_utils::loser_tree<std::vector<tagged>::const_iterator, counted> tree(bounds, counted{by_key{}, &probe});
+      assert(probe.stats().comparisons == k - 1);
+      while (!tree.empty())
+      {
+        const std::uint64_t before = probe.stats().comparisons;
+        tree.advance();
+        assert(probe.stats().comparisons - before <= ceil_log2(k));
+      }
+    }
+
+    // Either strategy: one comparison per match, so at most two per level of the heap.
+    heap_utils::counting_instrumentation probe;
+    std::vector<tagged> merged;
+    heap_utils::k_way_merge(runs, std::back_inserter(merged), counted{by_key{}, &probe});
+    assert(merged.size() == n);
+    assert(probe.stats().comparisons <= 2 * k + n * 2 * ceil_log2(k));
+    if (k >= heap_utils::k_way_merge_heap_threshold)
+    {
+      assert(probe.stats().comparisons <= (k - 1) + n * ceil_log2(k));
+    }
+    for (std::size_t i = 1; i < merged.size(); ++i)
+    {
+      assert(merged[i - 1].key < merged[i].key ||
+             (merged[i - 1].key == merged[i].key && merged[i - 1].run <= merged[i].run));
+    }
+  }
+}
+
+int main()
+{
+  test_matches_stable_sort();
+  test_descending_and_iterator_pairs();
+  test_streamed_input_iterators();
+  test_loser_tree_incremental();
+  test_comparisons_per_element();
+  return 0;
+}
@@ -0,0 +1,176 @@
+#include <heap_utils/keyed_heap.hpp>
+
+#include <array>
+#include <cassert>
+#include <cstdint>
+#include <functional>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+struct job
+{
+  std::uint64_t deadline = 0;
+  std::array<char, 88> blob{};
+};
+
+static void test_min_deadline_order()
+{
+  heap_utils::keyed_heap<std::uint64_t, job, std::greater<>> h;
+  assert(h.empty());
+
+  for (std::uint64_t d : {50u, 10u, 40u, 20u, 30u})
+  {
+    job j;
+    j.deadline = d;
+    h.push(d, j);
+  }
+  assert(h.size() == 5);
+  assert(h.top_key() == 10);
+  assert(h.top().deadline == 10);
+
+  std::vector<std::uint64_t> order;
+  while (!h.empty())
+  {
+    order.push_back(h.pop().deadline);
+  }
+  assert((order == std::vector<std::uint64_t>{10, 20, 30, 40, 50}));
+}
+
+static void test_slots_are_recycled()
+{
+  heap_utils::keyed_heap<int, std::string> h;
+
+  h.push(1, "one");
+  h.push(3, "three");
+  assert(h.pop() == "three");
+
+  h.push(2, std::string("two"));
+  h.push(5, "five");
+  assert(h.size() == 3);
+
+  const auto kv = h.pop_with_key();
+  assert(kv.first == 5 && kv.second == "five");
+  assert(h.pop() == "two");
+  assert(h.pop() == "one");
+
+  for (int i = 0; i < 100; ++i)
+  {
+    h.push(i % 17, std::to_string(i % 17));
+  }
+  int prev = 1 << 30;
+  while (!h.empty())
+  {
+    const int k = h.top_key();
+    assert(k <= prev);
+    assert(h.pop() == std::to_string(k));
+    prev = k;
+  }
+}
+
+// Counts live instances; assignment throws while `fail` is set.
+struct fragile
+{
+  static inline int live = 0;
+  static inline bool fail = false;
+  int v = 0;
+
+  fragile() { ++live; }
+  explicit fragile(int x) : v(x) { ++live; }
+  fragile(const fragile &o) : v(o.v) { ++live; }
+  ~fragile() { --live; }
+
+  fragile &operator=(const fragile &o)
+  {
+    if (fail)
+    {
+      throw std::runtime_error("fragile");
+    }
+    v = o.v;
+    return *this;
+  }
+};
+
+static void test_push_failure_keeps_slots()
+{
+  heap_utils::keyed_heap<int, fragile> h;
+  const fragile payload(7);
+  for (int i = 0; i < 4; ++i)
+  {
+    h.push(i, payload);
+  }
+  assert(h.pop().v == 7);
+  const int live = fragile::live;
+
+  // Recycled slot: handed back to the free list on throw.
+  fragile::fail = true;
+  for (int i = 0; i < 100; ++i)
+  {
+    bool threw = false;
+    try
+    {
+      h.push(i, payload);
+    }
+    catch (const std::runtime_error &)
+    {
+      threw = true;
+    }
+    assert(threw);
+  }
+  fragile::fail = false;
+  assert(h.size() == 3 && fragile::live == live);
+
+  // The recycled slot is reused, so no new payload is constructed.
+  h.push(10, payload);
+  assert(fragile::live == live && h.top_key() == 10);
+
+  // Fresh slot: dropped again on throw.
+  fragile::fail = true;
+  try
+  {
+    h.push(12, payload);
+  }
+  catch (const std::runtime_error &)
+  {
+  }
+  fragile::fail = false;
+  assert(fragile::live == live && h.size() == 4);
+  h.push(11, payload);
+  assert(fragile::live == live + 1 && h.size() == 5);
+}
+
+static void test_errors_on_empty()
+{
+  heap_utils::keyed_heap<int, int> h;
+
+  bool threw = false;
+  try
+  {
+    (void)h.top();
+  }
+  catch (const std::runtime_error &)
+  {
+    threw = true;
+  }
+  assert(threw);
+
+  threw = false;
+  try
+  {
+    (void)h.pop();
+  }
+  catch (const std::runtime_error &)
+  {
+    threw = true;
+  }
+  assert(threw);
+}
+
+int main()
+{
+  test_min_deadline_order();
+  test_slots_are_recycled();
+  test_push_failure_keeps_slots();
+  test_errors_on_empty();
+  return 0;
+}
@@ -0,0 +1,311 @@
+#include <heap_utils/mapped_heap.hpp>
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <unistd.h>
+
+namespace
+{
+  struct job
+  {
+    std::uint64_t deadline;
+    std::uint32_t id;
+  };
+
+  // Earliest deadline on top.
+  struct by_deadline
+  {
+    bool operator()(const job &a, const job &b) const { return a.deadline > b.deadline; }
+  };
+
+  constexpr std::uint64_t tag = 0x6465616c696e65; // "deadline"
+
+  using job_heap = heap_utils::mapped_heap<job, by_deadline>;
+
+  std::string temp_path(const char *name)
+  {
+    const auto p = std::filesystem::temp_directory_path() /
+                   (std::string("heap_utils_") + name + "_" + std::to_string(::getpid()) + ".heap");
+    std::filesystem::remove(p);
+    return p.string();
+  }
+
+  template <class F>
+  bool throws_runtime_error(F &&f)
+  {
+    try
+    {
+      f();
+    }
+    catch (const std::runtime_error &)
+    {
+      return true;
+    }
+    return false;
+  }
+} // namespace
+
+static void test_persists_across_reopen()
+{
+  const std::string path = temp_path("reopen");
+  std::mt19937_64 rng(7);
+  std::vector<std::uint64_t> deadlines;
+
+  {
+    job_heap h(path, tag, 16);
+    assert(h.empty());
+    for (std::uint32_t i = 0; i < 10000; ++i)
+    {
+      const std::uint64_t d = rng() % 100000;
+      h.push(job{d, i});
+      deadlines.push_back(d);
+    }
+    assert(h.size() == 10000);
+    assert(h.capacity() >= 10000);
+    assert(h.top().deadline == *std::min_element(deadlines.begin(), deadlines.end()));
+    for (int i = 0; i < 100; ++i)
+    {
+      (void)h.pop();
+    }
+    h.flush();
+  }
+
+  std::sort(deadlines.begin(), deadlines.end());
+  {
+    job_heap h(path, tag);
+    assert(h.size() == 9900);
+    assert(h.comparator_tag() == tag);
+    assert(h.valid());
+    for (std::size_t i = 100; i < deadlines.size(); ++i)
+    {
+      assert(h.pop().deadline == deadlines[i]);
+    }
+    assert(h.empty());
+    assert(throws_runtime_error([&] { (void)h.pop(); }));
+  }
+  std::filesystem::remove(path);
+}
+
+static void test_rejects_mismatched_files()
+{
+  const std::string path = temp_path("mismatch");
+  {
+    job_heap h(path, tag);
+    h.push(job{1, 1});
+  }
+  assert(throws_runtime_error([&] { job_heap other(path, tag + 1); }));
+  assert(throws_runtime_error([&] { heap_utils::mapped_heap<job, by_deadline, 4> other(path, tag); }));
+  assert(throws_runtime_error([&] { heap_utils::mapped_heap<std::uint32_t> other(path, tag); }));
+  std::filesystem::remove(path);
+
+  {
+    std::ofstream junk(path, std::ios::binary);
+    junk << std::string(8192, 'x');
+  }
+  assert(throws_runtime_error([&] { job_heap other(path, tag); }));
+  std::filesystem::remove(path);
+}
+
+namespace
+{
+  // Max-heap whose comparator throws once its budget runs out: stops a sift
+  // at an exact point, leaving the file as a crash there would.
+  struct fallible
+  {
+    int *budget = nullptr;
+
+    bool operator()(std::uint32_t a, std::uint32_t b) const
+    {
+      if (budget != nullptr && (*budget)-- == 0)
+      {
+        throw std::runtime_error("interrupted");
+      }
+      return a < b;
+    }
+  };
+
+  using fallible_heap = heap_utils::mapped_heap<std::uint32_t, fallible, 4>;
+
+  heap_utils::mapped_heap_header read_header(const std::string &path)
+  {
+    heap_utils::mapped_heap_header header{};
+    std::ifstream f(path, std::ios::binary);
+    f.read(reinterpret_cast<char *>(&header), sizeof(header));
+    return header;
+  }
+
+  template <class T>
+  T read_at(std::fstream &f, std::uint64_t offset)
+  {
+    T x{};
+    f.seekg(static_cast<std::streamoff>(offset));
+    f.read(reinterpret_cast<char *>(&x), sizeof(x));
+    return x;
+  }
+
+  template <class T>
+  void write_at(std::fstream &f, std::uint64_t offset, const T &x)
+  {
+    f.seekp(static_cast<std::streamoff>(offset));
+    f.write(reinterpret_cast<const char *>(&x), sizeof(x));
+  }
+
+  // The move a crash can separate from its journal update: copy the
+  // element the sift would move next into the hole, leaving `hole` as is.
+  void tear_next_move(const std::string &path, bool pushing)
+  {
+    using header_t = heap_utils::mapped_heap_header;
+    const header_t h = read_header(path);
+    std::fstream f(path, std::ios::in | std::ios::out | std::ios::binary);
+    const auto slot = [](std::uint64_t i) { return header_t::data_offset + i * sizeof(std::uint32_t); };
+    const auto value = read_at<std::uint32_t>(f, fallible_heap::journal_offset);
+    if (pushing)
+    {
+      if (h.hole > 0)
+      {
+        const auto parent = read_at<std::uint32_t>(f, slot((h.hole - 1) / 4));
+        if (parent < value)
+        {
+          write_at(f, slot(h.hole), parent);
+        }
+      }
+      return;
+    }
+    std::uint64_t best = 4 * h.hole + 1;
+    for (std::uint64_t c = best + 1; c < 4 * h.hole + 5 && c < h.journal_size; ++c)
+    {
+      if (read_at<std::uint32_t>(f, slot(best)) < read_at<std::uint32_t>(f, slot(c)))
+      {
+        best = c;
+      }
+    }
+    if (best < h.journal_size && value < read_at<std::uint32_t>(f, slot(best)))
+    {
+      write_at(f, slot(h.hole), read_at<std::uint32_t>(f, slot(best)));
+    }
+  }
+
+  std::vector<std::uint32_t> sorted_contents(const fallible_heap &h)
+  {
+    std::vector<std::uint32_t> out(h.data(), h.data() + h.size());
+    std::sort(out.begin(), out.end());
+    return out;
+  }
+} // namespace
+
+static void test_interrupted_sift_is_finished()
+{
+  using header_t = heap_utils::mapped_heap_header;
+  const std::string path = temp_path("interrupted");
+  std::mt19937_64 rng(23);
+
+  for (int round = 0; round < 400; ++round)
+  {
+    const bool pushing = (round % 2) == 0;
+    const bool torn = (round % 4) >= 2;
+    std::filesystem::remove(path);
+
+    std::vector<std::uint32_t> expected;
+    {
+      fallible_heap h(path, tag, 16);
+      for (int i = 0; i < 500; ++i)
+      {
+        const auto x = static_cast<std::uint32_t>(rng() % 1000);
+        h.push(x);
+        expected.push_back(x);
+      }
+    }
+    std::sort(expected.begin(), expected.end());
+
+    // A new maximum sifts all the way up; a pop sifts all the way down.
+    const std::uint32_t pushed = 5000 + static_cast<std::uint32_t>(round);
+    int budget = static_cast<int>(rng() % (pushing ? 6 : 24));
+    bool threw = false;
+    {
+      fallible_heap h(path, tag, 16, fallible{&budget});
+      try
+      {
+        if (pushing)
+        {
+          h.push(pushed);
+        }
+        else
+        {
+          assert(h.pop() == expected.back());
+        }
+      }
+      catch (const std::runtime_error &)
+      {
+        threw = true;
+      }
+    }
+    if (pushing)
+    {
+      expected.push_back(pushed);
+    }
+    else
+    {
+      expected.pop_back();
+    }
+    assert((read_header(path).in_flight != header_t::idle) == threw);
+    if (threw && torn)
+    {
+      tear_next_move(path, pushing);
+    }
+
+    {
+      fallible_heap h(path, tag);
+      assert(h.valid());
+      assert(sorted_contents(h) == expected);
+    }
+    assert(read_header(path).in_flight == header_t::idle);
+  }
+
+  // An unknown operation in the journal is refused, not guessed at.
+  {
+    std::fstream f(path, std::ios::in | std::ios::out | std::ios::binary);
+    header_t h = read_header(path);
+    h.in_flight = 7;
+    write_at(f, 0, h);
+  }
+  assert(throws_runtime_error([&] { fallible_heap h(path, tag); }));
+  std::filesystem::remove(path);
+}
+
+static void test_move()
+{
+  const std::string path = temp_path("move");
+  heap_utils::mapped_heap<int> a(path);
+  a.push(3);
+  a.push(9);
+  heap_utils::mapped_heap<int> b(std::move(a));
+  assert(b.top() == 9);
+  b.reserve(5000);
+  assert(b.capacity() >= 5000);
+  assert(b.pop() == 9 && b.pop() == 3);
+  b.push(4);
+  b.clear();
+  assert(b.empty());
+  std::filesystem::remove(path);
+}
+
+int main()
+{
+  test_persists_across_reopen();
+  test_rejects_mismatched_files();
+  test_interrupted_sift_is_finished();
+  test_move();
+  return 0;
+}
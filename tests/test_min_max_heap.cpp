@@ -0,0 +1,151 @@
+#include <heap_utils/min_max_heap.hpp>
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <optional>
+#include <random>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+static void test_basic_min_max()
+{
+  heap_utils::min_max_heap<int> h;
+  for (int x : {5, 1, 9, 3, 7, 2, 8})
+  {
+    h.push(x);
+  }
+  assert(h.size() == 7);
+  assert(h.min() == 1);
+  assert(h.max() == 9);
+  assert(h.pop_max() == 9);
+  assert(h.pop_min() == 1);
+  assert(h.pop_max() == 8);
+  assert(h.pop_min() == 2);
+  assert(h.min() == 3);
+  assert(h.max() == 7);
+}
+
+static void test_matches_multiset()
+{
+  std::mt19937 rng(4);
+  heap_utils::min_max_heap<int> h;
+  std::multiset<int> ref;
+
+  for (int step = 0; step < 20000; ++step)
+  {
+    const unsigned op = rng() % 4;
+    if (op < 2 || ref.empty())
+    {
+      const int x = static_cast<int>(rng() % 500);
+      h.push(x);
+      ref.insert(x);
+    }
+    else if (op == 2)
+    {
+      assert(h.pop_min() == *ref.begin());
+      ref.erase(ref.begin());
+    }
+    else
+    {
+      assert(h.pop_max() == *ref.rbegin());
+      ref.erase(std::prev(ref.end()));
+    }
+    assert(h.size() == ref.size());
+    if (!ref.empty())
+    {
+      assert(h.min() == *ref.begin());
+      assert(h.max() == *ref.rbegin());
+    }
+  }
+}
+
+static void test_custom_compare_and_errors()
+{
+  heap_utils::min_max_heap<std::string, std::greater<>> h;
+  h.emplace("pear");
+  h.emplace("apple");
+  h.emplace("zucchini");
+  assert(h.min() == "zucchini"); // "smallest" under greater<>
+  assert(h.max() == "apple");
+
+  heap_utils::min_max_heap<int> e;
+  bool threw = false;
+  try
+  {
+    (void)e.pop_max();
+  }
+  catch (const std::runtime_error &)
+  {
+    threw = true;
+  }
+  assert(threw);
+}
+
+static void test_bounded_evicts_min()
+{
+  heap_utils::bounded_min_max_heap<int> b(3);
+  assert(!b.push(5));
+  assert(!b.push(1));
+  assert(!b.push(9));
+  assert(b.full());
+
+  std::optional<int> out = b.push(7); // evicts 1
+  assert(out && *out == 1);
+  out = b.push(2); // below the minimum: rejected
+  assert(out && *out == 2);
+  out = b.push(5); // tie with the minimum: kept element wins
+  assert(out && *out == 5);
+
+  assert(b.size() == 3);
+  assert(b.min() == 5);
+  assert(b.max() == 9);
+}
+
+static void test_bounded_evicts_max()
+{
+  heap_utils::bounded_min_max_heap<int> b(2, heap_utils::evict_end::max);
+  assert(b.evicts() == heap_utils::evict_end::max);
+  b.push(4);
+  b.push(6);
+  std::optional<int> out = b.push(1);
+  assert(out && *out == 6);
+  out = b.push(8);
+  assert(out && *out == 8);
+  assert(b.min() == 1);
+  assert(b.max() == 4);
+
+  heap_utils::bounded_min_max_heap<int> none(0);
+  out = none.push(3);
+  assert(out && *out == 3);
+  assert(none.empty());
+}
+
+static void test_bounded_oversized_capacity()
+{
+  // The capacity is a cap: SIZE_MAX or 2^40 must not be reserved up front.
+  heap_utils::bounded_min_max_heap<int> all(SIZE_MAX);
+  heap_utils::bounded_min_max_heap<int> huge(std::size_t{1} << 40, heap_utils::evict_end::max);
+  assert(all.capacity() == SIZE_MAX && !all.full());
+  for (int i = 0; i < 5000; ++i)
+  {
+    assert(!all.push(i) && !huge.push(-i));
+  }
+  assert(all.size() == 5000 && all.min() == 0 && all.max() == 4999);
+  assert(huge.size() == 5000 && huge.min() == -4999 && huge.max() == 0);
+}
+
+int main()
+{
+  test_basic_min_max();
+  test_matches_multiset();
+  test_custom_compare_and_errors();
+  test_bounded_evicts_min();
+  test_bounded_evicts_max();
+  test_bounded_oversized_capacity();
+  return 0;
+}
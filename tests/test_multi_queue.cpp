@@ -0,0 +1,165 @@
+#include <heap_utils/multi_queue.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <numeric>
+#include <random>
+#include <thread>
+#include <vector>
+
+static void test_strict_is_exact()
+{
+  heap_utils::multi_queue<int, std::greater<>> q(heap_utils::queue_ordering::strict);
+  assert(q.queue_count() == 1);
+  assert(q.ordering() == heap_utils::queue_ordering::strict);
+
+  for (int x : {5, 1, 9, 3, 7})
+  {
+    q.push(x);
+  }
+  assert(q.try_push(4));
+  assert(q.size() == 6);
+
+  std::vector<int> out;
+  int x = 0;
+  while (q.try_pop(x))
+  {
+    out.push_back(x);
+  }
+  assert((out == std::vector<int>{1, 3, 4, 5, 7, 9}));
+  assert(q.empty());
+  assert(!q.try_pop(x));
+}
+
+// Number of elements still queued that are better than `v` (0 = exact).
+static std::size_t rank_error(std::vector<int> &fenwick, int v, int n)
+{
+  std::size_t better = 0;
+  for (int i = n; i > 0; i -= i & -i)
+  {
+    better += static_cast<std::size_t>(fenwick[static_cast<std::size_t>(i)]);
+  }
+  for (int i = v + 1; i > 0; i -= i & -i)
+  {
+    better -= static_cast<std::size_t>(fenwick[static_cast<std::size_t>(i)]);
+  }
+  for (int i = v + 1; i <= n; i += i & -i)
+  {
+    --fenwick[static_cast<std::size_t>(i)];
+  }
+  return better;
+}
+
+static void test_relaxed_rank_error()
+{
+  const int n = 50000;
+  heap_utils::multi_queue<int> q(heap_utils::queue_ordering::relaxed, 4, 2);
+  assert(q.queue_count() == 8);
+
+  std::vector<int> values(static_cast<std::size_t>(n));
+  std::iota(values.begin(), values.end(), 0);
+  std::shuffle(values.begin(), values.end(), std::mt19937(3));
+  for (int v : values)
+  {
+    q.push(v);
+  }
+  assert(q.size() == static_cast<std::size_t>(n));
+
+  std::vector<int> fenwick(static_cast<std::size_t>(n) + 1, 0);
+  for (int i = 1; i <= n; ++i)
+  {
+    ++fenwick[static_cast<std::size_t>(i)];
+    const int parent = i + (i & -i);
+    if (parent <= n)
+    {
+      fenwick[static_cast<std::size_t>(parent)] += fenwick[static_cast<std::size_t>(i)];
+    }
+  }
+
+  std::vector<bool> seen(static_cast<std::size_t>(n), false);
+  std::size_t total = 0;
+  int v = 0;
+  for (int i = 0; i < n; ++i)
+  {
+    assert(q.try_pop(v));
+    assert(!seen[static_cast<std::size_t>(v)]);
+    seen[static_cast<std::size_t>(v)] = true;
+    total += rank_error(fenwick, v, n);
+  }
+  assert(!q.try_pop(v));
+
+  // Expected rank error is O(m); allow a generous constant.
+  const double mean = static_cast<double>(total) / n;
+  assert(mean < 4.0 * static_cast<double>(q.queue_count()));
+}
+
+static void test_concurrent_producers_consumers()
+{
+  const int producers = 4;
+  const int consumers = 4;
+  const int per_producer = 20000;
+
+  heap_utils::multi_queue<std::uint64_t> q(heap_utils::queue_ordering::relaxed, producers + consumers);
+  std::atomic<int> done_producers{0};
+  std::atomic<std::uint64_t> popped_sum{0};
+  std::atomic<std::size_t> popped_count{0};
+
+  std::vector<std::thread> threads;
+  for (int p = 0; p < producers; ++p)
+  {
+    threads.emplace_back([&, p]
+                         {
+      for (int i = 0; i < per_producer; ++i)
+      {
+        const auto v = static_cast<std::uint64_t>(p * per_producer + i);
+        if (!q.try_push(v))
+        {
+          q.push(v);
+        }
+      }
+      done_producers.fetch_add(1); });
+  }
+  for (int c = 0; c < consumers; ++c)
+  {
+    threads.emplace_back([&]
+                         {
+      std::uint64_t v = 0;
+      std::uint64_t sum = 0;
+      std::size_t count = 0;
+      for (;;)
+      {
+        if (q.try_pop(v))
+        {
+          sum += v;
+          ++count;
+        }
+        else if (done_producers.load() == producers && q.empty())
+        {
+          break;
+        }
+      }
+      popped_sum.fetch_add(sum);
+      popped_count.fetch_add(count); });
+  }
+  for (std::thread &t : threads)
+  {
+    t.join();
+  }
+
+  const auto total = static_cast<std::uint64_t>(producers) * per_producer;
+  assert(popped_count.load() == total);
+  assert(popped_sum.load() == total * (total - 1) / 2);
+  assert(q.empty());
+}
+
+int main()
+{
+  test_strict_is_exact();
+  test_relaxed_rank_error();
+  test_concurrent_producers_consumers();
+  return 0;
+}
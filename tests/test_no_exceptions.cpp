@@ -0,0 +1,90 @@
+// Built with -fno-exceptions: only the non-throwing entry points may appear here.
+
+#include <heap_utils/heap_utils.hpp>
+
+#include <cassert>
+#include <functional>
+#include <optional>
+#include <string>
+#include <vector>
+
+static void test_try_heap_pop()
+{
+  std::vector<int> h = {3, 9, 1};
+  heap_utils::heapify(h.begin(), h.end());
+
+  std::optional<int> x = heap_utils::try_heap_pop(h);
+  assert(x && *x == 9);
+  assert(heap_utils::try_heap_pop(h).value_or(-1) == 3);
+  assert(heap_utils::try_heap_pop(h).value_or(-1) == 1);
+  assert(!heap_utils::try_heap_pop(h));
+}
+
+static void test_heap_pop_into()
+{
+  struct order
+  {
+    int price;
+    std::string id;
+  };
+  auto by_price = [](const order &a, const order &b)
+  { return a.price > b.price; };
+
+  std::vector<order> book;
+  heap_utils::heap_push(book, order{101, "a"}, by_price);
+  heap_utils::heap_push(book, order{99, "b"}, by_price);
+  heap_utils::heap_push(book, order{100, "c"}, by_price);
+
+  order slot{0, "unused"};
+  assert(heap_utils::heap_pop_into(book, slot, by_price));
+  assert(slot.price == 99 && slot.id == "b");
+  assert(heap_utils::heap_pop_into(book, slot, by_price));
+  assert(slot.price == 100);
+  assert(heap_utils::heap_pop_into(book, slot, by_price));
+  assert(slot.price == 101);
+  assert(!heap_utils::heap_pop_into(book, slot, by_price));
+  assert(slot.id == "a");
+}
+
+static void test_unchecked()
+{
+  std::vector<int> h;
+  for (int x : {4, 8, 2, 6})
+  {
+    heap_utils::heap_push(h, x, std::greater<>{});
+  }
+  assert(heap_utils::heap_top_unchecked(h) == 2);
+
+  int sum = 0;
+  while (!h.empty())
+  {
+    const int top = heap_utils::heap_top_unchecked(h);
+    assert(heap_utils::heap_pop_unchecked(h, std::greater<>{}) == top);
+    sum += top;
+  }
+  assert(sum == 20);
+}
+
+static void test_other_non_throwing_helpers()
+{
+  std::vector<int> h = {5, 1, 7};
+  heap_utils::heapify(h.begin(), h.end());
+  assert(heap_utils::heap_pushpop(h, 9) == 9);
+  assert(heap_utils::heap_pushpop(h, 2) == 7);
+
+  heap_utils::bounded_top_k<int> acc(2);
+  for (int x : {3, 8, 1, 6})
+  {
+    acc.push(x);
+  }
+  assert((acc.take_sorted() == std::vector<int>{8, 6}));
+}
+
+int main()
+{
+  test_try_heap_pop();
+  test_heap_pop_into();
+  test_unchecked();
+  test_other_non_throwing_helpers();
+  return 0;
+}
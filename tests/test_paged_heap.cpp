@@ -0,0 +1,167 @@
+#include <heap_utils/b_heap.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <queue>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+namespace
+{
+  struct record
+  {
+    std::uint64_t key = 0;
+    std::array<std::uint64_t, 7> payload{};
+  };
+
+  struct by_key
+  {
+    bool operator()(const record &a, const record &b) const { return a.key < b.key; }
+  };
+
+  template <class F>
+  bool throws_runtime_error(F &&f)
+  {
+    try
+    {
+      f();
+    }
+    catch (const std::runtime_error &)
+    {
+      return true;
+    }
+    return false;
+  }
+} // namespace
+
+// Random pushes and pops against std::priority_queue, checking heap order at the end of the fill.
+template <class Heap>
+static void check_against_priority_queue(std::size_t n)
+{
+  std::mt19937 rng(static_cast<std::uint32_t>(n));
+  Heap h;
+  std::priority_queue<int> ref;
+  for (std::size_t i = 0; i < n; ++i)
+  {
+    const int x = static_cast<int>(rng() % 100000);
+    h.push(x);
+    ref.push(x);
+    if (i % 3 == 0)
+    {
+      assert(h.pop() == ref.top());
+      ref.pop();
+    }
+  }
+  assert(h.valid());
+  assert(h.size() == ref.size());
+  while (!ref.empty())
+  {
+    assert(h.top() == ref.top());
+    assert(h.pop() == ref.top());
+    ref.pop();
+  }
+  assert(h.empty());
+}
+
+static void test_layouts_match_priority_queue()
+{
+  // 64-byte pages: 14 ints per block, so even small heaps span many blocks.
+  check_against_priority_queue<heap_utils::paged_heap<int, heap_utils::b_heap_layout<64>>>(5000);
+  // The smallest block: one sibling pair.
+  check_against_priority_queue<heap_utils::paged_heap<int, heap_utils::b_heap_layout<16>>>(3000);
+  check_against_priority_queue<heap_utils::paged_heap<int>>(50000);
+  check_against_priority_queue<heap_utils::paged_heap<int, heap_utils::d_ary_layout<4>>>(5000);
+}
+
+static void test_block_geometry()
+{
+  using layout = heap_utils::b_heap_layout<4096>;
+  using g = layout::geometry<int>;
+  static_assert(g::slots == 1024 && g::nodes == 1022 && g::fanout == 512);
+  static_assert(layout::geometry<record>::slots == 64);
+  static_assert(heap_utils::b_heap_layout<4096>::geometry<char[24]>::slots == 128);
+
+  static_assert(layout::slot<int>(0) == 0);
+  static_assert(layout::slot<int>(1022) == 1022);
+  static_assert(layout::slot<int>(1023) == 1025); // skips two padding slots
+  static_assert(layout::slot<int>(1024) == 1026);
+  static_assert(layout::storage_size<int>(0) == 0);
+  static_assert(layout::storage_size<int>(1023) == 1024);
+  static_assert(layout::storage_size<int>(1024) == 2048);
+
+  // The page-aligned array puts every block on exactly one page.
+  heap_utils::paged_heap<int> h;
+  for (int i = 0; i < (1 << 20); ++i)
+  {
+    h.push(i);
+  }
+  assert(reinterpret_cast<std::uintptr_t>(h.container().data()) % 4096 == 0);
+  assert(h.container().size() == layout::storage_size<int>(1 << 20));
+  assert(h.top() == (1 << 20) - 1);
+  assert(h.valid());
+}
+
+static void test_heapify_and_large_elements()
+{
+  std::mt19937_64 rng(9);
+  std::vector<record> input(20000);
+  for (record &r : input)
+  {
+    r.key = rng() % 5000;
+    r.payload[0] = r.key;
+  }
+
+  using record_heap = heap_utils::paged_heap<record, heap_utils::b_heap_layout<4096>, by_key>;
+  record_heap h(record_heap::container_type(input.begin(), input.end()));
+  assert(h.size() == input.size());
+  assert(h.valid());
+
+  std::vector<std::uint64_t> want;
+  for (const record &r : input)
+  {
+    want.push_back(r.key);
+  }
+  std::sort(want.begin(), want.end(), std::greater<>{});
+  for (std::uint64_t k : want)
+  {
+    const record r = h.pop();
+    assert(r.key == k && r.payload[0] == k);
+  }
+
+  // Heapify on a non-empty heap replaces the contents.
+  heap_utils::paged_heap<int, heap_utils::b_heap_layout<256>, std::greater<>> m;
+  m.push(-5);
+  m.heapify({9, 4, 7, 1, 8});
+  assert(m.size() == 5 && m.valid());
+  assert(m.pop() == 1 && m.pop() == 4 && m.top() == 7);
+}
+
+static void test_empty_and_clear()
+{
+  heap_utils::paged_heap<int> h;
+  assert(throws_runtime_error([&] { (void)h.top(); }));
+  assert(throws_runtime_error([&] { (void)h.pop(); }));
+  h.reserve(100000);
+  assert(h.container().capacity() >= 100000);
+  h.emplace(3);
+  h.push(5);
+  assert(h.pop() == 5);
+  h.clear();
+  assert(h.empty() && h.valid());
+  h.push(1);
+  assert(h.top() == 1);
+}
+
+int main()
+{
+  test_layouts_match_priority_queue();
+  test_block_geometry();
+  test_heapify_and_large_elements();
+  test_empty_and_clear();
+  return 0;
+}
@@ -0,0 +1,134 @@
+#include <heap_utils/pairing_heap.hpp>
+
+#include <algorithm>
+#include <cassert>
+#include <functional>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+static void test_push_pop_order()
+{
+  heap_utils::pairing_heap<int> h;
+  assert(h.empty());
+
+  for (int i = 0; i < 300; ++i)
+  {
+    h.push((i * 37) % 101);
+  }
+  assert(h.size() == 300);
+
+  std::vector<int> popped;
+  while (!h.empty())
+  {
+    popped.push_back(h.pop());
+  }
+  assert(popped.size() == 300);
+  assert(std::is_sorted(popped.begin(), popped.end(), std::greater<>{}));
+}
+
+static void test_decrease_key_update_and_erase()
+{
+  heap_utils::pairing_heap<int, std::greater<>> h;
+
+  std::vector<heap_utils::pairing_heap<int, std::greater<>>::handle> handles;
+  for (int i = 0; i < 20; ++i)
+  {
+    handles.push_back(h.push(100 + i));
+  }
+  assert(h.top() == 100);
+
+  h.decrease_key(handles[15], 1);
+  assert(h.top() == 1);
+  assert(*handles[15] == 1);
+  assert(h.top_handle() == handles[15]);
+
+  h.update(handles[15], 500);
+  assert(h.top() == 100);
+
+  h.update(handles[7], 2);
+  assert(h.top() == 2);
+
+  h.erase(handles[7]);
+  h.erase(handles[0]);
+  h.erase(handles[19]);
+  assert(h.size() == 17);
+  assert(h.top() == 101);
+
+  bool threw = false;
+  try
+  {
+    h.decrease_key(handles[3], 1000);
+  }
+  catch (const std::invalid_argument &)
+  {
+    threw = true;
+  }
+  assert(threw);
+
+  std::vector<int> popped;
+  while (!h.empty())
+  {
+    popped.push_back(h.pop());
+  }
+  assert(popped.size() == 17);
+  assert(std::is_sorted(popped.begin(), popped.end()));
+  assert(popped.back() == 500);
+}
+
+static void test_merge()
+{
+  heap_utils::pairing_heap<std::string> a;
+  heap_utils::pairing_heap<std::string> b;
+  a.push("kiwi");
+  a.emplace("apple");
+  b.push("zucchini");
+  b.push("banana");
+
+  a.merge(b);
+  assert(b.empty());
+  assert(a.size() == 4);
+  assert(a.pop() == "zucchini");
+  assert(a.pop() == "kiwi");
+
+  heap_utils::pairing_heap<std::string> c = std::move(a);
+  assert(a.empty());
+  assert(c.pop() == "banana");
+  assert(c.pop() == "apple");
+}
+
+static void test_errors_on_empty()
+{
+  heap_utils::pairing_heap<int> h;
+
+  bool threw = false;
+  try
+  {
+    (void)h.top();
+  }
+  catch (const std::runtime_error &)
+  {
+    threw = true;
+  }
+  assert(threw);
+
+  threw = false;
+  try
+  {
+    (void)h.pop();
+  }
+  catch (const std::runtime_error &)
+  {
+    threw = true;
+  }
+  assert(threw);
+}
+
+int main()
+{
+  test_push_pop_order();
+  test_decrease_key_update_and_erase();
+  test_merge();
+  test_errors_on_empty();
+  return 0;
+}
@@ -0,0 +1,170 @@
+#include <heap_utils/parallel.hpp>
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+struct ranked
+{
+  int score;
+  std::size_t origin;
+};
+
+struct by_score
+{
+  bool operator()(const ranked &a, const ranked &b) const { return a.score < b.score; }
+};
+
+static void test_matches_sequential()
+{
+  std::mt19937 rng(7);
+  std::vector<std::uint32_t> v(200000);
+  for (auto &x : v)
+  {
+    x = static_cast<std::uint32_t>(rng());
+  }
+
+  for (std::size_t threads : {1u, 2u, 3u, 8u})
+  {
+    auto got = heap_utils::top_k(heap_utils::parallel_policy{threads}, v, 100, std::less<>{});
+    assert(got == heap_utils::top_k(v, 100));
+
+    auto low = heap_utils::top_k(heap_utils::parallel_policy{threads}, v, 37, std::greater<>{});
+    assert(low == heap_utils::top_k(v, 37, std::greater<>{}));
+  }
+}
+
+static void test_ties_independent_of_thread_count()
+{
+  // Few distinct scores: most of the top-k is decided by tie-breaking.
+  std::vector<ranked> v;
+  for (std::size_t i = 0; i < 100000; ++i)
+  {
+    v.push_back({static_cast<int>((i * 7919) % 5), i});
+  }
+
+  const auto ref = heap_utils::top_k(heap_utils::parallel_policy{1}, v, 500, by_score{});
+  assert(ref.size() == 500);
+  for (std::size_t i = 1; i < ref.size(); ++i)
+  {
+    assert(ref[i - 1].score > ref[i].score ||
+           (ref[i - 1].score == ref[i].score && ref[i - 1].origin < ref[i].origin));
+  }
+
+  for (std::size_t threads : {2u, 4u, 5u, 16u})
+  {
+    const auto got = heap_utils::top_k(heap_utils::parallel_policy{threads}, v, 500, by_score{});
+    assert(got.size() == ref.size());
+    for (std::size_t i = 0; i < got.size(); ++i)
+    {
+      assert(got[i].origin == ref[i].origin);
+    }
+  }
+}
+
+static void test_edge_cases()
+{
+  std::vector<int> empty;
+  assert(heap_utils::top_k(heap_utils::par, empty, 3).empty());
+
+  std::vector<int> v = {3, 9, 1};
+  assert(heap_utils::parallel_top_k(v, 0).empty());
+  assert((heap_utils::parallel_top_k(v, 10, std::less<>{}, 4) == std::vector<int>{9, 3, 1}));
+
+  int raw[] = {5, 2, 8, 8, 1};
+  assert((heap_utils::top_k(heap_utils::par, raw, raw + 5, 2) == std::vector<int>{8, 8}));
+
+  // parallel_top_k is the same algorithm with a trailing thread count.
+  assert((heap_utils::parallel_top_k(raw, raw + 5, 2) == std::vector<int>{8, 8}));
+}
+
+static void test_worker_exception_propagates()
+{
+  std::vector<int> v(100000);
+  for (std::size_t i = 0; i < v.size(); ++i)
+  {
+    v[i] = static_cast<int>(i);
+  }
+
+  auto throwing = [](int a, int b)
+  {
+    if (a == 99999 || b == 99999)
+    {
+      throw std::runtime_error("boom");
+    }
+    return a < b;
+  };
+
+  bool threw = false;
+  try
+  {
+    (void)heap_utils::parallel_top_k(v, 10, throwing, 4);
+  }
+  catch (const std::runtime_error &)
+  {
+    threw = true;
+  }
+  assert(threw);
+}
+
+static void test_parallel_heapify()
+{
+  std::mt19937 rng(11);
+  std::vector<int> v(1 << 20);
+  for (auto &x : v)
+  {
+    x = static_cast<int>(rng() % 1000);
+  }
+  std::vector<int> sorted = v;
+  std::sort(sorted.begin(), sorted.end());
+
+  heap_utils::heapify(heap_utils::par, v.begin(), v.end());
+  assert(heap_utils::is_heap(v.begin(), v.end()));
+
+  heap_utils::heapify(heap_utils::parallel_policy{4}, v.begin(), v.end(), std::greater<>{});
+  assert(heap_utils::is_heap(v.begin(), v.end(), std::greater<>{}));
+  std::sort(v.begin(), v.end());
+  assert(v == sorted);
+
+  heap_utils::d_ary_heapify<4>(heap_utils::parallel_policy{3}, v.begin(), v.end());
+  assert(heap_utils::d_ary_is_heap<4>(v.begin(), v.end()));
+}
+
+static void test_parallel_heapify_shapes()
+{
+  // Tiny chunk size so every size / arity takes the parallel path.
+  std::mt19937 rng(5);
+  for (std::size_t n = 0; n < 700; n += 7)
+  {
+    std::vector<unsigned> v(n);
+    for (auto &x : v)
+    {
+      x = static_cast<unsigned>(rng());
+    }
+    std::vector<unsigned> w = v;
+    std::vector<unsigned> z = v;
+
+    heap_utils::detail::parallel_d_ary_heapify<2>(v.begin(), v.end(), std::less<>{}, 3, 4);
+    assert(heap_utils::is_heap(v.begin(), v.end()));
+    heap_utils::detail::parallel_d_ary_heapify<3>(w.begin(), w.end(), std::greater<>{}, 5, 4);
+    assert(heap_utils::d_ary_is_heap<3>(w.begin(), w.end(), std::greater<>{}));
+    heap_utils::detail::parallel_d_ary_heapify<8>(z.begin(), z.end(), std::less<>{}, 2, 4);
+    assert(heap_utils::d_ary_is_heap<8>(z.begin(), z.end()));
+  }
+}
+
+int main()
+{
+  test_matches_sequential();
+  test_ties_independent_of_thread_count();
+  test_edge_cases();
+  test_worker_exception_propagates();
+  test_parallel_heapify();
+  test_parallel_heapify_shapes();
+  return 0;
+}
@@ -0,0 +1,368 @@
+#include <heap_utils/priority_cache.hpp>
+
+#include <cassert>
+#include <cctype>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+using cache = heap_utils::priority_cache<std::string, int>;
+
+namespace
+{
+  // Case-insensitive and stateful: no default constructor, so the caches
+  // must use the instances they were given.
+  struct folded_hash
+  {
+    std::size_t seed;
+    std::size_t *calls;
+
+    explicit folded_hash(std::size_t s, std::size_t *c) : seed(s), calls(c) {}
+
+    std::size_t operator()(const std::string &s) const
+    {
+      ++*calls;
+      std::size_t h = seed;
+      for (const char ch : s)
+      {
+        h = h * 131 + static_cast<std::size_t>(std::tolower(static_cast<unsigned char>(ch)));
+      }
+      return h;
+    }
+  };
+
+  struct folded_equal
+  {
+    std::size_t *calls;
+
+    explicit folded_equal(std::size_t *c) : calls(c) {}
+
+    bool operator()(const std::string &a, const std::string &b) const
+    {
+      ++*calls;
+      if (a.size() != b.size())
+      {
+        return false;
+      }
+      for (std::size_t i = 0; i < a.size(); ++i)
+      {
+        if (std::tolower(static_cast<unsigned char>(a[i])) != std::tolower(static_cast<unsigned char>(b[i])))
+        {
+          return false;
+        }
+      }
+      return true;
+    }
+  };
+
+  // Copy or move throws while `fail` is set.
+  struct brittle
+  {
+    static inline bool fail = false;
+    std::uint64_t v = 0;
+
+    brittle() = default;
+    brittle(std::uint64_t x) : v(x) {}
+    brittle(const brittle &o) : v(o.v)
+    {
+      if (fail)
+      {
+        throw std::runtime_error("brittle");
+      }
+    }
+    brittle(brittle &&o) : brittle(static_cast<const brittle &>(o)) {}
+    brittle &operator=(const brittle &o) = default;
+    brittle &operator=(brittle &&o) = default;
+
+    bool operator>(const brittle &o) const { return v > o.v; }
+  };
+} // namespace
+
+static void test_lfu_eviction()
+{
+  cache c(3);
+  assert(!c.insert_or_assign("a", 1, 1));
+  assert(!c.insert_or_assign("b", 2, 1));
+  assert(!c.insert_or_assign("c", 3, 1));
+  assert(c.size() == 3 && c.capacity() == 3);
+
+  assert(*c.touch("a") == 1);
+  assert(*c.touch("a", 5) == 1);
+  assert(c.touch("c") && !c.touch("zzz"));
+  assert(c.score("a") == 7 && c.score("c") == 2);
+  assert(c.victim() == "b");
+
+  // Full: the lowest-scored entry makes room.
+  const auto evicted = c.insert_or_assign("d", 4, 1);
+  assert(evicted && evicted->first == "b" && evicted->second == 2);
+  assert(!c.contains("b") && c.size() == 3);
+
+  // Assigning an existing key never evicts.
+  assert(!c.insert_or_assign("d", 40, 10));
+  assert(*c.find("d") == 40 && c.score("d") == 10);
+  assert(c.victim() == "c");
+
+  assert(c.update_score("c", 100) && !c.update_score("b", 1));
+  assert(c.victim() == "a");
+  assert(c.erase("a") && !c.erase("a"));
+
+  const auto last = c.evict();
+  assert(last && last->first == "d");
+  assert(c.evict()->first == "c");
+  assert(c.empty() && !c.evict());
+
+  bool threw = false;
+  try
+  {
+    (void)c.victim();
+  }
+  catch (const std::runtime_error &)
+  {
+    threw = true;
+  }
+  assert(threw);
+
+  threw = false;
+  try
+  {
+    (void)c.score("a");
+  }
+  catch (const std::out_of_range &)
+  {
+    threw = true;
+  }
+  assert(threw);
+}
+
+static void test_expiry_order()
+{
+  // Max-heap on the expiry time: the entry expiring last is evicted first.
+  heap_utils::priority_cache<int, std::string, std::uint64_t, std::hash<int>, std::equal_to<int>, std::less<>> c(2);
+  c.insert_or_assign(1, "one", 300);
+  c.insert_or_assign(2, "two", 100);
+  assert(c.victim() == 1);
+  assert(c.insert_or_assign(3, "three", 200)->second == "one");
+  assert(c.victim() == 3);
+  assert(*c.find(2) == "two");
+}
+
+static void test_matches_reference_model()
+{
+  std::mt19937_64 rng(30);
+  heap_utils::priority_cache<int, int> c(64);
+  std::map<int, std::pair<int, std::uint64_t>> model; // key -> { value, score }
+
+  for (int step = 0; step < 200000; ++step)
+  {
+    const int key = static_cast<int>(rng() % 200);
+    switch (rng() % 6)
+    {
+    case 0:
+      assert(c.erase(key) == (model.erase(key) == 1));
+      break;
+    case 1:
+    {
+      int *v = c.touch(key, 256);
+      const auto it = model.find(key);
+      assert((v != nullptr) == (it != model.end()));
+      if (v)
+      {
+        assert(*v == it->second.first);
+        it->second.second += 256;
+      }
+      break;
+    }
+    default:
+    {
+      // Score % 256 is the key, touches included: the victim is unique.
+      const std::uint64_t score = (rng() % 1000) * 256 + static_cast<std::uint64_t>(key);
+      const int value = static_cast<int>(rng() % 1000);
+      auto evicted = c.insert_or_assign(key, value, score);
+      if (model.count(key) == 0 && model.size() == 64)
+      {
+        auto worst = model.begin();
+        for (auto it = model.begin(); it != model.end(); ++it)
+        {
+          if (it->second.second < worst->second.second)
+          {
+            worst = it;
+          }
+        }
+        assert(evicted && evicted->first == worst->first && evicted->second == worst->second.first);
+        model.erase(worst);
+      }
+      else
+      {
+        assert(!evicted);
+      }
+      model[key] = {value, score};
+      break;
+    }
+    }
+    assert(c.size() == model.size());
+  }
+
+  for (const auto &kv : model)
+  {
+    assert(*c.find(kv.first) == kv.second.first && c.score(kv.first) == kv.second.second);
+  }
+}
+
+static void test_sharded_concurrent()
+{
+  heap_utils::sharded_priority_cache<std::uint64_t, std::uint64_t> c(4000, 8);
+  assert(c.shard_count() == 8 && c.capacity() == 4000);
+
+  const unsigned threads = 4;
+  std::vector<std::thread> pool;
+  for (unsigned t = 0; t < threads; ++t)
+  {
+    pool.emplace_back([&c, t] {
+      std::mt19937_64 rng(t);
+      for (int i = 0; i < 50000; ++i)
+      {
+        const std::uint64_t key = rng() % 10000;
+        if (!c.touch(key))
+        {
+          c.insert_or_assign(key, key * 2, 1);
+        }
+        c.visit(key, [key](std::uint64_t &v) { assert(v == key * 2); });
+      }
+    });
+  }
+  for (std::thread &th : pool)
+  {
+    th.join();
+  }
+
+  assert(c.size() <= c.capacity() && c.size() > 0);
+  std::size_t seen = 0;
+  std::uint64_t cached = 0;
+  for (std::uint64_t key = 0; key < 10000; ++key)
+  {
+    if (const auto v = c.get(key))
+    {
+      assert(*v == key * 2 && c.contains(key));
+      cached = key;
+      ++seen;
+    }
+  }
+  assert(seen == c.size());
+
+  assert(c.erase(cached) && !c.erase(cached) && c.size() == seen - 1);
+  c.clear();
+  assert(c.empty());
+
+  // Fewer entries than shards: clamped so every shard holds at least one.
+  heap_utils::sharded_priority_cache<int, int> tiny(3, 16);
+  assert(tiny.shard_count() == 3 && tiny.capacity() == 3);
+
+  bool threw = false;
+  try
+  {
+    cache zero(0);
+  }
+  catch (const std::invalid_argument &)
+  {
+    threw = true;
+  }
+  assert(threw);
+}
+
+static void test_custom_hash_and_equal()
+{
+  std::size_t hashes = 0;
+  std::size_t equals = 0;
+  heap_utils::priority_cache<std::string, int, std::uint64_t, folded_hash, folded_equal> c(
+      4, std::greater<>{}, folded_hash(7, &hashes), folded_equal(&equals));
+  c.insert_or_assign("Alpha", 1, 1);
+  assert(c.contains("ALPHA") && *c.touch("alpha") == 1);
+  assert(!c.insert_or_assign("aLpHa", 2, 5) && c.size() == 1 && *c.find("alpha") == 2);
+  assert(hashes > 0 && equals > 0);
+
+  hashes = 0;
+  equals = 0;
+  heap_utils::sharded_priority_cache<std::string, int, std::uint64_t, folded_hash, folded_equal> s(
+      128, 4, std::greater<>{}, folded_hash(11, &hashes), folded_equal(&equals));
+  for (int i = 0; i < 32; ++i)
+  {
+    s.insert_or_assign("Key" + std::to_string(i), i, 1);
+  }
+  for (int i = 0; i < 32; ++i)
+  {
+    // Routing and the shard lookup both fold case.
+    assert(*s.get("KEY" + std::to_string(i)) == i && s.contains("key" + std::to_string(i)));
+  }
+  assert(s.size() == 32 && s.erase("kEy3") && !s.contains("Key3"));
+  assert(hashes > 0 && equals > 0);
+}
+
+static void test_failed_insert_changes_nothing()
+{
+  // The node allocation (here: the value's move) throws on a full cache:
+  // nothing may be evicted.
+  {
+    heap_utils::priority_cache<int, brittle> c(2);
+    c.insert_or_assign(1, brittle(10), 1);
+    c.insert_or_assign(2, brittle(20), 2);
+    brittle::fail = true;
+    bool threw = false;
+    try
+    {
+      c.insert_or_assign(3, brittle(30), 3);
+    }
+    catch (const std::runtime_error &)
+    {
+      threw = true;
+    }
+    brittle::fail = false;
+    assert(threw && c.size() == 2 && !c.contains(3));
+    assert(c.find(1)->v == 10 && c.victim() == 1);
+    assert(c.insert_or_assign(3, brittle(30), 3)->first == 1);
+  }
+
+  // The score push throws: no node may be left without a heap entry.
+  {
+    heap_utils::priority_cache<int, int, brittle> c(4);
+    c.insert_or_assign(1, 10, brittle(5));
+    c.erase(1); // id 0 goes to the free list
+    for (int key : {2, 3})
+    {
+      brittle::fail = true;
+      bool threw = false;
+      try
+      {
+        c.insert_or_assign(key, key, brittle(7));
+      }
+      catch (const std::runtime_error &)
+      {
+        threw = true;
+      }
+      brittle::fail = false;
+      assert(threw && !c.contains(key) && !c.erase(key) && c.empty());
+    }
+    // Both the recycled id and the fresh ones are still usable.
+    for (int key = 0; key < 4; ++key)
+    {
+      assert(!c.insert_or_assign(key, key, brittle(static_cast<std::uint64_t>(key))));
+    }
+    assert(c.size() == 4 && c.victim() == 0 && c.erase(2) && c.evict()->first == 0);
+  }
+}
+
+int main()
+{
+  test_lfu_eviction();
+  test_expiry_order();
+  test_matches_reference_model();
+  test_sharded_concurrent();
+  test_custom_hash_and_equal();
+  test_failed_insert_changes_nothing();
+  return 0;
+}
@@ -0,0 +1,140 @@
+#include <heap_utils/quantile.hpp>
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+static int reference_quantile(std::vector<int> v, double q)
+{
+  std::sort(v.begin(), v.end());
+  return v[heap_utils::detail::quantile_lower_size(q, v.size()) - 1];
+}
+
+static void test_running_matches_sort()
+{
+  std::mt19937 rng(8);
+  for (double q : {0.0, 0.1, 0.5, 0.57, 0.9, 0.99, 1.0})
+  {
+    heap_utils::running_quantile<int> rq(q);
+    std::vector<int> seen;
+    for (int i = 0; i < 500; ++i)
+    {
+      const int x = static_cast<int>(rng() % 100);
+      rq.push(x);
+      seen.push_back(x);
+      assert(rq.value() == reference_quantile(seen, q));
+    }
+    assert(rq.size() == seen.size());
+  }
+
+  // Rank convention: floor(q * (n - 1)).
+  heap_utils::running_quantile<int> p90(0.9);
+  for (int x = 1; x <= 11; ++x)
+  {
+    p90.push(x);
+  }
+  assert(p90.value() == 10);
+}
+
+static void test_running_median()
+{
+  heap_utils::running_median<int> m;
+  m.push(5);
+  assert(m.low() == 5 && m.high() == 5);
+  m.push(1);
+  assert(m.low() == 1 && m.high() == 5);
+  m.push(9);
+  assert(m.low() == 5 && m.high() == 5);
+  m.push(7);
+  assert(m.low() == 5 && m.high() == 7);
+
+  heap_utils::running_median<int, std::greater<>> desc;
+  for (int x : {1, 2, 3, 4})
+  {
+    desc.push(x);
+  }
+  assert(desc.low() == 3 && desc.high() == 2);
+}
+
+static void test_sliding_matches_window()
+{
+  std::mt19937 rng(9);
+  for (std::size_t window : {1u, 2u, 7u, 64u})
+  {
+    for (double q : {0.0, 0.5, 0.9, 1.0})
+    {
+      heap_utils::sliding_quantile<int> sq(q, window);
+      std::deque<int> recent;
+      for (int i = 0; i < 400; ++i)
+      {
+        const int x = static_cast<int>(rng() % 50);
+        sq.push(x);
+        recent.push_back(x);
+        if (recent.size() > window)
+        {
+          recent.pop_front();
+        }
+        assert(sq.size() == recent.size());
+        assert(sq.value() == reference_quantile(std::vector<int>(recent.begin(), recent.end()), q));
+      }
+    }
+  }
+
+  heap_utils::sliding_median<int> m(4);
+  for (int x : {10, 20, 30, 40, 50})
+  {
+    m.push(x);
+  }
+  assert(m.low() == 30 && m.high() == 40);
+}
+
+static void test_invalid_arguments()
+{
+  bool threw = false;
+  try
+  {
+    heap_utils::running_quantile<int> bad(1.5);
+  }
+  catch (const std::invalid_argument &)
+  {
+    threw = true;
+  }
+  assert(threw);
+
+  threw = false;
+  try
+  {
+    heap_utils::sliding_quantile<int> bad(0.5, 0);
+  }
+  catch (const std::invalid_argument &)
+  {
+    threw = true;
+  }
+  assert(threw);
+
+  heap_utils::running_median<int> empty;
+  threw = false;
+  try
+  {
+    (void)empty.value();
+  }
+  catch (const std::runtime_error &)
+  {
+    threw = true;
+  }
+  assert(threw);
+}
+
+int main()
+{
+  test_running_matches_sort();
+  test_running_median();
+  test_sliding_matches_window();
+  test_invalid_arguments();
+  return 0;
+}
@@ -0,0 +1,119 @@
+#include <heap_utils/radix_heap.hpp>
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+static void test_monotone_min_order()
+{
+  heap_utils::radix_heap<std::uint32_t> h;
+  assert(h.empty());
+
+  for (std::uint32_t k : {50u, 7u, 7u, 1000000u, 3u, 0u, 64u})
+  {
+    h.push(k);
+  }
+  assert(h.size() == 7);
+  assert(h.top() == 0);
+
+  std::vector<std::uint32_t> popped;
+  while (!h.empty())
+  {
+    const std::uint32_t k = h.pop();
+    popped.push_back(k);
+    if (k == 7)
+    {
+      h.push(8); // monotone: not below the current minimum
+    }
+  }
+  assert((popped == std::vector<std::uint32_t>{0, 3, 7, 7, 8, 8, 50, 64, 1000000}));
+}
+
+static void test_key_value_pairs()
+{
+  using item = std::pair<std::uint64_t, int>;
+  heap_utils::radix_heap<item, heap_utils::radix_first> h;
+
+  h.push({30, 3});
+  h.push({10, 1});
+  h.push({20, 2});
+  assert(h.top_key() == 10);
+  assert(h.pop().second == 1);
+  assert(h.last_key() == 10);
+
+  bool threw = false;
+  try
+  {
+    h.push({5, 0});
+  }
+  catch (const std::invalid_argument &)
+  {
+    threw = true;
+  }
+  assert(threw);
+
+  h.push({10, 4});
+  assert(h.pop().second == 4);
+  assert(h.pop().second == 2);
+  assert(h.pop().second == 3);
+}
+
+static void test_matches_sorted_order()
+{
+  heap_utils::radix_heap<std::uint64_t> h;
+  std::vector<std::uint64_t> keys;
+  std::uint64_t x = 88172645463325252ull;
+  for (int i = 0; i < 2000; ++i)
+  {
+    x ^= x << 13;
+    x ^= x >> 7;
+    x ^= x << 17;
+    keys.push_back(x >> (i % 60));
+    h.push(keys.back());
+  }
+  std::sort(keys.begin(), keys.end());
+  for (std::uint64_t k : keys)
+  {
+    assert(h.pop() == k);
+  }
+  assert(h.empty());
+}
+
+static void test_errors_on_empty()
+{
+  heap_utils::radix_heap<unsigned> h;
+
+  bool threw = false;
+  try
+  {
+    (void)h.top();
+  }
+  catch (const std::runtime_error &)
+  {
+    threw = true;
+  }
+  assert(threw);
+
+  threw = false;
+  try
+  {
+    (void)h.pop();
+  }
+  catch (const std::runtime_error &)
+  {
+    threw = true;
+  }
+  assert(threw);
+}
+
+int main()
+{
+  test_monotone_min_order();
+  test_key_value_pairs();
+  test_matches_sorted_order();
+  test_errors_on_empty();
+  return 0;
+}
@@ -0,0 +1,152 @@
+#include <heap_utils/ranges.hpp>
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <istream>
+#include <iterator>
+#include <random>
+#include <ranges>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace
+{
+  struct doc
+  {
+    std::uint32_t id;
+    std::string text;
+  };
+
+  std::size_t score_calls = 0;
+
+  // Stand-in for an expensive relevance score.
+  struct score
+  {
+    std::uint64_t operator()(const doc &d) const
+    {
+      ++score_calls;
+      std::uint64_t h = 1469598103934665603ull;
+      for (char c : d.text)
+      {
+        h = (h ^ static_cast<unsigned char>(c)) * 1099511628211ull;
+      }
+      return h >> 8;
+    }
+  };
+
+  std::vector<doc> make_docs(std::size_t n)
+  {
+    std::mt19937 rng(17);
+    std::vector<doc> docs;
+    for (std::size_t i = 0; i < n; ++i)
+    {
+      docs.push_back(doc{static_cast<std::uint32_t>(i), std::to_string(rng())});
+    }
+    return docs;
+  }
+
+  std::vector<std::uint32_t> ids(const std::vector<doc> &docs)
+  {
+    std::vector<std::uint32_t> out;
+    for (const doc &d : docs)
+    {
+      out.push_back(d.id);
+    }
+    return out;
+  }
+} // namespace
+
+static void test_heapify_push_pop_with_projection()
+{
+  std::vector<doc> docs = make_docs(500);
+  heap_utils::ranges::heapify(docs, std::ranges::greater{}, &doc::id);
+  assert(heap_utils::ranges::is_heap(docs, std::ranges::greater{}, &doc::id));
+  assert(docs.front().id == 0);
+
+  heap_utils::ranges::heap_push(docs, doc{1000, "x"}, std::ranges::greater{}, &doc::id);
+  for (std::uint32_t want = 0; want < 500; ++want)
+  {
+    assert(heap_utils::ranges::heap_pop(docs, std::ranges::greater{}, &doc::id).id == want);
+  }
+  assert(heap_utils::ranges::heap_pop(docs, std::ranges::greater{}, &doc::id).id == 1000);
+
+  bool threw = false;
+  try
+  {
+    (void)heap_utils::ranges::heap_pop(docs, std::ranges::greater{}, &doc::id);
+  }
+  catch (const std::runtime_error &)
+  {
+    threw = true;
+  }
+  assert(threw);
+
+  // Defaults: max-heap on the elements themselves.
+  std::vector<int> v{3, 1, 4, 1, 5, 9, 2, 6};
+  heap_utils::ranges::heapify(v);
+  assert(v.front() == 9 && heap_utils::ranges::is_heap(v));
+}
+
+static void test_top_k_modes_agree()
+{
+  const std::vector<doc> docs = make_docs(20000);
+  const score s;
+  const auto by_score = [&](const doc &a, const doc &b) { return s(a) < s(b); };
+  const std::vector<std::uint32_t> want = ids(heap_utils::top_k(docs, 50, by_score));
+
+  score_calls = 0;
+  const auto plain = heap_utils::ranges::top_k(docs, 50, std::ranges::less{}, score{},
+                                               heap_utils::ranges::key_cache::none);
+  const std::size_t plain_calls = score_calls;
+  assert(ids(plain) == want);
+
+  score_calls = 0;
+  const auto cached = heap_utils::ranges::top_k(docs, 50, std::ranges::less{}, score{});
+  assert(ids(cached) == want);
+  assert(score_calls == docs.size()); // once per element
+  assert(plain_calls > 2 * docs.size());
+}
+
+static void test_top_k_ranges_and_edges()
+{
+  const std::vector<doc> docs = make_docs(300);
+
+  // Member projection: compared in place (automatic skips decoration).
+  const auto low = heap_utils::ranges::top_k(docs, 3, std::ranges::greater{}, &doc::id);
+  assert((ids(low) == std::vector<std::uint32_t>{0, 1, 2}));
+
+  // A lazy view, and k larger than the input.
+  auto even = docs | std::views::filter([](const doc &d) { return d.id % 2 == 0; });
+  const auto all = heap_utils::ranges::top_k(even, 1000, std::ranges::less{}, &doc::id,
+                                             heap_utils::ranges::key_cache::decorated);
+  assert(all.size() == 150 && all.front().id == 298 && all.back().id == 0);
+
+  // Single-pass input.
+  std::istringstream in("5 17 3 11 8");
+  const auto best = heap_utils::ranges::top_k(std::ranges::istream_view<int>(in), 2, std::ranges::less{},
+                                              [](int x) { return x % 10; });
+  assert((best == std::vector<int>{8, 17}));
+
+  // Unsized ranges with k far beyond their length: no up-front allocation of k.
+  std::istringstream more("4 1 3");
+  assert((heap_utils::ranges::top_k(std::ranges::istream_view<int>(more), SIZE_MAX) == std::vector<int>{4, 3, 1}));
+  static_assert(!std::ranges::sized_range<decltype(even)>);
+  const auto huge = heap_utils::ranges::top_k(even, std::size_t{1} << 40, std::ranges::greater{}, score{},
+                                              heap_utils::ranges::key_cache::decorated);
+  assert(huge.size() == 150);
+
+  assert(heap_utils::ranges::top_k(docs, 0, std::ranges::less{}, &doc::id).empty());
+}
+
+int main()
+{
+  test_heapify_push_pop_with_projection();
+  test_top_k_modes_agree();
+  test_top_k_ranges_and_edges();
+  return 0;
+}
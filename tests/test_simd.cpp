@@ -0,0 +1,158 @@
+#include <heap_utils/d_ary_heap.hpp>
+#include <heap_utils/simd.hpp>
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <random>
+#include <type_traits>
+#include <vector>
+
+// Built once without ISA flags (scalar, or NEON on AArch64) and, when the
+// compiler supports them, again with -msse4.1 and -mavx2 (see CMakeLists.txt).
+// Every kernel enabled for the target must agree with the scalar loop.
+
+namespace
+{
+  // Plain lambda-style comparator: never matches a SIMD kernel.
+  template <class Compare>
+  struct opaque
+  {
+    Compare comp;
+
+    template <class T>
+    bool operator()(const T &a, const T &b) const
+    {
+      return comp(a, b);
+    }
+  };
+
+  template <class T>
+  std::vector<T> edge_values()
+  {
+    using limits = std::numeric_limits<T>;
+    std::vector<T> v{limits::lowest(), limits::max(), T(0), T(1), static_cast<T>(limits::max() - 1)};
+    if constexpr (std::is_signed_v<T>)
+    {
+      v.push_back(T(-1));
+      v.push_back(static_cast<T>(limits::lowest() + 1));
+    }
+    if constexpr (std::is_floating_point_v<T>)
+    {
+      v.push_back(-T(0));
+      v.push_back(limits::infinity());
+      v.push_back(-limits::infinity());
+      v.push_back(limits::min());
+      v.push_back(limits::denorm_min());
+    }
+    return v;
+  }
+
+  template <class T>
+  T random_value(std::mt19937_64 &rng)
+  {
+    if constexpr (std::is_floating_point_v<T>)
+    {
+      return static_cast<T>(std::uniform_real_distribution<double>(-1e6, 1e6)(rng));
+    }
+    else
+    {
+      return static_cast<T>(rng());
+    }
+  }
+
+  // First index of the best value, as in detail::d_ary_best_child's scalar loop.
+  template <class T, std::size_t D, class Compare>
+  int scalar_best(const T *p, Compare comp)
+  {
+    int best = 0;
+    for (int i = 1; i < static_cast<int>(D); ++i)
+    {
+      if (comp(p[best], p[i]))
+      {
+        best = i;
+      }
+    }
+    return best;
+  }
+
+  template <class T, std::size_t D, class Compare>
+  std::size_t check_kernel()
+  {
+    constexpr auto order = heap_utils::detail::simd_order_of<Compare, T>::value;
+    using kernel = heap_utils::detail::simd_child_select<T, D, order>;
+    if constexpr (!kernel::enabled)
+    {
+      return 0;
+    }
+    else
+    {
+      std::mt19937_64 rng(D * sizeof(T));
+      const std::vector<T> edges = edge_values<T>();
+      T group[D];
+
+      for (int round = 0; round < 20000; ++round)
+      {
+        for (std::size_t i = 0; i < D; ++i)
+        {
+          switch (round % 3)
+          {
+          case 0: // distinct
+            group[i] = random_value<T>(rng);
+            break;
+          case 1: // heavy ties
+            group[i] = static_cast<T>(rng() % 3);
+            break;
+          default: // limits, signed zeros, infinities
+            group[i] = edges[rng() % edges.size()];
+            break;
+          }
+        }
+        assert((kernel::best(group) == scalar_best<T, D>(group, Compare{})));
+      }
+
+      // Whole heaps: same arrangement as the scalar path, ties included.
+      std::vector<T> data(4096);
+      for (std::size_t i = 0; i < data.size(); ++i)
+      {
+        data[i] = (i % 2) ? static_cast<T>(rng() % 16) : edges[rng() % edges.size()];
+      }
+      std::vector<T> fast = data;
+      std::vector<T> slow = data;
+      heap_utils::d_ary_heapify<D>(fast.begin(), fast.end(), Compare{});
+      heap_utils::d_ary_heapify<D>(slow.begin(), slow.end(), opaque<Compare>{Compare{}});
+      assert(fast == slow);
+      while (!fast.empty())
+      {
+        assert(heap_utils::d_ary_heap_pop<D>(fast, Compare{}) ==
+               heap_utils::d_ary_heap_pop<D>(slow, opaque<Compare>{Compare{}}));
+        assert(fast == slow);
+      }
+      return 1;
+    }
+  }
+
+  template <class T>
+  std::size_t check_type()
+  {
+    return check_kernel<T, 4, std::less<>>() + check_kernel<T, 4, std::greater<>>() +
+           check_kernel<T, 8, std::less<>>() + check_kernel<T, 8, std::greater<>>() +
+           check_kernel<T, 4, std::less<T>>() + check_kernel<T, 8, std::greater<T>>();
+  }
+} // namespace
+
+int main()
+{
+  const std::size_t kernels = check_type<std::int32_t>() + check_type<std::uint32_t>() +
+                              check_type<std::int64_t>() + check_type<std::uint64_t>() +
+                              check_type<float>() + check_type<double>();
+#if defined(HEAP_UTILS_SIMD_X86) || defined(HEAP_UTILS_SIMD_NEON)
+  assert(kernels > 0);
+#else
+  assert(kernels == 0);
+#endif
+  (void)kernels;
+  return 0;
+}
@@ -0,0 +1,95 @@
+#include <heap_utils/static_heap.hpp>
+
+#include <cassert>
+#include <functional>
+#include <stdexcept>
+#include <vector>
+
+static void test_static_vector_with_generic_helpers()
+{
+  heap_utils::static_vector<int, 8> v;
+  for (int x : {4, 1, 7, 3})
+  {
+    heap_utils::heap_push(v, x);
+  }
+  assert(heap_utils::is_heap(v.begin(), v.end()));
+  assert(heap_utils::heap_top(v) == 7);
+  assert(heap_utils::heap_pop(v) == 7);
+  assert(heap_utils::heap_pop(v) == 4);
+  assert(v.size() == 2);
+}
+
+static void test_static_heap_capacity()
+{
+  heap_utils::static_heap<int, 3, std::greater<>> h;
+  h.push(5);
+  h.push(2);
+  assert(h.try_push(9));
+  assert(h.full());
+  assert(!h.try_push(1));
+
+  bool threw = false;
+  try
+  {
+    h.push(1);
+  }
+  catch (const std::length_error &)
+  {
+    threw = true;
+  }
+  assert(threw);
+
+  assert(h.top() == 2);
+  assert(h.pop() == 2);
+  assert(h.pop() == 5);
+  assert(h.pop() == 9);
+  assert(h.empty());
+
+  threw = false;
+  try
+  {
+    (void)h.pop();
+  }
+  catch (const std::runtime_error &)
+  {
+    threw = true;
+  }
+  assert(threw);
+}
+
+static void test_static_top_k()
+{
+  std::vector<int> data{7, 1, 9, 2, 8, 3, 6, 4, 5};
+
+  heap_utils::static_top_k<int, 3> best;
+  for (int x : data)
+  {
+    best.push(x);
+  }
+  assert(best.full());
+  assert(best.worst() == 7);
+
+  const auto top3 = best.take_sorted();
+  assert(top3.size() == 3);
+  assert((std::vector<int>(top3.begin(), top3.end()) == heap_utils::largest_k(data, 3)));
+  assert(best.empty());
+
+  heap_utils::static_top_k<int, 4, std::greater<>> small;
+  for (int x : data)
+  {
+    small.push(x);
+  }
+  const auto low4 = small.take_sorted();
+  assert((std::vector<int>(low4.begin(), low4.end()) == heap_utils::smallest_k(data, 4)));
+
+  heap_utils::static_top_k<int, 0> none;
+  assert(!none.push(1));
+}
+
+int main()
+{
+  test_static_vector_with_generic_helpers();
+  test_static_heap_capacity();
+  test_static_top_k();
+  return 0;
+}
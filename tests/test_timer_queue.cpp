@@ -0,0 +1,190 @@
+#include <heap_utils/timer_queue.hpp>
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <limits>
+#include <map>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+using timers = heap_utils::timer_queue<std::uint64_t>;
+
+static std::vector<std::size_t> expire(timers &q, std::uint64_t now)
+{
+  std::vector<std::size_t> out;
+  q.pop_expired(now, std::back_inserter(out));
+  std::sort(out.begin(), out.end());
+  return out;
+}
+
+static void test_wheel_and_far_heap()
+{
+  timers q(16, 10); // window of 160 ticks
+  q.schedule(1, 25);
+  q.schedule(2, 5);
+  q.schedule(3, 1000); // beyond the window: far heap
+  q.schedule(4, 159);
+  assert(q.size() == 4 && q.wheel_size() == 3);
+  assert(q.deadline(3) == 1000);
+
+  assert(expire(q, 4).empty());
+  assert((expire(q, 25) == std::vector<std::size_t>{1, 2}));
+  assert(!q.contains(1) && q.contains(4));
+
+  // Same slot as `now`, not yet due: stays.
+  q.schedule(5, 29);
+  assert(expire(q, 28).empty());
+  assert((expire(q, 29) == std::vector<std::size_t>{5}));
+
+  // Jump past the far deadline in one call.
+  assert((expire(q, 5000) == std::vector<std::size_t>{3, 4}));
+  assert(q.empty());
+}
+
+static void test_reschedule_and_cancel()
+{
+  timers q(64);
+  for (std::size_t id = 0; id < 10; ++id)
+  {
+    q.schedule(id, 50);
+  }
+  // Keep-alive resets: move within the wheel, into the far heap and back.
+  q.schedule(3, 60);
+  q.schedule(4, 10000);
+  assert(q.wheel_size() == 9);
+  q.schedule(4, 40);
+  assert(q.wheel_size() == 10);
+  assert(q.cancel(7) && !q.cancel(7) && !q.cancel(99));
+
+  assert((expire(q, 45) == std::vector<std::size_t>{4}));
+  assert((expire(q, 55) == std::vector<std::size_t>{0, 1, 2, 5, 6, 8, 9}));
+
+  // A deadline in the past fires on the next call.
+  q.schedule(11, 1);
+  assert((expire(q, 56) == std::vector<std::size_t>{11}));
+  assert((expire(q, 60) == std::vector<std::size_t>{3}));
+
+  bool threw = false;
+  try
+  {
+    (void)q.deadline(3);
+  }
+  catch (const std::out_of_range &)
+  {
+    threw = true;
+  }
+  assert(threw);
+
+  q.schedule(1, 100);
+  q.schedule(2, 1 << 20);
+  q.clear();
+  assert(q.empty() && !q.contains(1));
+  assert(expire(q, 1 << 21).empty());
+}
+
+static void test_matches_reference_model()
+{
+  std::mt19937_64 rng(29);
+  timers q(256, 4);
+  std::map<std::size_t, std::uint64_t> pending;
+  std::uint64_t now = 0;
+
+  for (int step = 0; step < 200000; ++step)
+  {
+    const std::size_t id = rng() % 5000;
+    switch (rng() % 8)
+    {
+    case 0:
+      q.cancel(id);
+      pending.erase(id);
+      break;
+    case 1:
+    {
+      now += rng() % 64;
+      std::vector<std::size_t> want;
+      for (auto it = pending.begin(); it != pending.end();)
+      {
+        if (it->second <= now)
+        {
+          want.push_back(it->first);
+          it = pending.erase(it);
+        }
+        else
+        {
+          ++it;
+        }
+      }
+      assert(expire(q, now) == want);
+      break;
+    }
+    default:
+    {
+      // Mostly near deadlines, some far beyond the 1024-tick window, some late.
+      const std::uint64_t r = rng() % 100;
+      const std::uint64_t deadline = (r < 5) ? now - (now > 10 ? 10 : now) : now + ((r < 80) ? rng() % 900 : rng() % 100000);
+      q.schedule(id, deadline);
+      pending[id] = deadline;
+      break;
+    }
+    }
+    assert(q.size() == pending.size());
+  }
+}
+
+static void test_invalid_geometry()
+{
+  bool threw = false;
+  try
+  {
+    timers q(100);
+  }
+  catch (const std::invalid_argument &)
+  {
+    threw = true;
+  }
+  assert(threw);
+
+  threw = false;
+  try
+  {
+    timers q(64, 0);
+  }
+  catch (const std::invalid_argument &)
+  {
+    threw = true;
+  }
+  assert(threw);
+}
+
+static void test_npos_id_rejected()
+{
+  timers q(64);
+  q.schedule(2, 10);
+
+  const std::size_t npos = std::numeric_limits<std::size_t>::max();
+  bool threw = false;
+  try
+  {
+    q.schedule(npos, 5);
+  }
+  catch (const std::length_error &)
+  {
+    threw = true;
+  }
+  assert(threw && q.size() == 1 && !q.contains(npos));
+  assert(expire(q, 10) == std::vector<std::size_t>{2});
+}
+
+int main()
+{
+  test_wheel_and_far_heap();
+  test_reschedule_and_cancel();
+  test_matches_reference_model();
+  test_invalid_geometry();
+  test_npos_id_rejected();
+  return 0;
+}
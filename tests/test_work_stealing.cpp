@@ -0,0 +1,106 @@
+#include <heap_utils/work_stealing.hpp>
+
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <thread>
+#include <vector>
+
+static void test_local_order()
+{
+  heap_utils::work_stealing_scheduler<int, std::greater<>> s(2);
+  for (int x : {5, 1, 9, 3})
+  {
+    s.push(0, x);
+  }
+  assert(s.size() == 4);
+  assert(s.size(0) == 4);
+  assert(s.size(1) == 0);
+
+  int x = 0;
+  assert(s.try_pop(0, x) && x == 1);
+  assert(s.try_pop(0, x) && x == 3);
+  assert(s.steal_count() == 0);
+}
+
+static void test_steal_takes_best_batch()
+{
+  heap_utils::work_stealing_scheduler<int> s(2, std::less<>{}, 4);
+  for (int i = 0; i < 20; ++i)
+  {
+    s.push(0, i);
+  }
+
+  int x = 0;
+  assert(s.try_pop(1, x));
+  assert(x == 19);
+  assert(s.steal_count() == 1);
+  assert(s.size(0) == 16);
+  assert(s.size(1) == 3);
+  assert(s.try_pop(1, x) && x == 18);
+  assert(s.try_pop(1, x) && x == 17);
+  assert(s.try_pop(1, x) && x == 16);
+  assert(s.try_pop(1, x) && x == 15);
+  assert(s.steal_count() == 2);
+}
+
+static void test_single_worker_and_empty()
+{
+  heap_utils::work_stealing_scheduler<int> s(1);
+  int x = 0;
+  assert(!s.try_pop(0, x));
+  s.push(0, 7);
+  assert(s.try_pop(0, x) && x == 7);
+  assert(s.empty());
+}
+
+static void test_concurrent_task_graph()
+{
+  // Each task n > 0 spawns two tasks n - 1 on the popping worker.
+  const std::size_t workers = 4;
+  const int depth = 12;
+  heap_utils::work_stealing_scheduler<int> s(workers);
+  s.push(0, depth);
+
+  std::atomic<std::size_t> done{0};
+  const std::size_t total = (std::size_t(1) << (depth + 1)) - 1;
+
+  std::vector<std::thread> threads;
+  for (std::size_t w = 0; w < workers; ++w)
+  {
+    threads.emplace_back([&, w]
+                         {
+      int task = 0;
+      while (done.load() < total)
+      {
+        if (!s.try_pop(w, task))
+        {
+          std::this_thread::yield();
+          continue;
+        }
+        if (task > 0)
+        {
+          s.push(w, task - 1);
+          s.push(w, task - 1);
+        }
+        done.fetch_add(1);
+      } });
+  }
+  for (std::thread &t : threads)
+  {
+    t.join();
+  }
+  assert(done.load() == total);
+  assert(s.empty());
+}
+
+int main()
+{
+  test_local_order();
+  test_steal_takes_best_batch();
+  test_single_worker_and_empty();
+  test_concurrent_task_graph();
+  return 0;
+}